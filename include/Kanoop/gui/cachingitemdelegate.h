@@ -0,0 +1,203 @@
+#ifndef CACHINGITEMDELEGATE_H
+#define CACHINGITEMDELEGATE_H
+#include <QCache>
+#include <QHash>
+#include <QPixmap>
+#include <QPointer>
+#include <QStyle>
+#include <QStyledItemDelegate>
+#include <QTimer>
+#include <Kanoop/gui/libkanoopgui.h>
+
+/**
+ * @brief QStyledItemDelegate base class which caches rendered cells as pixmaps.
+ *
+ * Cells are rendered once into a QPixmap and then blitted on subsequent paints.
+ * Cache entries are keyed by the source model cell, the cell size, the relevant
+ * style state bits, the device pixel ratio and a data revision which is bumped
+ * whenever the model reports dataChanged() for the cell. Least recently used
+ * entries are evicted once the cache exceeds its cost limit.
+ *
+ * Subclasses override paintCell() instead of paint(). Intended for expensive but
+ * mostly static cells such as gauges and sparklines installed through
+ * TreeViewBase::setColumnDelegate() or TableViewBase::setColumnDelegate().
+ */
+class LIBKANOOPGUI_EXPORT CachingItemDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Construct with an optional parent.
+     * @param parent Optional QObject parent
+     */
+    explicit CachingItemDelegate(QObject* parent = nullptr);
+
+    /**
+     * @brief Paint the cell from the cache, rendering it through paintCell() on a miss.
+     * @param painter Painter to draw with
+     * @param option Style options for the cell
+     * @param index Index of the cell
+     */
+    virtual void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+
+    /**
+     * @brief Return the maximum cache size.
+     * @return Maximum cache cost in kilobytes of pixmap data
+     */
+    int maxCacheCost() const { return _cache.maxCost(); }
+
+    /**
+     * @brief Set the maximum cache size.
+     * @param kilobytes Maximum cache cost in kilobytes of pixmap data
+     */
+    void setMaxCacheCost(int kilobytes) { _cache.setMaxCost(kilobytes); }
+
+    /**
+     * @brief Return the style state bits which take part in the cache key.
+     * @return State mask
+     */
+    QStyle::State cacheStateMask() const { return _cacheStateMask; }
+
+    /**
+     * @brief Set the style state bits which take part in the cache key.
+     * @param value State mask
+     */
+    void setCacheStateMask(QStyle::State value) { _cacheStateMask = value; }
+
+    /**
+     * @brief Return the number of cache hits since the last resetStatistics().
+     * @return Hit count
+     */
+    quint64 hits() const { return _hits; }
+
+    /**
+     * @brief Return the number of cache misses since the last resetStatistics().
+     * @return Miss count
+     */
+    quint64 misses() const { return _misses; }
+
+    /**
+     * @brief Return the cache hit rate since the last resetStatistics().
+     * @return Hit rate between 0.0 and 1.0
+     */
+    double hitRate() const;
+
+    /** @brief Reset the hit and miss counters. */
+    void resetStatistics();
+
+public slots:
+    /** @brief Discard all cached cells. */
+    void invalidate();
+
+protected:
+    /**
+     * @brief Render the cell. The default implementation calls QStyledItemDelegate::paint().
+     *
+     * The painter draws into a pixmap, and option.rect is positioned at the origin.
+     * @param painter Painter to draw with
+     * @param option Style options for the cell
+     * @param index Index of the cell
+     */
+    virtual void paintCell(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const;
+
+    /**
+     * @brief Return whether the cell may be cached. Default is true.
+     * @param index Index of the cell
+     * @return true to cache the rendered cell
+     */
+    virtual bool isCacheable(const QModelIndex& index) const { Q_UNUSED(index) return true; }
+
+    /**
+     * @brief Return an application-defined revision of the data behind the cell.
+     *
+     * Override when the rendered output depends on state which does not raise dataChanged().
+     * @param index Index of the cell
+     * @return Revision number, included in the cache key
+     */
+    virtual quint64 dataRevision(const QModelIndex& index) const { Q_UNUSED(index) return 0; }
+
+private:
+    class CellKey
+    {
+    public:
+        CellKey() {}
+        CellKey(const QModelIndex& sourceIndex) :
+            model(reinterpret_cast<quintptr>(sourceIndex.model())), internalId(sourceIndex.internalId()),
+            row(sourceIndex.row()), column(sourceIndex.column()) {}
+
+        bool operator==(const CellKey& other) const
+        {
+            return model == other.model && internalId == other.internalId &&
+                   row == other.row && column == other.column;
+        }
+
+        friend size_t qHash(const CellKey& key, size_t seed = 0)
+        {
+            return qHashMulti(seed, key.model, key.internalId, key.row, key.column);
+        }
+
+        quintptr model = 0;
+        quintptr internalId = 0;
+        int row = -1;
+        int column = -1;
+    };
+
+    class CacheKey
+    {
+    public:
+        bool operator==(const CacheKey& other) const
+        {
+            return cell == other.cell && width == other.width && height == other.height &&
+                   state == other.state && devicePixelRatio == other.devicePixelRatio &&
+                   epoch == other.epoch && cellRevision == other.cellRevision &&
+                   userRevision == other.userRevision;
+        }
+
+        friend size_t qHash(const CacheKey& key, size_t seed = 0)
+        {
+            return qHashMulti(seed, qHash(key.cell), key.width, key.height, key.state,
+                              key.devicePixelRatio, key.epoch, key.cellRevision, key.userRevision);
+        }
+
+        CellKey cell;
+        int width = 0;
+        int height = 0;
+        int state = 0;
+        qreal devicePixelRatio = 1;
+        quint32 epoch = 0;
+        quint32 cellRevision = 0;
+        quint64 userRevision = 0;
+    };
+
+    void watchModel(const QAbstractItemModel* model) const;
+
+    mutable QCache<CacheKey, QPixmap> _cache;
+    mutable QHash<CellKey, quint32> _cellRevisions;
+    mutable quint32 _epoch = 0;
+    mutable QPointer<const QAbstractItemModel> _watchedModel;
+    QStyle::State _cacheStateMask = QStyle::State_Selected | QStyle::State_MouseOver |
+                                    QStyle::State_HasFocus | QStyle::State_Enabled | QStyle::State_Active;
+
+    mutable quint64 _hits = 0;
+    mutable quint64 _misses = 0;
+    mutable QTimer _statisticsTimer;
+
+    static const int DefaultMaxCacheCost = 16 * 1024;
+    static const int DefaultStatisticsInterval = 1000;
+    static const int MaxTrackedCellChanges = 1024;
+
+signals:
+    /**
+     * @brief Emitted at most once per second while cells are being painted.
+     * @param hitRate Hit rate between 0.0 and 1.0
+     * @param hits Number of cache hits
+     * @param misses Number of cache misses
+     */
+    void cacheStatistics(double hitRate, quint64 hits, quint64 misses);
+
+private slots:
+    void onModelDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+    void onStatisticsTimer();
+};
+
+#endif // CACHINGITEMDELEGATE_H
@@ -12,7 +12,9 @@
 #define DIALOG_H
 #include <QDialog>
 #include <QDialogButtonBox>
+#include <QSharedPointer>
 #include <QStatusBar>
+#include <QTimer>
 #include <QUuid>
 #include <Kanoop/utility/loggingbaseclass.h>
 #include <Kanoop/entitymetadata.h>
@@ -21,6 +23,8 @@
 
 #define COMPARE(a, b)       compare(a, b)
 
+class LogEntryQueue;
+
 /**
  * @brief QDialog subclass providing logging, validation, persistence, and button-box management.
  *
@@ -154,10 +158,53 @@ protected:
 
     /**
      * @brief Enable or disable the log consumer hook for this dialog.
+     *
+     * Entries are queued from the logging thread into a bounded queue and
+     * delivered to loggedItems() in batches on the GUI thread, every
+     * logHookInterval() milliseconds.
      * @param enabled true to enable
      */
     void setLogHookEnabled(bool enabled);
 
+    /**
+     * @brief Restrict the log hook to the given levels.
+     * Entries at other levels are discarded before they are queued.
+     * @param levels Levels to deliver (empty = all levels)
+     */
+    void setLogHookLevels(const QList<Log::LogLevel>& levels);
+
+    /**
+     * @brief Return the maximum number of entries the log hook queues between deliveries.
+     * @return Queue capacity
+     */
+    int logHookCapacity() const { return _logHookCapacity; }
+
+    /**
+     * @brief Set the maximum number of entries the log hook queues between deliveries.
+     * Entries arriving while the queue is full are dropped and counted.
+     * Takes effect the next time the hook is enabled.
+     * @param value Queue capacity (rounded up to a power of two)
+     */
+    void setLogHookCapacity(int value) { _logHookCapacity = value; }
+
+    /**
+     * @brief Return the interval at which queued log entries are delivered.
+     * @return Interval in milliseconds
+     */
+    int logHookInterval() const { return _logDrainTimer.interval(); }
+
+    /**
+     * @brief Set the interval at which queued log entries are delivered.
+     * @param ms Interval in milliseconds
+     */
+    void setLogHookInterval(int ms) { _logDrainTimer.setInterval(ms); }
+
+    /**
+     * @brief Return the number of log entries dropped because the queue was full.
+     * @return Total dropped since the hook was last enabled
+     */
+    quint64 droppedLogEntryCount() const { return _droppedLogEntries; }
+
     /** @brief Connect all child input widget signals to the validation slots. */
     void connectValidationSignals();
 
@@ -214,6 +261,19 @@ protected:
      */
     virtual void loggedItem(const Log::LogEntry& entry) { Q_UNUSED(entry) }
 
+    /**
+     * @brief Called with each batch of log entries drained from the log hook queue.
+     * The default implementation calls loggedItem() for every entry.
+     * @param entries Entries in the order they were logged
+     */
+    virtual void loggedItems(const QList<Log::LogEntry>& entries);
+
+    /**
+     * @brief Called when entries were dropped because the log hook queue was full (no-op by default).
+     * @param count Number of entries dropped since the previous delivery
+     */
+    virtual void logEntriesDropped(int count) { Q_UNUSED(count) }
+
     /** @brief Return true if a != b (used with COMPARE macro). */
     bool compare(const QString& a, const QString& b) { return a != b; }
     /** @brief Return true if a != b (used with COMPARE macro). */
@@ -247,6 +307,8 @@ protected:
     virtual void resizeEvent(QResizeEvent *event) override;
     /** @brief Restore geometry and complete form load on first show. */
     virtual void showEvent(QShowEvent *event) override;
+    /** @brief Commit buffered settings when the dialog is closed or dismissed. */
+    virtual void hideEvent(QHideEvent *event) override;
 
 private:
     /** @brief Connect QLineEdit signals. */
@@ -298,6 +360,14 @@ private:
     bool _restoreToParentScreen = true;
 
     LogConsumer* _logConsumer  = nullptr;
+    QSharedPointer<LogEntryQueue> _logQueue;
+    QTimer _logDrainTimer;
+    int _logHookCapacity = DefaultLogHookCapacity;
+    QList<Log::LogLevel> _logHookLevels;
+    quint64 _droppedLogEntries = 0;
+
+    static const int DefaultLogHookCapacity = 8192;
+    static const int DefaultLogHookInterval = 50;
 
 signals:
     /** @brief Emitted after an item is added via this dialog. */
@@ -322,8 +392,8 @@ protected slots:
     virtual void voidChanged();
 
 private slots:
-    /** @brief Forward logged entries to loggedItem(). */
-    void onLoggedItem(const Log::LogEntry& entry);
+    /** @brief Deliver queued log entries to loggedItems(). */
+    void onLogDrainTimer();
     /** @brief Persist splitter state when moved. */
     void onSplitterMoved();
     /** @brief Handle OK button click. */
@@ -19,6 +19,9 @@ public:
      */
     EllipseGraphicsItem(int type, QGraphicsItem* parent = nullptr);
 
+    /** @brief Remove the item from its GraphicsScene's type registry. */
+    virtual ~EllipseGraphicsItem();
+
     /**
      * @brief Return the application-defined type integer.
      * @return Item type value
@@ -37,6 +40,10 @@ public:
      */
     void setColor(const QColor& color);
 
+protected:
+    /** @brief Keep the GraphicsScene type registry current when the item changes scene. */
+    virtual QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
+
 private:
     int _type;
 };
@@ -12,6 +12,17 @@
  * GraphicsScene adds findChildItems<T>() and findFirstChildItem<T>() template
  * helpers that search all items in the scene and return only those that dynamic_cast
  * to the requested pointer type.
+ *
+ * It also keeps a registry of items bucketed by QGraphicsItem::type(). The typed
+ * items in this library (LineGraphicsItem, EllipseGraphicsItem, RectangleGraphicsItem,
+ * PixmapGraphicsItem) register themselves when they enter or leave the scene; other
+ * items can be added with registerItem(). Lookups by type integer touch only the
+ * matching items instead of every item in the scene.
+ *
+ * The registry drives an optional level-of-detail mode: each item type can be given
+ * a minimum view scale below which its items are hidden and, optionally, replaced by
+ * a single aggregated proxy item. Connect GraphicsView::scaleChanged() to
+ * setLevelOfDetailScale() to drive it from the view's zoom.
  */
 class LIBKANOOPGUI_EXPORT GraphicsScene : public QGraphicsScene,
                                           public LoggingBaseClass
@@ -24,6 +35,9 @@ public:
      */
     explicit GraphicsScene(QObject *parent = nullptr);
 
+    /** @brief Delete all items while the registry is still alive. */
+    virtual ~GraphicsScene();
+
     /**
      * @brief Return all scene items that dynamic_cast to type T.
      * @tparam T Pointer type to search for (must derive from QGraphicsItem)
@@ -61,6 +75,143 @@ public:
         return result;
     }
 
+    /**
+     * @brief Return all registered items of an item type.
+     * Items are returned in no particular order.
+     * @param type Value returned by QGraphicsItem::type()
+     * @return Registered items of that type
+     */
+    QList<QGraphicsItem*> itemsOfType(int type) const { return _itemsByType.value(type).values(); }
+
+    /**
+     * @brief Return the number of registered items of an item type.
+     * @param type Value returned by QGraphicsItem::type()
+     * @return Registered item count
+     */
+    int itemCountOfType(int type) const { return _itemsByType.value(type).count(); }
+
+    /**
+     * @brief Return registered items of an item type cast to T.
+     * @tparam T Pointer type to cast to (must derive from QGraphicsItem)
+     * @param type Value returned by QGraphicsItem::type()
+     * @return Matching items cast to T
+     */
+    template <typename T>
+    QList<T> findChildItems(int type) const
+    {
+        QList<T> result;
+        auto bucket = _itemsByType.constFind(type);
+        if(bucket != _itemsByType.constEnd()) {
+            result.reserve(bucket->count());
+            for(QGraphicsItem* item : *bucket) {
+                T candidate = dynamic_cast<T>(item);
+                if(candidate != nullptr) {
+                    result.append(candidate);
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Return a registered item of an item type cast to T.
+     * @tparam T Pointer type to cast to (must derive from QGraphicsItem)
+     * @param type Value returned by QGraphicsItem::type()
+     * @return A matching item cast to T, or nullptr if none is registered
+     */
+    template <typename T>
+    T findFirstChildItem(int type) const
+    {
+        T result = nullptr;
+        auto bucket = _itemsByType.constFind(type);
+        if(bucket != _itemsByType.constEnd()) {
+            for(QGraphicsItem* item : *bucket) {
+                result = dynamic_cast<T>(item);
+                if(result != nullptr) {
+                    break;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Add an item to the type registry.
+     * Call for custom item classes that do not register themselves, and call
+     * unregisterItem() before such an item leaves the scene or is deleted.
+     * @param item Item to register under its type()
+     */
+    void registerItem(QGraphicsItem* item);
+
+    /**
+     * @brief Remove an item from the type registry.
+     * @param item Item to unregister
+     */
+    void unregisterItem(QGraphicsItem* item);
+
+    /**
+     * @brief Move an item's registration between scenes.
+     * Called from the typed items' itemChange() on QGraphicsItem::ItemSceneChange
+     * and from their destructors.
+     * @param item Item changing scene
+     * @param oldScene Scene the item is leaving (may be nullptr)
+     * @param newScene Scene the item is entering (may be nullptr)
+     */
+    static void updateRegistration(QGraphicsItem* item, QGraphicsScene* oldScene, QGraphicsScene* newScene);
+
+    /**
+     * @brief Hide items of a type while the view scale is below a threshold.
+     * Only items hidden by the rule are shown again; items the application hid itself stay hidden.
+     * @param type Value returned by QGraphicsItem::type()
+     * @param minimumScale Lowest scale at which the items are drawn
+     * @param proxy Optional item shown in their place below the threshold; the scene takes ownership.
+     * Passing the proxy of the existing rule again keeps it.
+     */
+    void setLevelOfDetail(int type, double minimumScale, QGraphicsItem* proxy = nullptr);
+
+    /**
+     * @brief Remove the level-of-detail rule for a type and show its items again.
+     * @param type Value returned by QGraphicsItem::type()
+     */
+    void clearLevelOfDetail(int type);
+
+    /**
+     * @brief Return the scale last passed to setLevelOfDetailScale().
+     * @return Current level-of-detail scale
+     */
+    double levelOfDetailScale() const { return _levelOfDetailScale; }
+
+    /**
+     * @brief Return whether items of a type are currently hidden by level of detail.
+     * @param type Value returned by QGraphicsItem::type()
+     * @return true if the type is culled at the current scale
+     */
+    bool isCulled(int type) const { return _levelsOfDetail.contains(type) && _levelsOfDetail.value(type).culled; }
+
+public slots:
+    /**
+     * @brief Apply the level-of-detail rules for a view scale.
+     * Items only change visibility when a threshold is crossed.
+     * @param scale View scale, e.g. from GraphicsView::currentScale()
+     */
+    void setLevelOfDetailScale(double scale);
+
+private:
+    class LevelOfDetail
+    {
+    public:
+        double minimumScale = 0;
+        QGraphicsItem* proxy = nullptr;
+        bool culled = false;
+        QSet<QGraphicsItem*> hidden;
+    };
+
+    void applyLevelOfDetail(int type, LevelOfDetail& lod, bool culled);
+
+    QHash<int, QSet<QGraphicsItem*>> _itemsByType;
+    QHash<int, LevelOfDetail> _levelsOfDetail;
+    double _levelOfDetailScale = 1.0;
+
 signals:
 
 };
@@ -30,6 +30,9 @@ public:
      */
     LineGraphicsItem(const Line& line, int type, QGraphicsItem* parent = nullptr);
 
+    /** @brief Remove the item from its GraphicsScene's type registry. */
+    virtual ~LineGraphicsItem();
+
     /**
      * @brief Return the application-defined type integer.
      * @return Item type value
@@ -66,6 +69,10 @@ public:
      */
     void setLength(double length);
 
+protected:
+    /** @brief Keep the GraphicsScene type registry current when the item changes scene. */
+    virtual QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
+
 private:
     int _type;
 };
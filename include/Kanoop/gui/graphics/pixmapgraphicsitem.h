@@ -20,6 +20,9 @@ public:
      */
     explicit PixmapGraphicsItem(int type, QGraphicsItem* parent = nullptr);
 
+    /** @brief Remove the item from its GraphicsScene's type registry. */
+    virtual ~PixmapGraphicsItem();
+
     /**
      * @brief Return the application-defined type integer.
      * @return Item type value
@@ -27,7 +30,7 @@ public:
     virtual int type() const override { return _type; }
 
 protected:
-    /** @brief Handle graphics item change notifications. */
+    /** @brief Keep the GraphicsScene type registry current when the item changes scene. */
     virtual QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
 
 private:
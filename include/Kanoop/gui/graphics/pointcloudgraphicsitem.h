@@ -0,0 +1,257 @@
+#ifndef POINTCLOUDGRAPHICSITEM_H
+#define POINTCLOUDGRAPHICSITEM_H
+#include <QGraphicsItem>
+#include <QHash>
+#include <QImage>
+
+#include <Kanoop/gui/libkanoopgui.h>
+
+/**
+ * @brief Graphics item that draws a large set of points in a single pass.
+ *
+ * PointCloudGraphicsItem replaces one graphics item per point (each with its own
+ * pen, bounding rect and scene index entry) for data such as lidar scans. Points
+ * are stored as interleaved x/y floats in one contiguous array, with an optional
+ * parallel array of per-point colors; points without a color use color().
+ *
+ * In DrawPoints mode points are passed to QPainter::drawPoints() in chunks of
+ * equal color. In CachedImage mode the points are rasterized directly into a
+ * QImage at the current view scale, which is reused while panning and rebuilt
+ * when the scale or the data changes. When the whole cloud would make too large
+ * an image, only the visible area is rasterized and panning rebuilds it.
+ *
+ * updatePoints() replaces a range of points and repaints only the area they
+ * cover; a cached image is cleared and redrawn in that area only. Hit testing
+ * goes through a uniform grid index that is built lazily after setPoints().
+ * Points moved by updatePoints() are re-filed in the cells they move to, and
+ * the grid is rebuilt only once a large share of the points has moved.
+ */
+class LIBKANOOPGUI_EXPORT PointCloudGraphicsItem : public QGraphicsItem
+{
+public:
+    /**
+     * @brief How the points are painted.
+     */
+    enum RenderMode
+    {
+        DrawPoints,     ///< QPainter::drawPoints() with a cosmetic pen
+        CachedImage,    ///< Rasterize into a cached QImage at the current transform
+    };
+
+    /**
+     * @brief Construct with a type integer and optional parent item.
+     * @param type Application-defined graphics item type
+     * @param parent Optional parent QGraphicsItem
+     */
+    explicit PointCloudGraphicsItem(int type, QGraphicsItem* parent = nullptr);
+
+    /** @brief Remove the item from its GraphicsScene's type registry. */
+    virtual ~PointCloudGraphicsItem();
+
+    /**
+     * @brief Return the application-defined type integer.
+     * @return Item type value
+     */
+    virtual int type() const override { return _type; }
+
+    /**
+     * @brief Replace all points.
+     * @param xy Interleaved x/y coordinates in item units (2 * count floats)
+     * @param count Number of points
+     * @param colors Optional per-point colors (count entries), or nullptr to use color()
+     */
+    void setPoints(const float* xy, int count, const QRgb* colors = nullptr);
+
+    /**
+     * @brief Replace all points.
+     * @param points Point positions in item units
+     * @param colors Optional per-point colors (empty, or one per point)
+     */
+    void setPoints(const QList<QPointF>& points, const QList<QRgb>& colors = QList<QRgb>());
+
+    /**
+     * @brief Replace a range of existing points and repaint only the area they cover.
+     * @param first Index of the first point to replace
+     * @param xy Interleaved x/y coordinates (2 * count floats)
+     * @param count Number of points to replace; the range is clipped to pointCount()
+     * @param colors Optional per-point colors for the range, or nullptr to leave colors unchanged
+     */
+    void updatePoints(int first, const float* xy, int count, const QRgb* colors = nullptr);
+
+    /** @brief Remove all points. */
+    void clear();
+
+    /**
+     * @brief Return the number of points.
+     * @return Point count
+     */
+    int pointCount() const { return int(_coordinates.count() / 2); }
+
+    /**
+     * @brief Return a point position.
+     * @param index Point index
+     * @return Position in item coordinates
+     */
+    QPointF point(int index) const { return QPointF(_coordinates.at(index * 2), _coordinates.at(index * 2 + 1)); }
+
+    /**
+     * @brief Return the color of a point.
+     * @param index Point index
+     * @return Per-point color, or color() if none was given
+     */
+    QRgb pointColor(int index) const { return _colors.isEmpty() ? _color.rgba() : _colors.at(index); }
+
+    /**
+     * @brief Return the color used for points without their own color.
+     * @return Default point color
+     */
+    QColor color() const { return _color; }
+
+    /**
+     * @brief Set the color used for points without their own color.
+     * @param color Default point color
+     */
+    void setColor(const QColor& color);
+
+    /**
+     * @brief Return the drawn point size.
+     * @return Size in device pixels
+     */
+    int pointSize() const { return _pointSize; }
+
+    /**
+     * @brief Set the drawn point size. Points keep this size at every zoom level.
+     * @param pixels Size in device pixels
+     */
+    void setPointSize(int pixels);
+
+    /**
+     * @brief Return the render mode.
+     * @return Current render mode
+     */
+    RenderMode renderMode() const { return _renderMode; }
+
+    /**
+     * @brief Set the render mode.
+     * @param mode DrawPoints or CachedImage
+     */
+    void setRenderMode(RenderMode mode);
+
+    /**
+     * @brief Return the index of the point nearest to a position.
+     * @param pos Position in item coordinates
+     * @param radius Search radius in item units
+     * @return Index of the nearest point within @p radius, or -1 if there is none
+     */
+    int pointAt(const QPointF& pos, double radius) const;
+
+    /**
+     * @brief Return the indexes of all points inside a rectangle.
+     * @param rect Rectangle in item coordinates
+     * @return Matching point indexes
+     */
+    QList<int> pointsIn(const QRectF& rect) const;
+
+    /**
+     * @brief Return the radius used by contains() for mouse hit testing.
+     * @return Pick radius in item units
+     */
+    double pickRadius() const { return _pickRadius; }
+
+    /**
+     * @brief Set the radius used by contains() for mouse hit testing.
+     * @param radius Pick radius in item units
+     */
+    void setPickRadius(double radius);
+
+    /**
+     * @brief Return the bounding rect of all points, padded by pickRadius() or
+     * pointSize(), whichever is larger, both taken in item units.
+     *
+     * The padding does not follow the view scale, so the rect only changes through
+     * prepareGeometryChange(). In views scaled below 1:1 the outermost points may be
+     * drawn up to pointSize() pixels past it; raise pickRadius() to cover that.
+     * @return Bounding rect in item coordinates
+     */
+    virtual QRectF boundingRect() const override;
+
+    /**
+     * @brief Return true if a point lies within pickRadius() of the position.
+     * @param point Position in item coordinates
+     * @return true if a point is hit
+     */
+    virtual bool contains(const QPointF& point) const override;
+
+    /** @brief Paint the points visible in the exposed area. */
+    virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
+protected:
+    /** @brief Keep the GraphicsScene type registry current when the item changes scene. */
+    virtual QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
+
+private:
+    void paintPoints(QPainter* painter, const QRectF& exposedRect);
+    void paintCachedImage(QPainter* painter);
+    void rasterize(const QRect& clip, const QList<int>* indexes);
+    void updateImage(const QRectF& dirty);
+    double pointPadding() const;
+    void recalculateBounds();
+    void invalidate();
+    void buildGrid() const;
+    void moveGridPoints(int first, int count);
+    int cellIndex(int column, int row) const { return row * _gridColumns + column; }
+    int cellAt(float x, float y) const;
+    void cellRange(const QRectF& rect, int& firstColumn, int& firstRow, int& lastColumn, int& lastRow) const;
+
+    /**
+     * Visit the points currently in a grid cell. A point filed by buildGrid() is
+     * stored as its cell index in _pointCells; a point moved since then is stored
+     * as -(cell + 1) and listed in _movedPoints, leaving a stale entry behind.
+     */
+    template<typename T>
+    void visitCell(int cell, T visitor) const
+    {
+        for(int i = _cellStart.at(cell);i < _cellStart.at(cell + 1);i++) {
+            int index = _cellPoints.at(i);
+            if(_pointCells.at(index) == cell) {
+                visitor(index);
+            }
+        }
+        auto it = _movedPoints.constFind(cell);
+        if(it != _movedPoints.constEnd()) {
+            for(int index : *it) {
+                if(_pointCells.at(index) == -(cell + 1)) {
+                    visitor(index);
+                }
+            }
+        }
+    }
+
+    int _type;
+
+    QList<float> _coordinates;
+    QList<QRgb> _colors;
+    QRectF _bounds;
+    QColor _color;
+    int _pointSize = 2;
+    double _pickRadius = 1.0;
+    RenderMode _renderMode = DrawPoints;
+
+    QImage _image;
+    QTransform _imageTransform;
+    QRect _imageRect;
+    bool _imageValid = false;
+
+    mutable bool _gridValid = false;
+    mutable int _gridColumns = 0;
+    mutable int _gridRows = 0;
+    mutable QSizeF _cellSize;
+    mutable QRectF _gridBounds;
+    mutable QList<int> _cellStart;
+    mutable QList<int> _cellPoints;
+    mutable QList<int> _pointCells;
+    mutable QHash<int, QList<int>> _movedPoints;
+    mutable int _movedCount = 0;
+};
+
+#endif // POINTCLOUDGRAPHICSITEM_H
@@ -32,6 +32,9 @@ public:
      */
     explicit RectangleGraphicsItem(const Rectangle& rect, int type, QGraphicsItem* parent = nullptr);
 
+    /** @brief Remove the item from its GraphicsScene's type registry. */
+    virtual ~RectangleGraphicsItem();
+
     /**
      * @brief Return the application-defined type integer.
      * @return Item type value
@@ -51,7 +54,7 @@ public:
     Point sceneCenterPoint() const;
 
 protected:
-    /** @brief Handle graphics item change notifications. */
+    /** @brief Keep the GraphicsScene type registry current when the item changes scene. */
     virtual QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
 
 private:
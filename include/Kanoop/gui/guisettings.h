@@ -10,6 +10,8 @@
 ******************************************************************************************/
 #ifndef GUISETTINGS_H
 #define GUISETTINGS_H
+#include <QHash>
+#include <QTimer>
 #include <QWidget>
 #include <Kanoop/gui/libkanoopgui.h>
 #include <Kanoop/utility/appsettings.h>
@@ -28,6 +30,14 @@ class TreeViewBase;
  *
  * A process-wide singleton can be registered with setGlobalInstance() and retrieved
  * with globalInstance().
+ *
+ * Geometry, splitter, header and tree view states are written to an in-memory buffer
+ * first, where repeated writes of the same key coalesce. The buffer is committed to
+ * the backing QSettings store when the debounce timer expires, when a managed window
+ * closes, when the application is about to quit, or when flush() is called.
+ * Calling prefetch() at startup loads all GUI keys into memory in a single pass,
+ * converted to the types the accessors return. Keys built from an object name are
+ * cached, so repeated reads for the same widget do not rebuild them.
  */
 class LIBKANOOPGUI_EXPORT GuiSettings : public AppSettings
 {
@@ -37,13 +47,16 @@ public:
     /** @brief Construct a GuiSettings object backed by the default QSettings store. */
     GuiSettings();
 
+    /** @brief Destructor — commits any pending writes. */
+    virtual ~GuiSettings();
+
     // Widget settings
     /**
      * @brief Persist the last position of a widget.
      * @param widget Widget whose position to save (key is based on objectName)
      * @param pos Position to save
      */
-    void setLastWindowPosition(const QWidget* widget, const QPoint& pos) { _settings.setValue(makeKey(KEY_LAST_WIDGET_POS, widget->objectName()), pos); }
+    void setLastWindowPosition(const QWidget* widget, const QPoint& pos) { setBufferedValue(objectKey(KEY_LAST_WIDGET_POS, widget->objectName()), pos); }
 
     /**
      * @brief Retrieve the last saved position of a widget.
@@ -58,7 +71,7 @@ public:
      * @param widget Widget whose size to save
      * @param size Size to save
      */
-    void setLastWindowSize(const QWidget* widget, const QSize& size) { _settings.setValue(makeKey(KEY_LAST_WIDGET_SIZE, widget->objectName()), size); }
+    void setLastWindowSize(const QWidget* widget, const QSize& size) { setBufferedValue(objectKey(KEY_LAST_WIDGET_SIZE, widget->objectName()), size); }
 
     /**
      * @brief Retrieve the last saved size of a widget.
@@ -68,6 +81,33 @@ public:
      */
     QSize getLastWindowSize(const QWidget* widget, const QSize& defaultSize = QSize());
 
+    /**
+     * @brief Record the latest position of a window, to be committed lazily.
+     *
+     * Intended to be called from moveEvent(). Only the latest value per objectName is kept
+     * and it is written on the next flush. While the window is maximized or full screen,
+     * only the maximized flag is recorded so that the normal geometry is preserved.
+     * @param widget Window whose position changed
+     * @param pos New position
+     */
+    void recordWindowPosition(const QWidget* widget, const QPoint& pos);
+
+    /**
+     * @brief Record the latest size of a window, to be committed lazily.
+     *
+     * Intended to be called from resizeEvent(). See recordWindowPosition().
+     * @param widget Window whose size changed
+     * @param size New size
+     */
+    void recordWindowSize(const QWidget* widget, const QSize& size);
+
+    /**
+     * @brief Return whether a window was maximized when its geometry was last recorded.
+     * @param widget Window to look up
+     * @return true if the window was maximized or full screen
+     */
+    bool getLastWindowMaximized(const QWidget* widget) const;
+
     /**
      * @brief Return whether any geometry has been saved for a widget.
      * @param widget Widget to check
@@ -122,20 +162,74 @@ public:
     /**
      * @brief Restore the expansion/selection state of a TreeViewBase.
      * @param treeView Tree view to restore
+     * @param incremental Apply the state as the model is populated rather than immediately
      */
-    void restoreTreeViewState(TreeViewBase* treeView);
+    void restoreTreeViewState(TreeViewBase* treeView, bool incremental = false);
 
     /**
      * @brief Return the persisted font size.
      * @return Font point size, or 0 if not set
      */
-    int fontSize() const { return _settings.value(makeStandardKey(KEY_FONT_SIZE)).toInt(); }
+    int fontSize() const { return _snapshotLoaded ? _fontSize : bufferedValue(fontSizeKey()).toInt(); }
 
     /**
      * @brief Persist the font size.
      * @param value Font point size
      */
-    void setFontSize(int value) { _settings.setValue(makeStandardKey(KEY_FONT_SIZE), value); }
+    void setFontSize(int value) { _fontSize = value; setBufferedValue(fontSizeKey(), value); }
+
+    /**
+     * @brief Load all GUI-related keys into an in-memory snapshot.
+     *
+     * Call once at startup. Afterwards reads are served from the snapshot instead
+     * of the backing QSettings store; writes update the snapshot when they are flushed.
+     */
+    void prefetch();
+
+    /**
+     * @brief Return whether prefetch() has loaded the in-memory snapshot.
+     * @return true if reads are served from the snapshot
+     */
+    bool isPrefetched() const { return _snapshotLoaded; }
+
+    /**
+     * @brief Return the debounce interval after which buffered writes are committed.
+     * @return Interval in milliseconds
+     */
+    int flushInterval() const { return _flushTimer.interval(); }
+
+    /**
+     * @brief Set the debounce interval after which buffered writes are committed.
+     * @param msecs Interval in milliseconds
+     */
+    void setFlushInterval(int msecs) { _flushTimer.setInterval(msecs); }
+
+    /**
+     * @brief Return the number of buffered writes not yet committed.
+     * @return Number of dirty keys
+     */
+    int pendingWriteCount() const { return _pendingWrites.count() + _pendingGeometry.count(); }
+
+    /**
+     * @brief Return the number of buffered write requests since the last resetWriteStatistics().
+     * @return Number of write requests
+     */
+    quint64 writeRequestCount() const { return _writeRequestCount; }
+
+    /**
+     * @brief Return the number of values written to the backing store since the last resetWriteStatistics().
+     * @return Number of QSettings writes
+     */
+    quint64 writeCount() const { return _writeCount; }
+
+    /**
+     * @brief Return the number of flushes which wrote at least one value since the last resetWriteStatistics().
+     * @return Number of flushes
+     */
+    quint64 flushCount() const { return _flushCount; }
+
+    /** @brief Reset the write instrumentation counters. */
+    void resetWriteStatistics();
 
     /**
      * @brief Return the process-wide GuiSettings singleton.
@@ -143,10 +237,36 @@ public:
      */
     static GuiSettings* globalInstance() { return static_cast<GuiSettings*>(AppSettings::globalInstance()); }
 
+public slots:
+    /** @brief Commit all buffered writes to the backing store. */
+    void flush();
+
 protected:
     /** @brief Override to ensure sane default values on first run. */
     virtual void ensureValidDefaults() override;
 
+    /**
+     * @brief Buffer a write, to be committed on the next flush.
+     * @param key Settings key
+     * @param value Value to write
+     */
+    void setBufferedValue(const QString& key, const QVariant& value);
+
+    /**
+     * @brief Read a value, preferring a buffered write over the backing store.
+     * @param key Settings key
+     * @param defaultValue Value returned if the key is not present
+     * @return Stored value
+     */
+    QVariant bufferedValue(const QString& key, const QVariant& defaultValue = QVariant()) const;
+
+    /**
+     * @brief Return whether a key is present in the buffer or the backing store.
+     * @param key Settings key
+     * @return true if the key is present
+     */
+    bool bufferedContains(const QString& key) const;
+
     /** @brief Settings key for the saved font size. */
     static const QString KEY_FONT_SIZE;
     /** @brief Settings key for the horizontal header state. */
@@ -157,6 +277,8 @@ protected:
     static const QString KEY_LAST_WIDGET_POS;
     /** @brief Settings key for the last widget size. */
     static const QString KEY_LAST_WIDGET_SIZE;
+    /** @brief Settings key for the last widget maximized state. */
+    static const QString KEY_LAST_WIDGET_MAXIMIZED;
     /** @brief Settings key for the horizontal model header state. */
     static const QString KEY_MODEL_HEADER_STATE_HORIZ;
     /** @brief Settings key for the vertical model header state. */
@@ -167,6 +289,50 @@ protected:
     static const QString KEY_SPLITTER_STATE_VERT;
     /** @brief Settings key for the tree view expansion state. */
     static const QString KEY_TREEVIEW_STATE;
+
+private:
+    class WindowGeometry
+    {
+    public:
+        QPoint pos;
+        QSize size;
+        bool hasPos = false;
+        bool hasSize = false;
+        bool maximized = false;
+    };
+
+    WindowGeometry& pendingGeometry(const QWidget* widget);
+    void commitPendingGeometry();
+    void installQuitHook();
+    QString objectKey(const QString& keyName, const QString& objectName) const;
+    QString fontSizeKey() const;
+    static QString guiKeyName(const QString& key);
+    static QVariant typedValue(const QString& keyName, const QVariant& value);
+    static bool isWindowMaximized(const QWidget* widget);
+
+    QHash<QString, QVariant> _pendingWrites;
+    QHash<QString, WindowGeometry> _pendingGeometry;
+    QHash<QString, QVariant> _snapshot;
+    bool _snapshotLoaded = false;
+    int _fontSize = 0;
+    mutable QString _fontSizeKey;
+    mutable QHash<QString, QHash<QString, QString>> _objectKeys;
+    QTimer _flushTimer;
+    bool _quitHookInstalled = false;
+    bool _restoringHeaderState = false;
+
+    quint64 _writeRequestCount = 0;
+    quint64 _writeCount = 0;
+    quint64 _flushCount = 0;
+
+    static const int DefaultFlushInterval = 1000;
+
+signals:
+    /**
+     * @brief Emitted after buffered writes have been committed.
+     * @param count Number of values written
+     */
+    void flushed(int count);
 };
 
 #endif // GUISETTINGS_H
@@ -1,5 +1,6 @@
 #ifndef HEADERSTATE_H
 #define HEADERSTATE_H
+#include <QHash>
 #include <Kanoop/serialization/iserializabletojson.h>
 #include <Kanoop/serialization/ideserializablefromjson.h>
 #include <Kanoop/serialization/serializablejsonlist.h>
@@ -9,7 +10,9 @@
  * @brief Serializable snapshot of a QHeaderView's section sizes and visibility.
  *
  * HeaderState captures per-section metadata (index, label, pixel width, and visibility)
- * so that a header view layout can be saved to JSON and restored later.
+ * so that a header view layout can be saved and restored later. States are normally
+ * stored in a compact binary form; the JSON form remains readable for migration.
+ * Sections can be looked up by index or by label text in constant time.
  */
 class LIBKANOOPGUI_EXPORT HeaderState : public ISerializableToJson,
                                         public IDeserializableFromJson
@@ -30,6 +33,33 @@ public:
      */
     virtual void deserializeFromJson(const QByteArray &json) override;
 
+    /**
+     * @brief Serialize this header state to the compact binary format.
+     * @return Binary representation
+     */
+    QByteArray serializeToBinary() const;
+
+    /**
+     * @brief Deserialize a header state from the compact binary format.
+     * @param data Binary representation
+     * @return true if the data was valid
+     */
+    bool deserializeFromBinary(const QByteArray& data);
+
+    /**
+     * @brief Deserialize from either the binary or the legacy JSON format.
+     * @param data Binary or JSON representation
+     * @return true if the data was valid
+     */
+    bool deserialize(const QByteArray& data);
+
+    /**
+     * @brief Return whether the data is in the binary format.
+     * @param data Serialized header state
+     * @return true if the data starts with the binary format signature
+     */
+    static bool isBinary(const QByteArray& data);
+
     /**
      * @brief Describes the saved state of a single header section.
      */
@@ -132,10 +162,34 @@ public:
      * @param section Logical section index
      * @return Matching SectionState, or an invalid one if not found
      */
-    SectionState getSection(int section) { return _sections.findForSection(section); }
+    SectionState getSection(int section) const;
+
+    /**
+     * @brief Return the saved state for the section with the given label.
+     * @param text Header label text
+     * @return First matching SectionState, or an invalid one if not found
+     */
+    SectionState getSection(const QString& text) const;
+
+    /**
+     * @brief Return the number of recorded sections.
+     * @return Section count
+     */
+    int sectionCount() const { return _sections.count(); }
+
+    /**
+     * @brief Return all recorded sections.
+     * @return List of section states
+     */
+    SectionState::List sections() const { return _sections; }
 
 private:
+    void rebuildIndex();
+    void indexSection(int index);
+
     SectionState::List _sections;
+    QHash<int, int> _indexBySection;
+    QHash<QString, int> _indexByText;
 };
 
 #endif // HEADERSTATE_H
@@ -4,6 +4,7 @@
 
 #include <Kanoop/utility/loggingbaseclass.h>
 #include <Kanoop/gui/libkanoopgui.h>
+#include <Kanoop/gui/selecteditemscache.h>
 
 class QSortFilterProxyModel;
 class AbstractItemModel;
@@ -64,9 +65,43 @@ public:
      */
     QSortFilterProxyModel* proxyModel() const { return _proxyModel; }
 
+    /**
+     * @brief Return the selected items which are of type T, one per selected row.
+     *
+     * Resolved from the cached selection; no per-index QVariant conversion is done.
+     * @return Selected items of type T
+     */
+    template <typename T>
+    QList<T*> selectedItems() const { return _selectedItems.items<T>(selectionModel()); }
+
+    /**
+     * @brief Return the selected model items, one per selected row.
+     *
+     * The result is cached until the next selection change.
+     * @return Selected items in selection order
+     */
+    AbstractModelItem::List selectedModelItems() const { return _selectedItems.items(selectionModel()); }
+
+    /**
+     * @brief Return the UUIDs of the selected items, one per selected row.
+     *
+     * The result is cached until the next selection change.
+     * @return UUIDs of the selected items
+     */
+    QList<QUuid> selectedUuids() const { return _selectedItems.uuids(selectionModel()); }
+
+public slots:
+    /** @brief Invalidate the selected items cache and reset the view. */
+    virtual void reset() override;
+
+protected slots:
+    /** @brief Invalidate the selected items cache and forward to QListView. */
+    virtual void selectionChanged(const QItemSelection& selected, const QItemSelection& deselected) override;
+
 private:
     AbstractItemModel* _sourceModel = nullptr;
     QSortFilterProxyModel* _proxyModel = nullptr;
+    SelectedItemsCache _selectedItems;
 
 signals:
     /** @brief Emitted when the current selection changes. */
@@ -167,6 +167,8 @@ protected:
     virtual void resizeEvent(QResizeEvent *event) override;
     /** @brief Restore geometry and complete form load on first show. */
     virtual void showEvent(QShowEvent *event) override;
+    /** @brief Commit buffered settings on close. */
+    virtual void closeEvent(QCloseEvent *event) override;
 
 private:
     int _type = 0;
@@ -0,0 +1,34 @@
+#ifndef RESOURCELOADER_H
+#define RESOURCELOADER_H
+#include <QObject>
+#include <Kanoop/gui/libkanoopgui.h>
+
+/**
+ * @brief Notifier for images decoded in the background by Resources::preloadAsync().
+ *
+ * There is a single instance, owned by Resources and living on the GUI thread.
+ * Obtain it with Resources::loader().
+ */
+class LIBKANOOPGUI_EXPORT ResourceLoader : public QObject
+{
+    Q_OBJECT
+    friend class Resources;
+
+private:
+    explicit ResourceLoader(QObject* parent = nullptr);
+
+signals:
+    /**
+     * @brief Emitted when an image has been decoded and added to the cache.
+     * @param id Registered image ID
+     */
+    void imageReady(int id);
+
+    /**
+     * @brief Emitted when every image of a preloadAsync() request has been processed.
+     * @param ids The image IDs that were requested
+     */
+    void preloadFinished(const QList<int>& ids);
+};
+
+#endif // RESOURCELOADER_H
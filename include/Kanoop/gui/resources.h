@@ -8,16 +8,28 @@
 ******************************************************************************************/
 #ifndef RESOURCES_H
 #define RESOURCES_H
+#include <QHash>
 #include <QIcon>
+#include <QSet>
 #include <Kanoop/gui/libkanoopgui.h>
 #include <Kanoop/kanoopcommon.h>
 
+class QPainter;
+class ResourceLoader;
+
 /**
  * @brief Central registry mapping integer IDs to Qt resource images.
  *
  * Resources maintains a map of integer IDs to Qt resource paths and provides
  * factory methods for retrieving QIcon and QPixmap instances by ID.
  *
+ * Decoded pixmaps and icons are cached per (ID, size, device pixel ratio), so
+ * repeated lookups do not decode the resource again. The registry and cache are
+ * guarded by a mutex; pixmaps themselves should only be used on the GUI thread.
+ * preloadAsync() decodes images on a worker thread pool ahead of first use, and
+ * createAtlas() packs images of one size into a single sprite atlas for delegates
+ * that draw many small icons.
+ *
  * Standard images (play, pause, spinner, etc.) are pre-registered under the
  * StandardImage enum values.  Application-specific images should use IDs
  * starting at FirstUserResource to avoid collisions.
@@ -46,6 +58,120 @@ public:
      */
     static QPixmap getPixmap(int id);
 
+    /**
+     * @brief Return a QPixmap for the given image ID scaled for a logical size and device pixel ratio.
+     * @param id Registered image ID
+     * @param size Logical size in device-independent pixels
+     * @param devicePixelRatio Device pixel ratio of the target surface
+     * @return Scaled QPixmap with its device pixel ratio set
+     */
+    static QPixmap getPixmap(int id, const QSize& size, qreal devicePixelRatio = 1.0);
+
+    /**
+     * @brief Decode and cache the given images ahead of first use.
+     * @param ids Registered image IDs to load
+     * @param sizes Optional logical sizes to prepare scaled variants for
+     * @param devicePixelRatio Device pixel ratio for the scaled variants
+     */
+    static void preload(const QList<int>& ids, const QList<QSize>& sizes = QList<QSize>(), qreal devicePixelRatio = 1.0);
+
+    /**
+     * @brief Decode images on a worker thread pool and add them to the cache when ready.
+     *
+     * Decoding to QImage happens off the GUI thread; conversion to QPixmap happens on
+     * the GUI thread. loader() emits imageReady() for each image and preloadFinished()
+     * once the whole list has been processed. Must be called from the GUI thread.
+     * @param ids Registered image IDs to load
+     */
+    static void preloadAsync(const QList<int>& ids);
+
+    /**
+     * @brief Return whether an image is still being decoded by preloadAsync().
+     * @param id Registered image ID
+     * @return true if the image is in flight
+     */
+    static bool isLoading(int id);
+
+    /**
+     * @brief Return the notifier for background image loading.
+     * @return The ResourceLoader instance
+     */
+    static ResourceLoader* loader();
+
+    /**
+     * @brief Set the image returned while a requested image is still loading.
+     * @param id Registered image ID of the placeholder, or UnknownImage for a null pixmap
+     */
+    static void setLoadingPlaceholder(int id);
+
+    /**
+     * @brief Choose between a placeholder and a synchronous decode for images still loading.
+     * @param value If true, requests for an in-flight image decode it immediately on the calling thread
+     */
+    static void setBlockWhileLoading(bool value);
+
+    /**
+     * @brief Pack all registered images into a sprite atlas of fixed-size cells.
+     *
+     * Every registered image is scaled to cellSize and drawn into a single pixmap with
+     * power-of-two dimensions. Images registered afterwards are added to every existing
+     * atlas at registration time, so once an atlas exists images must be registered from
+     * the GUI thread. Must be called from the GUI thread.
+     * @param cellSize Logical size of each atlas cell
+     * @param devicePixelRatio Device pixel ratio the atlas is rendered for
+     */
+    static void createAtlas(const QSize& cellSize, qreal devicePixelRatio = 1.0);
+
+    /**
+     * @brief Return whether an atlas exists for a cell size.
+     * @param cellSize Logical cell size
+     * @return true if createAtlas() was called for this size
+     */
+    static bool hasAtlas(const QSize& cellSize);
+
+    /**
+     * @brief Return the atlas pixmap for a cell size.
+     * @param cellSize Logical cell size
+     * @return Atlas pixmap, or a null pixmap if there is no atlas for this size
+     */
+    static QPixmap atlasPixmap(const QSize& cellSize);
+
+    /**
+     * @brief Return the source rectangle of an image within an atlas.
+     * @param id Registered image ID
+     * @param cellSize Logical cell size
+     * @return Rectangle in atlas pixels, or a null rectangle if the image is not packed
+     */
+    static QRect atlasRect(int id, const QSize& cellSize);
+
+    /**
+     * @brief Draw an image from its atlas.
+     * @param painter Painter to draw with
+     * @param target Logical target rectangle
+     * @param id Registered image ID
+     * @param cellSize Logical cell size of the atlas to draw from
+     * @return true if the image was drawn, false if it is not in an atlas of that size
+     */
+    static bool drawAtlasImage(QPainter* painter, const QRect& target, int id, const QSize& cellSize);
+
+    /** @brief Discard all cached pixmaps and icons. */
+    static void clearCache();
+
+    /**
+     * @brief Return the number of pixmap and icon requests served from the cache.
+     * @return Cache hit count
+     */
+    static quint64 cacheHits();
+
+    /**
+     * @brief Return the number of pixmap and icon requests that had to decode an image.
+     * @return Cache miss count
+     */
+    static quint64 cacheMisses();
+
+    /** @brief Reset the hit and miss counters to zero. */
+    static void resetCacheStatistics();
+
     /**
      * @brief Built-in standard image identifiers.
      */
@@ -75,9 +201,66 @@ public:
     static const int FirstUserResource = 100000;
 
 private:
-    /** @brief Register all StandardImage entries; called lazily on first use. */
+    /** @brief Register all StandardImage entries; runs once during static initialization. */
     static bool registerStandardImages();
 
+    /** @brief Record a registration; the lock must be held. */
+    static void registerImageLocked(int id, const QString& resourcePath);
+
+    /** @brief Look up or decode a pixmap and cache it under the given key. */
+    static QPixmap cachedPixmap(int id, const QSize& size, qreal devicePixelRatio);
+
+    /** @brief Return the placeholder if the image is in flight and callers should not block. */
+    static bool loadingPlaceholder(int id, QPixmap& placeholder);
+
+    /** @brief Cache an image decoded by preloadAsync(); runs on the GUI thread. */
+    static void completeLoad(int id, const QImage& image);
+
+    /** @brief Draw an image into every existing atlas; runs on the GUI thread. */
+    static void addToAtlases(int id);
+    /** @brief Draw an image into the atlas with the given key; runs on the GUI thread. */
+    static void addToAtlas(quint64 key, int id);
+
+    class Atlas
+    {
+    public:
+        QSize cellSize;
+        qreal devicePixelRatio = 1.0;
+        QPixmap pixmap;
+        QHash<int, QRect> rects;
+    };
+
+    static quint64 atlasKey(const QSize& cellSize) { return (static_cast<quint64>(cellSize.width()) << 32) | static_cast<quint32>(cellSize.height()); }
+    static void packIntoAtlas(Atlas& atlas, int id, const QPixmap& pixmap);
+
+    /** @brief Number of cells per atlas row. */
+    static const int AtlasColumns = 16;
+
+    class PixmapKey
+    {
+    public:
+        PixmapKey() {}
+        PixmapKey(int id, const QSize& size, qreal devicePixelRatio) :
+            _id(id), _size(size), _devicePixelRatio(devicePixelRatio) {}
+
+        int id() const { return _id; }
+
+        bool operator==(const PixmapKey& other) const
+        {
+            return _id == other._id && _size == other._size && qFuzzyCompare(_devicePixelRatio, other._devicePixelRatio);
+        }
+
+        friend size_t qHash(const PixmapKey& key, size_t seed = 0)
+        {
+            return qHashMulti(seed, key._id, key._size.width(), key._size.height(), qRound(key._devicePixelRatio * 100));
+        }
+
+    private:
+        int _id = 0;
+        QSize _size;
+        qreal _devicePixelRatio = 1.0;
+    };
+
     class StandardImageToStringMap : public KANOOP::EnumToStringMap<StandardImage>
     {
     public:
@@ -103,6 +286,14 @@ private:
     };
 
     static QMap<int, QString> _registeredImages;
+    static QHash<PixmapKey, QPixmap> _pixmapCache;
+    static QHash<int, QIcon> _iconCache;
+    static quint64 _cacheHits;
+    static quint64 _cacheMisses;
+    static QSet<int> _loadingIds;
+    static int _loadingPlaceholderId;
+    static bool _blockWhileLoading;
+    static QHash<quint64, Atlas> _atlases;
     static bool _standardImagesRegistered;
     static const StandardImageToStringMap _StandardImageToStringMap;
 };
@@ -0,0 +1,77 @@
+#ifndef SELECTEDITEMSCACHE_H
+#define SELECTEDITEMSCACHE_H
+#include <QList>
+#include <QPointer>
+#include <QUuid>
+#include <Kanoop/gui/abstractmodelitem.h>
+#include <Kanoop/gui/libkanoopgui.h>
+
+class QAbstractItemModel;
+class QItemSelectionModel;
+
+/**
+ * @brief Lazily built list of the AbstractModelItem objects behind a view's selection.
+ *
+ * Selection ranges are mapped through every proxy level straight to the items held
+ * in the source model's internal pointers, avoiding a QVariant round-trip per index.
+ * The result is kept until invalidate() is called, which the views do on every
+ * selection change and model reset, or until the selection model, the view's model
+ * or the source model behind the proxies is replaced.
+ */
+class LIBKANOOPGUI_EXPORT SelectedItemsCache
+{
+public:
+    /**
+     * @brief Return the selected items, one per selected row.
+     * @param selectionModel Selection model of the view
+     * @return Selected items in selection order
+     */
+    const AbstractModelItem::List& items(const QItemSelectionModel* selectionModel) const;
+
+    /**
+     * @brief Return the selected items which are of type T, one per selected row.
+     * @param selectionModel Selection model of the view
+     * @return Selected items of type T in selection order
+     */
+    template <typename T>
+    QList<T*> items(const QItemSelectionModel* selectionModel) const
+    {
+        QList<T*> result;
+        const AbstractModelItem::List& selected = items(selectionModel);
+        result.reserve(selected.count());
+        for(AbstractModelItem* item : selected) {
+            T* typed = dynamic_cast<T*>(item);
+            if(typed != nullptr) {
+                result.append(typed);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Return the UUIDs of the selected items.
+     * @param selectionModel Selection model of the view
+     * @return UUIDs of the selected items in selection order
+     */
+    const QList<QUuid>& uuids(const QItemSelectionModel* selectionModel) const;
+
+    /** @brief Discard the cached result. */
+    void invalidate();
+
+    /**
+     * @brief Return whether the cache currently holds a result.
+     * @return true if the selection has been resolved since the last invalidate()
+     */
+    bool isValid() const { return _itemsValid; }
+
+private:
+    mutable AbstractModelItem::List _items;
+    mutable QList<QUuid> _uuids;
+    mutable bool _itemsValid = false;
+    mutable bool _uuidsValid = false;
+    mutable QPointer<const QItemSelectionModel> _selectionModel;
+    mutable QPointer<const QAbstractItemModel> _model;
+    mutable QPointer<const QAbstractItemModel> _sourceModel;
+};
+
+#endif // SELECTEDITEMSCACHE_H
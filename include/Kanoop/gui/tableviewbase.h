@@ -15,6 +15,7 @@
 
 #include <QTableView>
 #include <Kanoop/gui/libkanoopgui.h>
+#include <Kanoop/gui/selecteditemscache.h>
 
 class QStyledItemDelegate;
 class QSortFilterProxyModel;
@@ -80,6 +81,31 @@ public:
      */
     QSortFilterProxyModel* proxyModel() const { return _proxyModel; }
 
+    /**
+     * @brief Return the selected items which are of type T, one per selected row.
+     *
+     * Resolved from the cached selection; no per-index QVariant conversion is done.
+     * @return Selected items of type T
+     */
+    template <typename T>
+    QList<T*> selectedItems() const { return _selectedItems.items<T>(selectionModel()); }
+
+    /**
+     * @brief Return the selected model items, one per selected row.
+     *
+     * The result is cached until the next selection change.
+     * @return Selected items in selection order
+     */
+    AbstractModelItem::List selectedModelItems() const { return _selectedItems.items(selectionModel()); }
+
+    /**
+     * @brief Return the UUIDs of the selected items, one per selected row.
+     *
+     * The result is cached until the next selection change.
+     * @return UUIDs of the selected items
+     */
+    QList<QUuid> selectedUuids() const { return _selectedItems.uuids(selectionModel()); }
+
     /**
      * @brief Delete the row identified by the given model index.
      * @param index Model index of the row to delete
@@ -151,6 +177,9 @@ public slots:
     /** @brief Remove all rows from the view model. */
     void clear();
 
+    /** @brief Invalidate the selected items cache and reset the view. */
+    virtual void reset() override;
+
 private:
     AbstractItemModel* _sourceModel;
     QSortFilterProxyModel* _proxyModel;
@@ -162,6 +191,7 @@ private:
     QAction* _actionResetCols = nullptr;
 
     QPoint _contextMenuPoint;
+    SelectedItemsCache _selectedItems;
 
 signals:
     /** @brief Emitted when the horizontal header is resized. */
@@ -188,6 +218,8 @@ signals:
 protected slots:
     /** @brief Internal override forwarding current-index changes to currentIndexChanged(). */
     virtual void currentChanged(const QModelIndex& current, const QModelIndex& previous) override;
+    /** @brief Invalidate the selected items cache and forward to QTableView. */
+    virtual void selectionChanged(const QItemSelection& selected, const QItemSelection& deselected) override;
 
 private slots:
     virtual void onHorizontalHeaderResized(int /*logicalIndex*/, int /*oldSize*/, int /*newSize*/);
@@ -10,7 +10,9 @@
  * @brief QItemSelectionModel subclass with logging support for tree views.
  *
  * Overrides select() to allow subclasses or debug instrumentation to intercept
- * selection changes made on a tree view.
+ * selection changes made on a tree view. Selected items are restricted to a single
+ * parent; the parent is checked per selection range and cached between calls, so
+ * selecting large contiguous ranges costs time proportional to the number of ranges.
  */
 class LIBKANOOPGUI_EXPORT TreeSelectionModel : public QItemSelectionModel,
                                                public LoggingBaseClass
@@ -24,6 +26,12 @@ public:
      */
     TreeSelectionModel(QAbstractItemModel *model, QObject *parent = nullptr);
 
+    /**
+     * @brief Return the common parent of the currently selected items.
+     * @return Parent index, or an invalid index if nothing is selected
+     */
+    QModelIndex selectionParent() const;
+
 public slots:
     /**
      * @brief Select a single index with the given selection flags.
@@ -38,6 +46,15 @@ public slots:
      * @param command Selection flags controlling how the selection is modified
      */
     virtual void select(const QItemSelection& selection, QItemSelectionModel::SelectionFlags command) override;
+
+private:
+    void connectModelSignals();
+
+    mutable QPersistentModelIndex _selectionParent;
+    mutable bool _selectionParentValid = false;
+
+private slots:
+    void invalidateSelectionParent();
 };
 
 #endif // TREESELECTIONMODEL_H
@@ -13,9 +13,13 @@
 #include <Kanoop/entitymetadata.h>
 
 #include <QTreeView>
+#include <QSet>
+#include <QTimer>
+#include <QUuid>
 
 #include <Kanoop/utility/loggingbaseclass.h>
 #include <Kanoop/gui/libkanoopgui.h>
+#include <Kanoop/gui/selecteditemscache.h>
 
 class QSortFilterProxyModel;
 class QStyledItemDelegate;
@@ -144,17 +148,71 @@ public:
     QModelIndex currentSourceIndex() const;
 
     /**
-     * @brief Save the header and expansion state to a byte array.
+     * @brief Save the expansion, selection and scroll state to a byte array.
+     *
+     * The state is written in a versioned binary format holding raw 16-byte
+     * UUIDs. Large states are compressed when allowCompression is true.
+     * @param allowCompression Compress the state if it exceeds a small threshold
      * @return Serialized state
      */
-    QByteArray saveState() const;
+    QByteArray saveState(bool allowCompression = true) const;
 
     /**
-     * @brief Restore header and expansion state from a byte array.
+     * @brief Restore expansion, selection and scroll state from a byte array.
+     *
+     * Accepts both the binary format produced by saveState() and the legacy
+     * UUID string format.
      * @param state Previously saved state
      */
     void restoreState(const QByteArray& state);
 
+    /**
+     * @brief Restore state incrementally while the model is being populated.
+     *
+     * The state is held as pending and applied in time-sliced batches, first to the
+     * rows already present and then to rows as they are inserted, including lazily
+     * fetched children. A model reset restarts the restore against the new contents.
+     * stateRestoreFinished() is emitted once every saved item has been found, once the
+     * whole model has been walked without finding the rest (saved items that no longer
+     * exist), or when the restore is cancelled. If expanding a saved item started a
+     * lazy fetch, the restore waits up to restoreIdleTimeout() for more rows first.
+     * @param state Previously saved state
+     */
+    void restoreStateIncrementally(const QByteArray& state);
+
+    /** @brief Abandon a restore started with restoreStateIncrementally(). */
+    void cancelPendingRestore();
+
+    /**
+     * @brief Return whether an incremental restore is still waiting for items.
+     * @return true if a restore is pending
+     */
+    bool isRestorePending() const { return _restorePending; }
+
+    /**
+     * @brief Return the time budget for each incremental restore batch.
+     * @return Time slice in milliseconds
+     */
+    int restoreTimeSlice() const { return _restoreTimeSlice; }
+
+    /**
+     * @brief Set the time budget for each incremental restore batch.
+     * @param value Time slice in milliseconds
+     */
+    void setRestoreTimeSlice(int value) { _restoreTimeSlice = value; }
+
+    /**
+     * @brief Return how long a restore waits for lazily fetched rows once the model has been walked.
+     * @return Idle timeout in milliseconds
+     */
+    int restoreIdleTimeout() const { return _restoreIdleTimer.interval(); }
+
+    /**
+     * @brief Set how long a restore waits for lazily fetched rows once the model has been walked.
+     * @param value Idle timeout in milliseconds
+     */
+    void setRestoreIdleTimeout(int value) { _restoreIdleTimer.setInterval(value); }
+
     /** @brief Restore horizontal header state (column widths/order) from settings. */
     void restoreHeaderStates();
 
@@ -182,6 +240,31 @@ public:
      */
     QSortFilterProxyModel* proxyModel() const { return _proxyModel; }
 
+    /**
+     * @brief Return the selected items which are of type T, one per selected row.
+     *
+     * Resolved from the cached selection; no per-index QVariant conversion is done.
+     * @return Selected items of type T
+     */
+    template <typename T>
+    QList<T*> selectedItems() const { return _selectedItems.items<T>(selectionModel()); }
+
+    /**
+     * @brief Return the selected model items, one per selected row.
+     *
+     * The result is cached until the next selection change.
+     * @return Selected items in selection order
+     */
+    AbstractModelItem::List selectedModelItems() const { return _selectedItems.items(selectionModel()); }
+
+    /**
+     * @brief Return the UUIDs of the selected items, one per selected row.
+     *
+     * The result is cached until the next selection change.
+     * @return UUIDs of the selected items
+     */
+    QList<QUuid> selectedUuids() const { return _selectedItems.uuids(selectionModel()); }
+
     /**
      * @brief Recursively collapse index and all its descendants up to a depth limit.
      * @param index Root index to collapse from
@@ -197,6 +280,46 @@ public:
      */
     bool isLeafExpanded(const QModelIndex& index, bool recursive = true) const;
 
+    /**
+     * @brief Return all indexes whose item UUID is contained in the given set.
+     *
+     * The whole tree is visited once, regardless of the size of the set.
+     * @param uuids UUIDs to search for
+     * @return List of matching (view model) indexes
+     */
+    QModelIndexList indexesOfUuids(const QSet<QUuid>& uuids) const;
+
+    /**
+     * @brief Return the UUIDs of all currently expanded items.
+     *
+     * Includes items which are expanded beneath a collapsed ancestor.
+     * @return Set of expanded item UUIDs
+     */
+    QSet<QUuid> expandedUuids() const;
+
+    /**
+     * @brief Expand every item whose UUID is contained in the given set.
+     *
+     * The UUIDs are resolved in a single tree pass and all expansions are
+     * applied with layout suspended, so the view is laid out only once.
+     * @param uuids UUIDs of the items to expand
+     */
+    void expandUuids(const QSet<QUuid>& uuids);
+
+    /**
+     * @brief Collapse every item whose UUID is contained in the given set.
+     * @param uuids UUIDs of the items to collapse
+     */
+    void collapseUuids(const QSet<QUuid>& uuids);
+
+    /**
+     * @brief Make the given UUIDs the exact set of expanded items.
+     *
+     * All other items are collapsed. Costs a single layout pass.
+     * @param uuids UUIDs of the items to leave expanded
+     */
+    void setExpandedUuids(const QSet<QUuid>& uuids);
+
     /**
      * @brief Return whether the given index is visible in the current viewport.
      * @param index Index to check
@@ -256,6 +379,9 @@ public slots:
     /** @brief Remove all items from the view model. */
     virtual void clear();
 
+    /** @brief Invalidate the selected items cache and reset the view. */
+    virtual void reset() override;
+
 protected:
     /**
      * @brief Walk ancestors of the current index to find one with the given entity type.
@@ -298,7 +424,44 @@ protected:
     /** @brief Test whether index matches value under role using flags, appending to foundIndexes. */
     static bool testMatch(const QModelIndex& index, int role, const QVariant &value, Qt::MatchFlags flags, QModelIndexList& foundIndexes);
 
+protected slots:
+    /** @brief Invalidate the selected items cache and forward to QTreeView. */
+    virtual void selectionChanged(const QItemSelection& selected, const QItemSelection& deselected) override;
+    /** @brief Feed inserted rows to a pending incremental restore. */
+    virtual void rowsInserted(const QModelIndex& parent, int start, int end) override;
+
 private:
+    static const int DefaultRestoreTimeSlice = 8;
+    static const int DefaultRestoreIdleTimeout = 2000;
+
+    class TreeState
+    {
+    public:
+        QSet<QUuid> expanded;
+        QSet<QUuid> selected;
+        QUuid current;
+        QUuid anchor;
+
+        bool isResolved() const { return expanded.isEmpty() && selected.isEmpty() && current.isNull() && anchor.isNull(); }
+    };
+
+    class PendingRows
+    {
+    public:
+        QPersistentModelIndex parent;
+        bool isRoot = false;
+        int first = 0;
+        int last = -1;
+    };
+
+    bool parseState(const QByteArray& state, TreeState& result) const;
+    void enqueuePendingRows(const QModelIndex& parent, int first, int last);
+    void finishPendingRestore(bool complete);
+    void beginBulkExpansion();
+    void endBulkExpansion();
+    void setUuidsExpanded(const QSet<QUuid>& uuids, bool expanded);
+    QSet<QUuid> selectedRowUuids() const;
+
     AbstractItemModel* _sourceModel = nullptr;
     QSortFilterProxyModel* _proxyModel = nullptr;
     QMap<int, QStyledItemDelegate*> _columnDelegates;
@@ -309,6 +472,20 @@ private:
     QAction* _actionResetCols = nullptr;
 
     QPoint _contextMenuPos;
+    SelectedItemsCache _selectedItems;
+    int _bulkExpansionDepth = 0;
+
+    TreeState _savedState;
+    TreeState _pendingState;
+    QList<PendingRows> _pendingRows;
+    QSet<QPersistentModelIndex> _queuedParents;
+    QPersistentModelIndex _restoreAnchor;
+    bool _restorePending = false;
+    bool _restoreSelectionCleared = false;
+    bool _restoreAwaitingFetch = false;
+    int _restoreTimeSlice = DefaultRestoreTimeSlice;
+    QTimer _restoreTimer;
+    QTimer _restoreIdleTimer;
 
 signals:
     /** @brief Emitted when an item is selected programmatically. */
@@ -330,6 +507,12 @@ signals:
     /** @brief Emitted when an entity is updated. */
     void entityUpdated(const EntityMetadata& metadata);
 
+    /**
+     * @brief Emitted when an incremental restore ends.
+     * @param complete true if every saved item was found, false if some were not found or the restore was cancelled
+     */
+    void stateRestoreFinished(bool complete);
+
 private slots:
     virtual void onHorizontalHeaderResized(int /*logicalIndex*/, int /*oldSize*/, int /*newSize*/);
 
@@ -339,6 +522,8 @@ private slots:
     void onAutoResizeColumnsClicked();
     void onResetColumnsClicked();
     void onCurrentSelectionChanged(const QModelIndex& current, const QModelIndex& previous);
+    void onRestoreTimer();
+    void onRestoreIdleTimer();
 };
 
 #endif // TREEVIEWBASE_H
@@ -0,0 +1,43 @@
+#ifndef FONTSCALER_H
+#define FONTSCALER_H
+
+#include <Kanoop/gui/libkanoopgui.h>
+
+class QWidget;
+
+/**
+ * @brief Static helpers for propagating the preferred font size to widget trees.
+ *
+ * Descendants inherit the root's font, so changing the root's font is enough to
+ * update them; widgets whose font size was set explicitly keep it. Only child
+ * windows that do not inherit from their parent (menus, popups) are visited
+ * individually, and among those only the ones without an explicitly sized font
+ * or whose size FontScaler set itself. Widgets already at the requested size are
+ * skipped and painting is suspended on the root while the change is applied.
+ */
+class LIBKANOOPGUI_EXPORT FontScaler
+{
+public:
+    /**
+     * @brief Apply a point size to a widget and the child windows that do not inherit it.
+     * @param root Top of the widget tree to update
+     * @param pointSize Point size to apply
+     * @return Number of widgets whose font was changed
+     */
+    static int applyPointSize(QWidget* root, int pointSize);
+
+    /**
+     * @brief Apply GuiSettings::fontSize() to a widget tree.
+     * Does nothing if there is no global GuiSettings instance or no font size is stored.
+     * @param root Top of the widget tree to update
+     * @return Number of widgets whose font was changed
+     */
+    static int applyPreferredPointSize(QWidget* root);
+
+private:
+    static bool setPointSize(QWidget* widget, int pointSize);
+
+    static const char* ScaledProperty;
+};
+
+#endif // FONTSCALER_H
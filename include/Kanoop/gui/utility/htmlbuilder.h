@@ -13,19 +13,34 @@
 #include <Kanoop/gui/libkanoopgui.h>
 #include <Kanoop/gui/utility/htmlutil.h>
 
-#include <QTextStream>
+#include <QModelIndex>
+#include <QStringList>
+
+class QAbstractItemModel;
 
 /**
  * @brief Streaming HTML fragment builder.
  *
- * HtmlBuilder accumulates HTML into an internal string via a QTextStream.
- * Call the open/close methods in order, then retrieve the result with toString().
+ * HtmlBuilder appends tags and escaped text directly into a single reserved
+ * string; constant tags are written from literals and never go through a
+ * temporary. Call the open/close methods in order, or use the bulk row and
+ * table methods, then retrieve the result with toString().
  */
 class LIBKANOOPGUI_EXPORT HtmlBuilder
 {
 public:
-    /** @brief Construct an empty builder. */
-    HtmlBuilder();
+    /**
+     * @brief Construct an empty builder.
+     * @param reserveSize Number of characters to preallocate for the output
+     */
+    explicit HtmlBuilder(qsizetype reserveSize = DefaultReserveSize);
+
+    /**
+     * @brief Ensure the output buffer can hold at least the given number of characters.
+     * Call before building large tables to avoid repeated reallocation.
+     * @param size Total number of characters to reserve
+     */
+    void reserve(qsizetype size) { _result.reserve(size); }
 
     /**
      * @brief Append an opening &lt;p&gt; tag with optional foreground and background colors.
@@ -76,21 +91,57 @@ public:
      */
     void appendCell(const QString& text, Qt::Alignment alignment = Qt::AlignLeft);
 
+    /**
+     * @brief Append a complete &lt;tr&gt; row with one HTML-escaped cell per string.
+     * @param cells Cell texts, in column order
+     * @param alignment Horizontal alignment applied to every cell
+     */
+    void appendRow(const QStringList& cells, Qt::Alignment alignment = Qt::AlignLeft);
+
+    /**
+     * @brief Append a complete table built from a range of model rows.
+     *
+     * A header row is emitted from the model's horizontal header data when any
+     * column has one. Cells use Qt::DisplayRole text and honor Qt::TextAlignmentRole.
+     * @param model Source model
+     * @param firstRow First row to include
+     * @param lastRow Last row to include (-1 = last row of @p parent)
+     * @param parent Parent index whose children are written
+     * @param cellPadding Pixels of padding inside each cell
+     * @param cellSpacing Pixels of spacing between cells
+     * @return Number of data rows written
+     */
+    int appendTable(const QAbstractItemModel* model, int firstRow = 0, int lastRow = -1,
+                    const QModelIndex& parent = QModelIndex(), int cellPadding = 2, int cellSpacing = 0);
+
     /**
      * @brief Append plain text to the output.
      * @param text Text to append (not HTML-escaped)
      */
     void appendText(const QString& text);
 
+    /**
+     * @brief Append HTML-escaped text to the output.
+     * @param text Text to escape and append
+     */
+    void appendEscapedText(const QString& text);
+
+    /** @brief Discard the accumulated HTML, keeping the allocated buffer. */
+    void clear() { _result.resize(0); }
+
     /**
      * @brief Return the accumulated HTML string.
      * @return HTML fragment built so far
      */
     QString toString() const { return _result; }
 
+    /** @brief Default number of characters preallocated for the output. */
+    static const qsizetype DefaultReserveSize = 256;
+
 private:
+    void appendAlignedTag(QLatin1StringView tag, Qt::Alignment alignment);
+
     QString _result;
-    QTextStream _output;
 };
 
 #endif // HTMLBUILDER_H
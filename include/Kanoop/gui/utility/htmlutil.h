@@ -97,6 +97,16 @@ public:
      * @return Escaped text
      */
     static QString escape(const QString& text);
+
+    /**
+     * @brief HTML-escape text directly onto the end of an existing string.
+     *
+     * Produces the same output as QString::toHtmlEscaped() but copies unescaped runs
+     * straight into @p output without building a temporary.
+     * @param output String to append to
+     * @param text Text to escape
+     */
+    static void appendEscaped(QString& output, QStringView text);
 };
 
 #endif // HTMLUTIL_H
@@ -7,6 +7,7 @@
 
 #include <QColor>
 #include <QGradient>
+#include <QVarLengthArray>
 #include <QWidget>
 
 /**
@@ -19,6 +20,9 @@
  * An optional pseudo-state (e.g., PS_Hover) and sub-control selector can
  * narrow the rule to a specific widget state or part.
  *
+ * Properties are held in a small inline array kept in enum order, and toString()
+ * sizes the result up front and fills it with a single allocation.
+ *
  * @tparam T QWidget subclass whose class name is used as the selector
  */
 template <typename T>
@@ -28,10 +32,8 @@ public:
     static_assert(std::is_base_of<QWidget, T>::value, "Templatized class type must be subclass of QWidget");
 
     /** @brief Construct and capture the widget class name as the CSS selector. */
-    StyleSheet()
-    {
-        _typeName = T::staticMetaObject.className();
-    }
+    StyleSheet() :
+        _typeName(T::staticMetaObject.className()) {}
 
     /**
      * @brief Set a stylesheet property to a string value.
@@ -116,7 +118,7 @@ public:
      * @brief Set the full pseudo-state chain at once.
      * @param values Ordered list of pseudo-states; emitted as `:value1:value2...`
      */
-    void setPseudoStates(const QList<StyleSheetPseudoState>& values) { _pseudoStates = values; }
+    void setPseudoStates(const QList<StyleSheetPseudoState>& values) { _pseudoStates.assign(values.begin(), values.end()); }
 
     /**
      * @brief Set the sub-control selector string (e.g., "::handle").
@@ -130,6 +132,16 @@ public:
      */
     void setSubControl(StyleSheetSubControl value);
 
+    /**
+     * @brief Narrow the rule to widgets whose dynamic property has the given value.
+     *
+     * Emitted as `[name="value"]` after the class name, so one application-level rule
+     * can cover a widget state that is switched with QObject::setProperty().
+     * @param name Dynamic property name
+     * @param value Property value to match
+     */
+    void addPropertySelector(const QString& name, const QString& value) { _propertySelectors += QString("[%1=\"%2\"]").arg(name, value); }
+
     /**
      * @brief Render all accumulated properties into a complete stylesheet rule.
      * @return Stylesheet string suitable for QWidget::setStyleSheet()
@@ -137,15 +149,24 @@ public:
     QString toString() const;
 
 
+    /** @brief A single property/value pair of the rule. */
+    struct Entry
+    {
+        StyleSheetProperty property;
+        QString value;
+    };
+
     /** @brief CSS selector class name (set from T::metaObject()->className()). */
-    QString _typeName;
+    QLatin1StringView _typeName;
 
-    /** @brief Accumulated property/value pairs for the stylesheet rule. */
-    QMap<StyleSheetProperty, QString> _properties;
+    /** @brief Accumulated property/value pairs for the stylesheet rule, sorted by property. */
+    QVarLengthArray<Entry, 8> _properties;
     /** @brief Pseudo-state selectors applied to the rule, in order (empty = none). */
-    QList<StyleSheetPseudoState> _pseudoStates;
+    QVarLengthArray<StyleSheetPseudoState, 4> _pseudoStates;
     /** @brief Sub-control selector string (empty = none). */
     QString _subControl;
+    /** @brief Dynamic property selectors, e.g. `[state="error"]` (empty = none). */
+    QString _propertySelectors;
 };
 
 #endif // STYLESHEET_H
@@ -0,0 +1,60 @@
+#ifndef STYLESHEETCACHE_H
+#define STYLESHEETCACHE_H
+
+#include <Kanoop/gui/libkanoopgui.h>
+#include <QString>
+
+class QWidget;
+
+/**
+ * @brief Interning cache for generated widget stylesheets.
+ *
+ * Widgets that rebuild their StyleSheet<T> on every color change produce the
+ * same handful of strings over and over. intern() hands back one shared QString
+ * instance per distinct sheet, and apply() skips QWidget::setStyleSheet() (and
+ * the re-polish it triggers) when the widget already carries that sheet.
+ */
+class LIBKANOOPGUI_EXPORT StyleSheetCache
+{
+public:
+    /**
+     * @brief Return the shared instance of a stylesheet string.
+     * @param styleSheet Stylesheet text
+     * @return A QString sharing its data with every other interned copy of the same text
+     */
+    static QString intern(const QString& styleSheet);
+
+    /**
+     * @brief Apply a stylesheet to a widget unless it is already in effect.
+     * @param widget Widget to style
+     * @param styleSheet Stylesheet text
+     * @return true if setStyleSheet() was called, false if the sheet was unchanged
+     */
+    static bool apply(QWidget* widget, const QString& styleSheet);
+
+    /**
+     * @brief Return the number of distinct interned stylesheets.
+     * @return Interned stylesheet count
+     */
+    static int count();
+
+    /**
+     * @brief Return how many apply() calls changed a widget's stylesheet.
+     * @return Applied count
+     */
+    static quint64 appliedCount();
+
+    /**
+     * @brief Return how many apply() calls were skipped because the sheet was unchanged.
+     * @return Skipped count
+     */
+    static quint64 skippedCount();
+
+    /** @brief Drop all interned strings and reset the counters. */
+    static void clear();
+
+    /** @brief Stop interning once this many distinct sheets are held; apply() still skips unchanged sheets. */
+    static const int MaxInternedSheets = 4096;
+};
+
+#endif // STYLESHEETCACHE_H
@@ -2,6 +2,9 @@
 #define STYLESHEETTYPES_H
 
 #include <Kanoop/kanoopcommon.h>
+#include <Kanoop/gui/libkanoopgui.h>
+
+#include <QLatin1StringView>
 
 /**
  * @brief Qt stylesheet property identifiers.
@@ -213,8 +216,11 @@ enum StyleSheetSubControl {
 
 /**
  * @brief Utility class for converting stylesheet enums to their CSS string equivalents.
+ *
+ * Names come from constant tables indexed by the enum value, so lookups do not
+ * allocate; the name() variants return views onto static Latin-1 data.
  */
-class StyleSheetStrings
+class LIBKANOOPGUI_EXPORT StyleSheetStrings
 {
 public:
     /**
@@ -222,227 +228,42 @@ public:
      * @param property Property enum value
      * @return CSS property name string (e.g., "background-color")
      */
-    static QString getPropertyString(StyleSheetProperty property) { return _PropertyToStringMap.getString(property); }
+    static QString getPropertyString(StyleSheetProperty property) { return propertyName(property); }
 
     /**
      * @brief Return the CSS pseudo-state name for a StyleSheetPseudoState value.
      * @param pseudoState Pseudo-state enum value
      * @return CSS pseudo-state string (e.g., "hover")
      */
-    static QString getPseudoStateString(StyleSheetPseudoState pseudoState) { return _PseudoStateToStringMap.getString(pseudoState); }
+    static QString getPseudoStateString(StyleSheetPseudoState pseudoState) { return pseudoStateName(pseudoState); }
 
     /**
      * @brief Return the CSS sub-control name for a StyleSheetSubControl value.
      * @param subControl Sub-control enum value
      * @return CSS sub-control string (e.g., "indicator")
      */
-    static QString getSubControlString(StyleSheetSubControl subControl) { return _SubControlToStringMap.getString(subControl); }
-
-private:
-    class PropertyToStringMap : public KANOOP::EnumToStringMap<StyleSheetProperty>
-    {
-    public:
-        PropertyToStringMap()
-        {
-            insert(SP_AccentColor,                             "accent-color");
-            insert(SP_AlternateBackgroundColor,                "alternate-background-color");
-            insert(SP_Background,                              "background");
-            insert(SP_BackgroundColor,                         "background-color");
-            insert(SP_BackgroundImage,                         "background-image");
-            insert(SP_BackgroundRepeat,                        "background-repeat");
-            insert(SP_BackgroundPosition,                      "background-position");
-            insert(SP_BackgroundAttachment,                    "background-attachment");
-            insert(SP_BackgroundClip,                          "background-clip");
-            insert(SP_BackgroundOrigin,                        "background-origin");
-            insert(SP_Border,                                  "border");
-            insert(SP_BorderTop,                               "border-top");
-            insert(SP_BorderRight,                             "border-right");
-            insert(SP_BorderBottom,                            "border-bottom");
-            insert(SP_BorderLeft,                              "border-left");
-            insert(SP_BorderColor,                             "border-color");
-            insert(SP_BorderTopColor,                          "border-top-color");
-            insert(SP_BorderRightColor,                        "border-right-color");
-            insert(SP_BorderBottomColor,                       "border-bottom-color");
-            insert(SP_BorderLeftColor,                         "border-left-color");
-            insert(SP_BorderImage,                             "border-image");
-            insert(SP_BorderRadius,                            "border-radius");
-            insert(SP_BorderTopLeftRadius,                     "border-top-left-radius");
-            insert(SP_BorderTopRightRadius,                    "border-top-right-radius");
-            insert(SP_BorderBottomRightRadius,                 "border-bottom-right-radius");
-            insert(SP_BorderBottomLeftRadius,                  "border-bottom-left-radius");
-            insert(SP_BorderStyle,                             "border-style");
-            insert(SP_BorderTopStyle,                          "border-top-style");
-            insert(SP_BorderRightStyle,                        "border-right-style");
-            insert(SP_BorderBottomStyle,                       "border-bottom-style");
-            insert(SP_BorderLeftStyle,                         "border-left-style");
-            insert(SP_BorderWidth,                             "border-width");
-            insert(SP_BorderTopWidth,                          "border-top-width");
-            insert(SP_BorderRightWidth,                        "border-right-width");
-            insert(SP_BorderBottomWidth,                       "border-bottom-width");
-            insert(SP_BorderLeftWidth,                         "border-left-width");
-            insert(SP_Bottom,                                  "bottom");
-            insert(SP_ButtonLayout,                            "button-layout");
-            insert(SP_Color,                                   "color");
-            insert(SP_DialogbuttonboxButtonsHaveIcons,         "dialogbuttonbox-buttons-have-icons");
-            insert(SP_Font,                                    "font");
-            insert(SP_FontFamily,                              "font-family");
-            insert(SP_FontSize,                                "font-size");
-            insert(SP_FontStyle,                               "font-style");
-            insert(SP_FontWeight,                              "font-weight");
-            insert(SP_GridlineColor,                           "gridline-color");
-            insert(SP_Height,                                  "height");
-            insert(SP_Icon,                                    "icon");
-            insert(SP_IconSize,                                "icon-size");
-            insert(SP_Image,                                   "image");
-            insert(SP_ImagePosition,                           "image-position");
-            insert(SP_Left,                                    "left");
-            insert(SP_LineeditPasswordCharacter,               "lineedit-password-character");
-            insert(SP_LineeditPasswordMaskDelay,               "lineedit-password-mask-delay");
-            insert(SP_Margin,                                  "margin");
-            insert(SP_MarginTop,                               "margin-top");
-            insert(SP_MarginRight,                             "margin-right");
-            insert(SP_MarginBottom,                            "margin-bottom");
-            insert(SP_MarginLeft,                              "margin-left");
-            insert(SP_MaxHeight,                               "max-height");
-            insert(SP_MaxWidth,                                "max-width");
-            insert(SP_MessageboxTextInteractionFlags,          "messagebox-text-interaction-flags");
-            insert(SP_MinHeight,                               "min-height");
-            insert(SP_MinWidth,                                "min-width");
-            insert(SP_Opacity,                                 "opacity");
-            insert(SP_Outline,                                 "outline");
-            insert(SP_OutlineColor,                            "outline-color");
-            insert(SP_OutlineOffset,                           "outline-offset");
-            insert(SP_OutlineStyle,                            "outline-style");
-            insert(SP_OutlineRadius,                           "outline-radius");
-            insert(SP_OutlineBottomLeftRadius,                 "outline-bottom-left-radius");
-            insert(SP_OutlineBottomRightRadius,                "outline-bottom-right-radius");
-            insert(SP_OutlineTopLeftRadius,                    "outline-top-left-radius");
-            insert(SP_OutlineTopRightRadius,                   "outline-top-right-radius");
-            insert(SP_Padding,                                 "padding");
-            insert(SP_PaddingTop,                              "padding-top");
-            insert(SP_PaddingRight,                            "padding-right");
-            insert(SP_PaddingBottom,                           "padding-bottom");
-            insert(SP_PaddingLeft,                             "padding-left");
-            insert(SP_PaintAlternatingRowColorsForEmptyArea,   "paint-alternating-row-colors-for-empty-area");
-            insert(SP_PlaceholderTextColor,                    "placeholder-text-color");
-            insert(SP_Position,                                "position");
-            insert(SP_Right,                                   "right");
-            insert(SP_SelectionBackgroundColor,                "selection-background-color");
-            insert(SP_SelectionColor,                          "selection-color");
-            insert(SP_ShowDecorationSelected,                  "show-decoration-selected");
-            insert(SP_Spacing,                                 "spacing");
-            insert(SP_SubcontrolOrigin,                        "subcontrol-origin");
-            insert(SP_SubcontrolPosition,                      "subcontrol-position");
-            insert(SP_TitlebarShowTooltipsOnButtons,           "titlebar-show-tooltips-on-buttons");
-            insert(SP_WidgetAnimationDuration,                 "widget-animation-duration");
-            insert(SP_TextAlign,                               "text-align");
-            insert(SP_TextDecoration,                          "text-decoration");
-            insert(SP_Top,                                     "top");
-            insert(SP_Width,                                   "width");
-            insert(SP_QtBackgroundRole,                        "-qt-background-role");
-            insert(SP_QtStyleFeatures,                         "-qt-style-features");
-        }
-    };
+    static QString getSubControlString(StyleSheetSubControl subControl) { return subControlName(subControl); }
 
-    class PseudoStateToStringMap : public KANOOP::EnumToStringMap<StyleSheetPseudoState>
-    {
-    public:
-        PseudoStateToStringMap()
-        {
-            insert(PS_Active,               "active");
-            insert(PS_AdjoinsItem,          "adjoins-item");
-            insert(PS_Alternate,            "alternate");
-            insert(PS_Bottom,               "bottom");
-            insert(PS_Checked,              "checked");
-            insert(PS_Closable,             "closable");
-            insert(PS_Closed,               "closed");
-            insert(PS_Default,              "default");
-            insert(PS_Disabled,             "disabled");
-            insert(PS_Editable,             "editable");
-            insert(PS_EditFocus,            "edit-focus");
-            insert(PS_Enabled,              "enabled");
-            insert(PS_Exclusive,            "exclusive");
-            insert(PS_First,                "first");
-            insert(PS_Flat,                 "flat");
-            insert(PS_Floatable,            "floatable");
-            insert(PS_Focus,                "focus");
-            insert(PS_HasChildren,          "has-children");
-            insert(PS_HasSiblings,          "has-siblings");
-            insert(PS_Horizontal,           "horizontal");
-            insert(PS_Hover,                "hover");
-            insert(PS_Indeterminate,        "indeterminate");
-            insert(PS_Last,                 "last");
-            insert(PS_Left,                 "left");
-            insert(PS_Maximized,            "maximized");
-            insert(PS_Middle,               "middle");
-            insert(PS_Minimized,            "minimized");
-            insert(PS_Movable,              "movable");
-            insert(PS_NoFrame,              "no-frame");
-            insert(PS_NonExclusive,         "non-exclusive");
-            insert(PS_Off,                  "off");
-            insert(PS_On,                   "on");
-            insert(PS_OnlyOne,              "only-one");
-            insert(PS_Open,                 "open");
-            insert(PS_NextSelected,         "next-selected");
-            insert(PS_Pressed,              "pressed");
-            insert(PS_PreviousSelected,     "previous-selected");
-            insert(PS_ReadOnly,             "read-only");
-            insert(PS_Right,                "right");
-            insert(PS_Selected,             "selected");
-            insert(PS_Top,                  "top");
-            insert(PS_Unchecked,            "unchecked");
-            insert(PS_Vertical,             "vertical");
-            insert(PS_Window,               "window");
-        }
-    };
+    /**
+     * @brief Return the CSS property name without allocating.
+     * @param property Property enum value
+     * @return View onto the static property name (empty if out of range)
+     */
+    static QLatin1StringView propertyName(StyleSheetProperty property);
 
-    class SubControlToStringMap : public KANOOP::EnumToStringMap<StyleSheetSubControl>
-    {
-    public:
-        SubControlToStringMap()
-        {
-            insert(SC_AddLine,              "add-line");
-            insert(SC_AddPage,              "add-page");
-            insert(SC_Branch,               "branch");
-            insert(SC_Chunk,                "chunk");
-            insert(SC_CloseButton,          "close-button");
-            insert(SC_Corner,               "corner");
-            insert(SC_DownArrow,            "down-arrow");
-            insert(SC_DownButton,           "down-button");
-            insert(SC_DropDown,             "drop-down");
-            insert(SC_FloatButton,          "float-button");
-            insert(SC_Groove,               "groove");
-            insert(SC_Handle,               "handle");
-            insert(SC_Icon,                 "icon");
-            insert(SC_Indicator,            "indicator");
-            insert(SC_Item,                 "item");
-            insert(SC_LeftArrow,            "left-arrow");
-            insert(SC_LeftCorner,           "left-corner");
-            insert(SC_MenuArrow,            "menu-arrow");
-            insert(SC_MenuButton,           "menu-button");
-            insert(SC_MenuIndicator,        "menu-indicator");
-            insert(SC_Pane,                 "pane");
-            insert(SC_RightArrow,           "right-arrow");
-            insert(SC_RightCorner,          "right-corner");
-            insert(SC_Scroller,             "scroller");
-            insert(SC_Section,              "section");
-            insert(SC_Separator,            "separator");
-            insert(SC_SubLine,              "sub-line");
-            insert(SC_SubPage,              "sub-page");
-            insert(SC_Tab,                  "tab");
-            insert(SC_TabBar,               "tab-bar");
-            insert(SC_Tear,                 "tear");
-            insert(SC_TearOff,              "tearoff");
-            insert(SC_Text,                 "text");
-            insert(SC_Title,                "title");
-            insert(SC_UpArrow,              "up-arrow");
-            insert(SC_UpButton,             "up-button");
-        }
-    };
+    /**
+     * @brief Return the CSS pseudo-state name without allocating.
+     * @param pseudoState Pseudo-state enum value
+     * @return View onto the static pseudo-state name (empty for PS_Invalid)
+     */
+    static QLatin1StringView pseudoStateName(StyleSheetPseudoState pseudoState);
 
-    static const PropertyToStringMap _PropertyToStringMap;
-    static const PseudoStateToStringMap _PseudoStateToStringMap;
-    static const SubControlToStringMap _SubControlToStringMap;
+    /**
+     * @brief Return the CSS sub-control name without allocating.
+     * @param subControl Sub-control enum value
+     * @return View onto the static sub-control name (empty for SC_Invalid)
+     */
+    static QLatin1StringView subControlName(StyleSheetSubControl subControl);
 };
 
 #endif // STYLESHEETTYPES_H
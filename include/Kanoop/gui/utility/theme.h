@@ -0,0 +1,181 @@
+#ifndef THEME_H
+#define THEME_H
+
+#include <Kanoop/gui/libkanoopgui.h>
+#include <Kanoop/gui/palette.h>
+#include <Kanoop/gui/utility/stylesheet.h>
+
+#include <QMap>
+#include <QStringList>
+
+/**
+ * @brief Application-wide theme built from a Palette and StyleSheet<T> rules.
+ *
+ * A Theme holds a palette and a set of named widget states (error, warning and
+ * so on), each with a foreground and background color. styleSheet() compiles
+ * every state into one StyleSheet<T> rule per themed widget class (QLabel,
+ * QFrame, QLineEdit, QPushButton, QStatusBar), selected by the StateProperty
+ * dynamic property, and appends any extra rules added with addRule().
+ *
+ * Widgets such as Label and PushButton switch state with setThemeState(), which
+ * goes through setWidgetState() and repolishes only that widget instead of
+ * giving each instance its own stylesheet.
+ *
+ * apply() installs the palette and the compiled sheet with a single repolish
+ * pass and reports how long it took.
+ */
+class LIBKANOOPGUI_EXPORT Theme
+{
+public:
+    /** @brief Construct an empty theme using the default palette. */
+    Theme() {}
+
+    /**
+     * @brief Construct a named theme with a palette.
+     * @param name Theme name
+     * @param palette Application palette for this theme
+     */
+    Theme(const QString& name, const Palette& palette) :
+        _name(name), _palette(palette) {}
+
+    /**
+     * @brief Return the theme name.
+     * @return Theme name
+     */
+    QString name() const { return _name; }
+
+    /**
+     * @brief Set the theme name.
+     * @param value Theme name
+     */
+    void setName(const QString& value) { _name = value; }
+
+    /**
+     * @brief Return the theme palette.
+     * @return Palette installed by apply()
+     */
+    Palette palette() const { return _palette; }
+
+    /**
+     * @brief Set the theme palette.
+     * @param value Palette installed by apply()
+     */
+    void setPalette(const Palette& value) { _palette = value; }
+
+    /**
+     * @brief Set the colors of a named widget state.
+     * @param state State name, matched against the StateProperty of each widget
+     * @param foreground Text color (invalid QColor = unchanged)
+     * @param background Background color (invalid QColor = unchanged)
+     */
+    void setStateColors(const QString& state, const QColor& foreground, const QColor& background = QColor());
+
+    /**
+     * @brief Return the text color of a named widget state.
+     * @param state State name
+     * @return Text color, or an invalid QColor if the state sets none
+     */
+    QColor stateForeground(const QString& state) const { return _states.value(state).foreground; }
+
+    /**
+     * @brief Return the background color of a named widget state.
+     * @param state State name
+     * @return Background color, or an invalid QColor if the state sets none
+     */
+    QColor stateBackground(const QString& state) const { return _states.value(state).background; }
+
+    /**
+     * @brief Return the names of the widget states defined by the theme.
+     * @return State names in sorted order
+     */
+    QStringList states() const { return _states.keys(); }
+
+    /**
+     * @brief Add a typed stylesheet rule to the theme.
+     * @param rule Rule to add
+     */
+    template <typename T>
+    void addRule(const StyleSheet<T>& rule) { addRule(rule.toString()); }
+
+    /**
+     * @brief Add a stylesheet rule to the theme.
+     * @param rule Complete rule text, e.g. "QLabel { color: red }"
+     */
+    void addRule(const QString& rule);
+
+    /**
+     * @brief Return the rules added with addRule().
+     * @return Rules in the order they were added
+     */
+    QStringList rules() const { return _rules; }
+
+    /**
+     * @brief Return the compiled application stylesheet.
+     * The state rules and added rules are compiled once and cached until the theme changes.
+     * @return Compiled stylesheet
+     */
+    QString styleSheet() const;
+
+    /**
+     * @brief Install the palette and compiled stylesheet on the application.
+     *
+     * The palette is installed first, which only propagates palette change
+     * events, and the stylesheet is then set once; that is the single repolish
+     * pass. Nothing is done for parts that are already in effect.
+     * @return Time taken in milliseconds
+     */
+    qint64 apply() const;
+
+    /**
+     * @brief Switch a widget's theme state through a dynamic property.
+     * The widget is repolished only if the value changed.
+     * @param widget Widget to update
+     * @param name Dynamic property name used in the theme's property selectors
+     * @param value New property value
+     * @return true if the value changed
+     */
+    static bool setWidgetState(QWidget* widget, const char* name, const QVariant& value);
+
+    /**
+     * @brief Return a theme with the Fusion light palette and the standard widget states.
+     * @return Light theme
+     */
+    static Theme fusionLight();
+
+    /**
+     * @brief Return a theme with the Fusion dark palette and the standard widget states.
+     * @return Dark theme
+     */
+    static Theme fusionDark();
+
+    /** @brief Dynamic property holding a widget's theme state. */
+    static const char* StateProperty;
+
+    /** @brief Standard state for error text. */
+    static const QString ErrorState;
+    /** @brief Standard state for warning text. */
+    static const QString WarningState;
+    /** @brief Standard state for success text. */
+    static const QString SuccessState;
+    /** @brief Standard state for highlighted widgets. */
+    static const QString HighlightState;
+
+private:
+    class StateColors
+    {
+    public:
+        QColor foreground;
+        QColor background;
+    };
+
+    void compileStateRules(QString& sheet) const;
+
+    QString _name;
+    Palette _palette;
+    QMap<QString, StateColors> _states;
+    QStringList _rules;
+    mutable QString _styleSheet;
+    mutable bool _compiled = false;
+};
+
+#endif // THEME_H
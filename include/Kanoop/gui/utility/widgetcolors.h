@@ -0,0 +1,99 @@
+#ifndef WIDGETCOLORS_H
+#define WIDGETCOLORS_H
+
+#include <Kanoop/gui/libkanoopgui.h>
+#include <QPalette>
+
+class QWidget;
+
+/**
+ * @brief Palette-based foreground and background coloring for widgets.
+ *
+ * Coloring a widget through setStyleSheet() switches it to the style-sheet style
+ * and re-polishes it on every change. Setting the palette instead only triggers
+ * a repaint. Widgets fall back to a generated stylesheet while they use a
+ * property QPalette cannot express, such as a border radius, a border or a
+ * gradient, and while a stylesheet that sets colors is in effect on the widget,
+ * one of its ancestors or qApp (including rules added through Theme). Qt does not
+ * support mixing a palette with such a sheet: the sheet would silently win.
+ * Sheets that set no colors, for example only fonts or margins, do not force the
+ * fallback. The decision is made when a color is set; a stylesheet installed
+ * afterwards does not re-color widgets already colored through their palette.
+ *
+ * applyStyleSheet() records the fallback sheet so clearStyleSheet() can drop it
+ * again once it is no longer needed; stylesheets set by the application are left
+ * alone.
+ */
+class LIBKANOOPGUI_EXPORT WidgetColors
+{
+public:
+    /**
+     * @brief Return whether a widget's colors should be set through its palette.
+     * @param widget Widget about to be colored
+     * @param styleOnlyProperties true if the widget also uses properties QPalette cannot express
+     * @return true if palette mode is enabled, no such property is in use and no
+     * stylesheet that sets colors applies to the widget
+     */
+    static bool usePalette(const QWidget* widget, bool styleOnlyProperties = false);
+
+    /**
+     * @brief Return whether a stylesheet that sets colors applies to a widget.
+     * Checks qApp, the widget's ancestors and the widget itself, ignoring a fallback
+     * sheet set by applyStyleSheet().
+     * @param widget Widget to check
+     * @return true if such a stylesheet is in effect
+     */
+    static bool colorStyleSheetInEffect(const QWidget* widget);
+
+    /**
+     * @brief Apply a generated fallback stylesheet to a widget.
+     * @param widget Widget to style
+     * @param styleSheet Generated stylesheet text
+     * @return true if the widget's stylesheet changed
+     */
+    static bool applyStyleSheet(QWidget* widget, const QString& styleSheet);
+
+    /**
+     * @brief Remove a stylesheet previously set by applyStyleSheet().
+     * A stylesheet the application set on the widget since then is kept.
+     * @param widget Widget to restore to palette coloring
+     * @return true if the widget's stylesheet was cleared
+     */
+    static bool clearStyleSheet(QWidget* widget);
+
+    /**
+     * @brief Set a palette role to a color, or restore the default if the color is invalid.
+     * @param widget Widget to color
+     * @param role Palette role to change (e.g. QPalette::WindowText)
+     * @param color New color; an invalid QColor restores the application default
+     * @return true if the palette changed
+     */
+    static bool setColor(QWidget* widget, QPalette::ColorRole role, const QColor& color);
+
+    /**
+     * @brief Set a background color and enable background filling.
+     * @param widget Widget to color
+     * @param role Palette role used for the background (QPalette::Window or QPalette::Base)
+     * @param color New color; an invalid QColor restores the default and stops filling
+     * @return true if the palette changed
+     */
+    static bool setBackgroundColor(QWidget* widget, QPalette::ColorRole role, const QColor& color);
+
+    /**
+     * @brief Return whether palette coloring is enabled globally.
+     * @return true if enabled (the default)
+     */
+    static bool isPaletteModeEnabled() { return _paletteModeEnabled; }
+
+    /**
+     * @brief Enable or disable palette coloring globally; when disabled widgets use stylesheets.
+     * @param value true to use palettes
+     */
+    static void setPaletteModeEnabled(bool value) { _paletteModeEnabled = value; }
+
+private:
+    static bool _paletteModeEnabled;
+    static const char* FallbackStyleSheetProperty;
+};
+
+#endif // WIDGETCOLORS_H
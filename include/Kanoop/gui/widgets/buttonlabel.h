@@ -81,6 +81,19 @@ public:
      */
     void setBackgroundColor(const QColor& color);
 
+    /**
+     * @brief Switch to a widget state defined by the application Theme.
+     * Only the inner label is repolished; its stylesheet is not touched.
+     * @param state State name such as Theme::ErrorState, or empty for none
+     */
+    void setThemeState(const QString& state);
+
+    /**
+     * @brief Return the current theme state.
+     * @return State name, or empty if none
+     */
+    QString themeState() const;
+
 private:
     void commonInit();
     void makeStyleSheet();
@@ -79,8 +79,21 @@ public:
     /** @brief Reset the background color to the palette default. */
     void setDefaultBackgroundColor();
 
+    /**
+     * @brief Switch to a widget state defined by the application Theme.
+     * Only this widget is repolished; its stylesheet is not touched.
+     * @param state State name such as Theme::ErrorState, or empty for none
+     */
+    void setThemeState(const QString& state);
+
+    /**
+     * @brief Return the current theme state.
+     * @return State name, or empty if none
+     */
+    QString themeState() const;
+
 protected:
-    /** @brief Rebuild and apply the stylesheet from current color properties. */
+    /** @brief Apply the current colors through the palette, or as a fallback stylesheet when palette mode is off. */
     virtual void applyStylesheet();
 
 private:
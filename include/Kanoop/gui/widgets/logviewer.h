@@ -0,0 +1,216 @@
+#ifndef LOGVIEWER_H
+#define LOGVIEWER_H
+#include <QAbstractScrollArea>
+#include <QCache>
+#include <QStringEncoder>
+#include <QTextLayout>
+#include <QTimer>
+#include <Kanoop/utility/loggingbaseclass.h>
+#include <Kanoop/gui/libkanoopgui.h>
+
+/**
+ * @brief Read-only log view that scales to millions of lines.
+ *
+ * LogViewer keeps the UTF-8 text of all lines in one contiguous byte arena and
+ * a fixed-capacity ring of (offset, length, attributes) records, so appending a
+ * line allocates nothing per line. Once maximumLines() is reached the oldest
+ * records are overwritten; their bytes are reclaimed by compacting the arena
+ * once they outweigh the live text. Only the lines inside the viewport are laid
+ * out, and their QTextLayouts are cached so scrolling and repainting do not
+ * re-shape text.
+ *
+ * The append API matches PlainTextEdit. To show a dialog's log output, enable
+ * Dialog::setLogHookEnabled() and pass each batch from Dialog::loggedItems()
+ * to appendLogEntries().
+ *
+ * While following the tail, the view scrolls to each new line; scrolling up
+ * stops following and scrolling back to the bottom resumes it.
+ */
+class LIBKANOOPGUI_EXPORT LogViewer : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief Construct with an optional parent.
+     * @param parent Optional QWidget parent
+     */
+    explicit LogViewer(QWidget* parent = nullptr);
+
+    /**
+     * @brief Flags controlling text formatting for appendFormattedText().
+     */
+    enum TextFlag
+    {
+        NoTextFlags     = 0x0000,   ///< No formatting
+        BoldText        = 0x0001,   ///< Render text in bold
+        StrongText      = 0x0002,   ///< Render text in bold (same as BoldText)
+    };
+    Q_DECLARE_FLAGS(TextFlags, TextFlag)
+
+    /**
+     * @brief Append a line of text with optional per-call colors.
+     * Text containing newlines is split into several lines.
+     * @param text Text to append
+     * @param foregroundColor Text color (invalid QColor = default)
+     * @param backgroundColor Background color (invalid QColor = default)
+     */
+    void appendText(const QString& text, const QColor& foregroundColor = QColor(), const QColor& backgroundColor = QColor());
+
+    /**
+     * @brief Append a formatted line of text with flags and optional colors.
+     * @param text Text to append
+     * @param flags Combination of TextFlag values
+     * @param foregroundColor Text color (invalid QColor = default)
+     * @param backgroundColor Background color (invalid QColor = default)
+     */
+    void appendFormattedText(const QString& text, TextFlags flags, const QColor& foregroundColor = QColor(), const QColor& backgroundColor = QColor());
+
+    /**
+     * @brief Append a log entry using the color assigned to its level.
+     * @param entry Log entry, e.g. as delivered to Dialog::loggedItem()
+     */
+    void appendLogEntry(const Log::LogEntry& entry);
+
+    /**
+     * @brief Append a batch of log entries using the colors assigned to their levels.
+     * @param entries Log entries, e.g. as delivered to Dialog::loggedItems()
+     */
+    void appendLogEntries(const QList<Log::LogEntry>& entries);
+
+    /**
+     * @brief Set the text color used by appendLogEntry() for a log level.
+     * @param level Log level
+     * @param color Text color (invalid QColor = default)
+     */
+    void setLevelColor(Log::LogLevel level, const QColor& color) { _levelColors.insert(level, color); }
+
+    /** @brief Remove all lines. */
+    void clear();
+
+    /**
+     * @brief Return the number of lines currently held.
+     * @return Line count
+     */
+    int lineCount() const { return _count; }
+
+    /**
+     * @brief Return the text of a line.
+     * @param index Line index, 0 being the oldest line held
+     * @return Line text (empty if out of range)
+     */
+    QString lineText(int index) const;
+
+    /**
+     * @brief Return the capacity of the ring buffer.
+     * @return Maximum number of lines kept
+     */
+    int maximumLines() const { return _capacity; }
+
+    /**
+     * @brief Set the capacity of the ring buffer, keeping the newest lines.
+     * @param value Maximum number of lines kept
+     */
+    void setMaximumLines(int value);
+
+    /**
+     * @brief Return whether the view scrolls to new lines as they arrive.
+     * @return true if following the tail
+     */
+    bool isFollowingTail() const { return _followTail; }
+
+    /**
+     * @brief Start or stop following new lines.
+     * @param value true to scroll to the end now and on every append
+     */
+    void setFollowTail(bool value);
+
+    /**
+     * @brief Search for text and scroll to the matching line.
+     *
+     * The search starts after (or before, when searching backward) the line
+     * found by the previous call and wraps around once. Case-sensitive searches
+     * run directly on the stored UTF-8 bytes.
+     * @param text Text to search for
+     * @param backward true to search towards older lines
+     * @param cs Case sensitivity
+     * @return Index of the matching line, or -1 if not found
+     */
+    int find(const QString& text, bool backward = false, Qt::CaseSensitivity cs = Qt::CaseInsensitive);
+
+    /**
+     * @brief Return the line highlighted by the last successful find().
+     * @return Line index, or -1 if there is none
+     */
+    int currentMatch() const;
+
+    /**
+     * @brief Scroll so the given line is visible.
+     * @param index Line index
+     */
+    void scrollToLine(int index);
+
+    /** @brief Default ring buffer capacity. */
+    static const int DefaultMaximumLines = 1000000;
+
+protected:
+    virtual void paintEvent(QPaintEvent* event) override;
+    virtual void resizeEvent(QResizeEvent* event) override;
+    virtual void changeEvent(QEvent* event) override;
+    virtual void scrollContentsBy(int dx, int dy) override;
+
+private:
+    class LineRecord
+    {
+    public:
+        qsizetype offset = 0;
+        int length = 0;
+        QRgb foreground = 0;
+        QRgb background = 0;
+        quint16 flags = 0;
+    };
+
+    /** Attribute bits stored in LineRecord::flags */
+    enum LineAttribute
+    {
+        IsBold          = 0x0001,
+        HasForeground   = 0x0002,
+        HasBackground   = 0x0004,
+    };
+
+    void appendLine(QStringView text, TextFlags flags, const QColor& foregroundColor, const QColor& backgroundColor);
+    const LineRecord& lineAt(int index) const { return _lines.at((_head + index) % _capacity); }
+    QByteArray lineBytes(const LineRecord& line) const { return QByteArray::fromRawData(_arena.constData() + line.offset, line.length); }
+    bool lineMatches(const LineRecord& line, const QString& text, const QByteArray& utf8, Qt::CaseSensitivity cs) const;
+    void compactArena();
+    void shiftScrollPosition(int lines);
+    QTextLayout* layoutFor(int index);
+    int lineHeight() const;
+    void updateScrollBars();
+    void scheduleUpdate();
+
+    QByteArray _arena;
+    qsizetype _deadBytes = 0;
+    QStringEncoder _encoder;
+    QList<LineRecord> _lines;
+    int _capacity = DefaultMaximumLines;
+    int _head = 0;
+    int _count = 0;
+
+    quint64 _firstSequence = 0;
+    qint64 _matchSequence = -1;
+
+    bool _followTail = true;
+    int _maxLineWidth = 0;
+
+    QMap<Log::LogLevel, QColor> _levelColors;
+    QCache<quint64, QTextLayout> _layouts;
+    QTimer _updateTimer;
+
+private slots:
+    void onUpdateTimer();
+    void onVerticalScroll(int value);
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(LogViewer::TextFlags)
+
+#endif // LOGVIEWER_H
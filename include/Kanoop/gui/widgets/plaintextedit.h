@@ -2,6 +2,8 @@
 #define PLAINTEXTEDIT_H
 
 #include <QPlainTextEdit>
+#include <QTextCharFormat>
+#include <QTimer>
 #include <Kanoop/gui/libkanoopgui.h>
 
 /**
@@ -10,6 +12,18 @@
  * PlainTextEdit adds appendText() for appending plain text with optional
  * per-call foreground and background colors, and appendFormattedText() which
  * additionally accepts TextFlags for bold/strong formatting.
+ *
+ * In log mode (setLogModeEnabled()) appended lines are queued instead of being
+ * converted to HTML. The queue is flushed once per frame through a single
+ * QTextCursor edit block using cached QTextCharFormats, the document is trimmed
+ * to maximumLogBlocks() in batches, and the view only follows new output while
+ * it is scrolled to the bottom.
+ *
+ * appendPlainText() and appendHtml() hide the non-virtual QPlainTextEdit slots of
+ * the same name so that they flush the queue first. Calls made through a
+ * QPlainTextEdit pointer, or connections to the base class slots, bypass that
+ * flush and land ahead of any queued lines; call flushPendingLines() first in
+ * that case.
  */
 class LIBKANOOPGUI_EXPORT PlainTextEdit : public QPlainTextEdit
 {
@@ -19,16 +33,14 @@ public:
      * @brief Construct with an optional parent.
      * @param parent Optional QWidget parent
      */
-    explicit PlainTextEdit(QWidget *parent = nullptr) :
-        QPlainTextEdit(parent) {}
+    explicit PlainTextEdit(QWidget *parent = nullptr);
 
     /**
      * @brief Construct with initial text content.
      * @param text Initial plain text
      * @param parent Optional QWidget parent
      */
-    explicit PlainTextEdit(const QString& text, QWidget *parent = nullptr) :
-        QPlainTextEdit(text, parent) {}
+    explicit PlainTextEdit(const QString& text, QWidget *parent = nullptr);
 
     /**
      * @brief Flags controlling text formatting for appendFormattedText().
@@ -57,6 +69,121 @@ public:
      * @param backgroundColor Background color (invalid QColor = default)
      */
     void appendFormattedText(const QString& text, TextFlags flags, const QColor& foregroundColor = QColor(), const QColor& backgroundColor = QColor());
+
+    /**
+     * @brief Return whether appended lines are queued and flushed in batches.
+     * @return true if log mode is enabled
+     */
+    bool isLogModeEnabled() const { return _logMode; }
+
+    /**
+     * @brief Enable or disable batched log mode.
+     * Enabling turns off undo/redo for the document. Disabling flushes any queued lines
+     * and restores the undo/redo setting the document had before.
+     * @param enabled true to queue appended lines and flush them once per frame
+     */
+    void setLogModeEnabled(bool enabled);
+
+    /**
+     * @brief Return the maximum number of blocks kept in log mode.
+     * @return Maximum block count (0 = unlimited)
+     */
+    int maximumLogBlocks() const { return _maximumLogBlocks; }
+
+    /**
+     * @brief Set the maximum number of blocks kept in log mode.
+     *
+     * Old blocks are removed from the top once the document exceeds the limit by
+     * about a tenth, so trimming happens in batches rather than on every line.
+     * @param value Maximum block count (0 = unlimited)
+     */
+    void setMaximumLogBlocks(int value) { _maximumLogBlocks = value; }
+
+    /**
+     * @brief Return the interval at which queued lines are flushed in log mode.
+     * @return Flush interval in milliseconds
+     */
+    int flushInterval() const { return _flushTimer.interval(); }
+
+    /**
+     * @brief Set the interval at which queued lines are flushed in log mode.
+     * @param ms Flush interval in milliseconds
+     */
+    void setFlushInterval(int ms) { _flushTimer.setInterval(ms); }
+
+    /**
+     * @brief Return the number of lines queued but not yet written to the document.
+     * @return Pending line count
+     */
+    int pendingLineCount() const { return _pendingLines.count(); }
+
+    /**
+     * @brief Return whether the vertical scroll bar is at its maximum.
+     * @return true if the view shows the end of the document
+     */
+    bool isPinnedToBottom() const;
+
+    /** @brief Default flush interval in log mode, about one frame at 60 Hz. */
+    static const int DefaultFlushInterval = 16;
+
+public slots:
+    /** @brief Write all queued log lines to the document immediately. */
+    void flushPendingLines();
+
+    /**
+     * @brief Append a paragraph of plain text after any queued log lines.
+     * Hides QPlainTextEdit::appendPlainText(), which is not virtual.
+     * @param text Plain text to append
+     */
+    void appendPlainText(const QString& text);
+
+    /**
+     * @brief Append a paragraph of HTML after any queued log lines.
+     * Hides QPlainTextEdit::appendHtml(), which is not virtual.
+     * @param html HTML to append
+     */
+    void appendHtml(const QString& html);
+
+private:
+    void commonInit();
+    int trimLogBlocks();
+    QTextCharFormat logFormat(TextFlags flags, const QColor& foregroundColor, const QColor& backgroundColor);
+
+    class PendingLine
+    {
+    public:
+        PendingLine() {}
+        PendingLine(const QString& text, TextFlags flags, const QColor& foregroundColor, const QColor& backgroundColor) :
+            text(text), flags(flags), foregroundColor(foregroundColor), backgroundColor(backgroundColor) {}
+
+        QString text;
+        TextFlags flags;
+        QColor foregroundColor;
+        QColor backgroundColor;
+    };
+
+    class FormatKey
+    {
+    public:
+        FormatKey(TextFlags flags, const QColor& foregroundColor, const QColor& backgroundColor) :
+            foreground(foregroundColor.isValid() ? foregroundColor.rgba() : 0),
+            background(backgroundColor.isValid() ? backgroundColor.rgba() : 0),
+            flags(int(flags) | (foregroundColor.isValid() ? 0x100 : 0) | (backgroundColor.isValid() ? 0x200 : 0)) {}
+
+        bool operator==(const FormatKey& other) const { return foreground == other.foreground && background == other.background && flags == other.flags; }
+        friend size_t qHash(const FormatKey& key, size_t seed = 0) { return qHashMulti(seed, key.foreground, key.background, key.flags); }
+
+        QRgb foreground;
+        QRgb background;
+        int flags;
+    };
+
+    bool _logMode = false;
+    bool _undoRedoWasEnabled = true;
+    int _maximumLogBlocks = 0;
+    QList<PendingLine> _pendingLines;
+    QHash<FormatKey, QTextCharFormat> _logFormats;
+    QTimer _flushTimer;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(PlainTextEdit::TextFlags)
@@ -5,10 +5,12 @@
 #include <Kanoop/gui/libkanoopgui.h>
 
 /**
- * @brief QPushButton subclass with stylesheet-based color and font customization.
+ * @brief QPushButton subclass with color and font customization.
  *
  * PushButton extends QPushButton to provide programmatic control over foreground,
- * background, hover, pressed, and disabled state colors via Qt stylesheets.
+ * background, hover, pressed, and disabled state colors. Foreground, background
+ * and disabled colors go through the palette; a per-button stylesheet is only
+ * generated while hover or pressed colors or a border radius are in use.
  * It also offers convenience methods for font size, weight, and style changes.
  */
 class LIBKANOOPGUI_EXPORT PushButton : public QPushButton
@@ -58,10 +60,15 @@ public:
     /** @brief Set the background color when the button is disabled. */
     void setDisabledBackgroundColor(const QColor& color);
 
+    /** @brief Switch to a widget state defined by the application Theme; only this button is repolished. */
+    void setThemeState(const QString& state);
+    /** @brief Get the current theme state (empty if none). */
+    QString themeState() const;
+
 public slots:
-    /** @brief Set the foreground (text) color and rebuild the stylesheet. */
+    /** @brief Set the foreground (text) color. */
     void setForegroundColor(const QColor& color);
-    /** @brief Set the background color and rebuild the stylesheet. */
+    /** @brief Set the background color. */
     void setBackgroundColor(const QColor& color);
     /** @brief Reset the foreground color to the palette default. */
     void setDefaultForegroundColor();
@@ -81,6 +88,8 @@ private:
     QColor _disabledForegroundColor;
     QColor _disabledBackgroundColor;
     int    _borderRadius = 0;
+    bool   _foregroundExplicitlySet = false;
+    bool   _backgroundExplicitlySet = false;
 };
 
 #endif // PUSHBUTTON_H
@@ -0,0 +1,147 @@
+#include "cachingitemdelegate.h"
+
+#include <QAbstractProxyModel>
+#include <QPainter>
+
+CachingItemDelegate::CachingItemDelegate(QObject* parent) :
+    QStyledItemDelegate(parent),
+    _cache(DefaultMaxCacheCost)
+{
+    _statisticsTimer.setSingleShot(true);
+    _statisticsTimer.setInterval(DefaultStatisticsInterval);
+    connect(&_statisticsTimer, &QTimer::timeout, this, &CachingItemDelegate::onStatisticsTimer);
+}
+
+void CachingItemDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    if(option.rect.isEmpty() || isCacheable(index) == false) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    // Key on the source cell so that sorting and filtering in a proxy do not defeat the cache
+    QModelIndex sourceIndex = index;
+    const QAbstractProxyModel* proxyModel;
+    while((proxyModel = qobject_cast<const QAbstractProxyModel*>(sourceIndex.model())) != nullptr) {
+        sourceIndex = proxyModel->mapToSource(sourceIndex);
+    }
+    if(sourceIndex.model() != _watchedModel) {
+        watchModel(sourceIndex.model());
+    }
+
+    CacheKey key;
+    key.cell = CellKey(sourceIndex);
+    key.width = option.rect.width();
+    key.height = option.rect.height();
+    key.state = (option.state & _cacheStateMask).toInt();
+    key.devicePixelRatio = painter->device()->devicePixelRatioF();
+    key.epoch = _epoch;
+    key.cellRevision = _cellRevisions.value(key.cell, 0);
+    key.userRevision = dataRevision(index);
+
+    if(_statisticsTimer.isActive() == false) {
+        _statisticsTimer.start();
+    }
+
+    QPixmap* pixmap = _cache.object(key);
+    if(pixmap != nullptr) {
+        _hits++;
+        painter->drawPixmap(option.rect.topLeft(), *pixmap);
+        return;
+    }
+    _misses++;
+
+    pixmap = new QPixmap(option.rect.size() * key.devicePixelRatio);
+    pixmap->setDevicePixelRatio(key.devicePixelRatio);
+    pixmap->fill(Qt::transparent);
+    {
+        QPainter pixmapPainter(pixmap);
+        QStyleOptionViewItem opt(option);
+        opt.rect = QRect(QPoint(0, 0), option.rect.size());
+        paintCell(&pixmapPainter, opt, index);
+    }
+    painter->drawPixmap(option.rect.topLeft(), *pixmap);
+
+    int cost = qMax(1, static_cast<int>(static_cast<qint64>(pixmap->width()) * pixmap->height() * pixmap->depth() / 8 / 1024));
+    _cache.insert(key, pixmap, cost);
+}
+
+double CachingItemDelegate::hitRate() const
+{
+    quint64 total = _hits + _misses;
+    return total > 0 ? static_cast<double>(_hits) / static_cast<double>(total) : 0;
+}
+
+void CachingItemDelegate::resetStatistics()
+{
+    _hits = 0;
+    _misses = 0;
+}
+
+void CachingItemDelegate::invalidate()
+{
+    _cache.clear();
+    _cellRevisions.clear();
+    _epoch++;
+}
+
+void CachingItemDelegate::paintCell(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+    QStyledItemDelegate::paint(painter, option, index);
+}
+
+void CachingItemDelegate::watchModel(const QAbstractItemModel* model) const
+{
+    CachingItemDelegate* self = const_cast<CachingItemDelegate*>(this);
+    if(_watchedModel != nullptr) {
+        disconnect(_watchedModel.data(), nullptr, self, nullptr);
+    }
+
+    self->invalidate();
+    _watchedModel = model;
+    if(model == nullptr) {
+        return;
+    }
+
+    connect(model, &QAbstractItemModel::dataChanged, self, &CachingItemDelegate::onModelDataChanged);
+    // Structural changes shift the rows and columns we key on
+    connect(model, &QAbstractItemModel::modelReset, self, &CachingItemDelegate::invalidate);
+    connect(model, &QAbstractItemModel::layoutChanged, self, &CachingItemDelegate::invalidate);
+    connect(model, &QAbstractItemModel::rowsInserted, self, &CachingItemDelegate::invalidate);
+    connect(model, &QAbstractItemModel::rowsRemoved, self, &CachingItemDelegate::invalidate);
+    connect(model, &QAbstractItemModel::rowsMoved, self, &CachingItemDelegate::invalidate);
+    connect(model, &QAbstractItemModel::columnsInserted, self, &CachingItemDelegate::invalidate);
+    connect(model, &QAbstractItemModel::columnsRemoved, self, &CachingItemDelegate::invalidate);
+    connect(model, &QAbstractItemModel::columnsMoved, self, &CachingItemDelegate::invalidate);
+}
+
+void CachingItemDelegate::onModelDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    if(topLeft.isValid() == false || bottomRight.isValid() == false) {
+        invalidate();
+        return;
+    }
+
+    qint64 cellCount = static_cast<qint64>(bottomRight.row() - topLeft.row() + 1) * (bottomRight.column() - topLeft.column() + 1);
+    if(cellCount > MaxTrackedCellChanges || _cellRevisions.count() + cellCount > MaxTrackedCellChanges * 16) {
+        // Cheaper to start over than to track every changed cell
+        invalidate();
+        return;
+    }
+
+    // Bumping the revision orphans the stale pixmaps, which then age out of the LRU cache
+    const QAbstractItemModel* model = topLeft.model();
+    QModelIndex parentIndex = topLeft.parent();
+    for(int row = topLeft.row();row <= bottomRight.row();row++) {
+        for(int col = topLeft.column();col <= bottomRight.column();col++) {
+            _cellRevisions[CellKey(model->index(row, col, parentIndex))]++;
+        }
+    }
+}
+
+void CachingItemDelegate::onStatisticsTimer()
+{
+    emit cacheStatistics(hitRate(), _hits, _misses);
+}
+
+#include "Kanoop/gui/moc_cachingitemdelegate.cpp"
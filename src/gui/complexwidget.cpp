@@ -7,6 +7,8 @@
 #include <QSpinBox>
 #include <QSplitter>
 #include "guisettings.h"
+#include "lazystaterestorer.h"
+#include "utility/fontscaler.h"
 
 ComplexWidget::ComplexWidget(QWidget *parent) :
     QWidget(parent),
@@ -33,7 +35,7 @@ void ComplexWidget::initializeBase()
 
     if(GuiSettings::globalInstance() != nullptr) {
         for(QSplitter* splitter : findChildren<QSplitter*>()) {
-            GuiSettings::globalInstance()->restoreLastSplitterState(splitter);
+            LazyStateRestorer::instance()->registerSplitter(splitter);
             connect(splitter, &QSplitter::splitterMoved, this, &ComplexWidget::onSplitterMoved);
         }
     }
@@ -50,11 +52,7 @@ void ComplexWidget::connectValidationSignals()
 
 void ComplexWidget::restorePersistedSettings()
 {
-    if(GuiSettings::globalInstance() != nullptr) {
-        for(QSplitter* splitter : findChildren<QSplitter*>()) {
-            GuiSettings::globalInstance()->restoreLastSplitterState(splitter);
-        }
-    }
+    LazyStateRestorer::instance()->registerSplitters(this);
 }
 
 void ComplexWidget::connectLineEditSignals()
@@ -94,14 +92,7 @@ void ComplexWidget::connectSpinBoxSignals()
 
 void ComplexWidget::onPreferencesChanged()
 {
-    if(GuiSettings::globalInstance() == nullptr) {
-        return;
-    }
-
-    QFont newFont(font());
-    int pointSize = GuiSettings::globalInstance()->fontSize();
-    newFont.setPointSize(pointSize);
-    setFont(newFont);
+    FontScaler::applyPreferredPointSize(this);
 }
 
 void ComplexWidget::onObjectNameChanged()
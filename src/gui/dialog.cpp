@@ -10,11 +10,15 @@
 ******************************************************************************************/
 #include "dialog.h"
 #include "guisettings.h"
+#include "lazystaterestorer.h"
+#include "logentryqueue.h"
+#include "utility/fontscaler.h"
 #include <QLayout>
 #include <QMoveEvent>
 #include <QPushButton>
 #include <QResizeEvent>
 #include <QShowEvent>
+#include <QHideEvent>
 #include <QTimer>
 
 #include <QCheckBox>
@@ -69,6 +73,9 @@ void Dialog::commonInit()
     _statusBar->setVisible(false);
     _statusBar->setMaximumHeight(_statusBar->height());
 
+    _logDrainTimer.setInterval(DefaultLogHookInterval);
+    connect(&_logDrainTimer, &QTimer::timeout, this, &Dialog::onLogDrainTimer);
+
     Dialog::onPreferencesChanged();
 }
 
@@ -150,11 +157,17 @@ void Dialog::setButtonBoxButtons()
 
 void Dialog::closeLogConsumer()
 {
+    _logDrainTimer.stop();
     if(_logConsumer != nullptr) {
+        // removeConsumer() stops further dispatch to the consumer. An entry already being
+        // delivered on a logging thread still finds its queue, because the connection holds
+        // a reference to it. deleteLater() only defers deleting the consumer to this thread's
+        // event loop; it does not wait for such a delivery to return.
         Log::removeConsumer(_logConsumer);
-        delete _logConsumer;
+        _logConsumer->deleteLater();
         _logConsumer = nullptr;
     }
+    _logQueue.reset();
 }
 
 void Dialog::setValid(bool value)
@@ -197,15 +210,39 @@ void Dialog::setLogHookEnabled(bool enabled)
 {
     if(enabled) {
         closeLogConsumer();
+        _logQueue.reset(new LogEntryQueue(_logHookCapacity));
+        _logQueue->setLevels(_logHookLevels);
+        _droppedLogEntries = 0;
+
+        // Queue on the logging thread; entries reach the GUI thread in batches from the drain timer
         _logConsumer = new LogConsumer;
-        connect(_logConsumer, &LogConsumer::logEntry, this, &Dialog::onLoggedItem);
+        QSharedPointer<LogEntryQueue> queue = _logQueue;
+        connect(_logConsumer, &LogConsumer::logEntry, _logConsumer, [queue](const Log::LogEntry& entry) {
+            queue->enqueue(entry);
+        }, Qt::DirectConnection);
         Log::addConsumer(_logConsumer);
+        _logDrainTimer.start();
     }
     else {
         closeLogConsumer();
     }
 }
 
+void Dialog::setLogHookLevels(const QList<Log::LogLevel>& levels)
+{
+    _logHookLevels = levels;
+    if(_logQueue.isNull() == false) {
+        _logQueue->setLevels(levels);
+    }
+}
+
+void Dialog::loggedItems(const QList<Log::LogEntry>& entries)
+{
+    for(const Log::LogEntry& entry : entries) {
+        loggedItem(entry);
+    }
+}
+
 void Dialog::connectValidationSignals()
 {
     connectLineEditSignals();
@@ -234,7 +271,7 @@ void Dialog::moveEvent(QMoveEvent *event)
 {
     // logText(LVL_DEBUG, QString("%1 - move to %2").arg(objectName()).arg(Point(event->pos()).toString()));
     if(_formLoadComplete && _persistPosition) {
-        GuiSettings::globalInstance()->setLastWindowPosition(this, event->pos());
+        GuiSettings::globalInstance()->recordWindowPosition(this, event->pos());
     }
     QDialog::moveEvent(event);
 }
@@ -243,7 +280,7 @@ void Dialog::resizeEvent(QResizeEvent *event)
 {
     // logText(LVL_DEBUG, QString("%1 - resize to %2").arg(objectName()).arg(Size(event->size()).toString()));
     if(_formLoadComplete && isVisible() && _persistSize) {
-        GuiSettings::globalInstance()->setLastWindowSize(this, event->size());
+        GuiSettings::globalInstance()->recordWindowSize(this, event->size());
     }
     QDialog::resizeEvent(event);
 }
@@ -289,6 +326,9 @@ void Dialog::showEvent(QShowEvent *event)
             if(_persistPosition) {
                 move(restorePos);
             }
+            if(_persistSize && GuiSettings::globalInstance()->getLastWindowMaximized(this)) {
+                setWindowState(windowState() | Qt::WindowMaximized);
+            }
         }
         _formLoadComplete = true;
         if(_formLoadFailed) {
@@ -309,7 +349,7 @@ void Dialog::performLayout()
 
     if(GuiSettings::globalInstance() != nullptr) {
         for(QSplitter* splitter : findChildren<QSplitter*>()) {
-            GuiSettings::globalInstance()->restoreLastSplitterState(splitter);
+            LazyStateRestorer::instance()->registerSplitter(splitter);
             connect(splitter, &QSplitter::splitterMoved, this, &Dialog::onSplitterMoved);
         }
     }
@@ -330,15 +370,17 @@ void Dialog::enableAppropriateButtons()
     }
 }
 
-void Dialog::onPreferencesChanged()
+void Dialog::hideEvent(QHideEvent* event)
 {
-    if(GuiSettings::globalInstance() == nullptr) {
-        return;
+    if(GuiSettings::globalInstance() != nullptr) {
+        GuiSettings::globalInstance()->flush();
     }
+    QDialog::hideEvent(event);
+}
 
-    QFont newFont(font());
-    newFont.setPointSize(GuiSettings::globalInstance()->fontSize());
-    setFont(newFont);
+void Dialog::onPreferencesChanged()
+{
+    FontScaler::applyPreferredPointSize(this);
 }
 
 void Dialog::stringChanged(const QString &)
@@ -361,9 +403,23 @@ void Dialog::voidChanged()
     enableAppropriateButtons();
 }
 
-void Dialog::onLoggedItem(const Log::LogEntry& entry)
+void Dialog::onLogDrainTimer()
 {
-    loggedItem(entry);
+    if(_logQueue.isNull()) {
+        return;
+    }
+
+    int dropped = _logQueue->takeDroppedCount();
+    if(dropped > 0) {
+        _droppedLogEntries += dropped;
+        logEntriesDropped(dropped);
+    }
+
+    // Bound the work per tick to what could have been queued since the last one
+    QList<Log::LogEntry> entries = _logQueue->drain(_logQueue->capacity());
+    if(entries.isEmpty() == false) {
+        loggedItems(entries);
+    }
 }
 
 void Dialog::onSplitterMoved()
@@ -1,4 +1,5 @@
 #include "ellipsegraphicsitem.h"
+#include "graphics/graphicsscene.h"
 
 #include <QPen>
 
@@ -6,6 +7,14 @@ EllipseGraphicsItem::EllipseGraphicsItem(int type, QGraphicsItem* parent) :
     QGraphicsEllipseItem(parent),
     _type(type)
 {
+    if(scene() != nullptr) {
+        GraphicsScene::updateRegistration(this, nullptr, scene());
+    }
+}
+
+EllipseGraphicsItem::~EllipseGraphicsItem()
+{
+    GraphicsScene::updateRegistration(this, scene(), nullptr);
 }
 
 void EllipseGraphicsItem::setWidth(double width)
@@ -21,3 +30,11 @@ void EllipseGraphicsItem::setColor(const QColor& color)
     pen.setColor(color);
     setPen(pen);
 }
+
+QVariant EllipseGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+    if(change == ItemSceneChange) {
+        GraphicsScene::updateRegistration(this, scene(), value.value<QGraphicsScene*>());
+    }
+    return QGraphicsEllipseItem::itemChange(change, value);
+}
@@ -6,4 +6,137 @@ GraphicsScene::GraphicsScene(QObject* parent) :
 {
 }
 
+GraphicsScene::~GraphicsScene()
+{
+    // Items unregister themselves as they are deleted, which must happen before the registry goes away
+    clear();
+}
+
+void GraphicsScene::registerItem(QGraphicsItem* item)
+{
+    int type = item->type();
+    _itemsByType[type].insert(item);
+
+    auto it = _levelsOfDetail.find(type);
+    if(it != _levelsOfDetail.end() && it->culled && item != it->proxy && item->isVisibleTo(item->parentItem())) {
+        item->setVisible(false);
+        it->hidden.insert(item);
+    }
+}
+
+void GraphicsScene::unregisterItem(QGraphicsItem* item)
+{
+    auto bucket = _itemsByType.find(item->type());
+    if(bucket == _itemsByType.end() || bucket->contains(item) == false) {
+        // type() may answer differently while a subclass is being destroyed
+        for(bucket = _itemsByType.begin();bucket != _itemsByType.end();++bucket) {
+            if(bucket->contains(item)) {
+                break;
+            }
+        }
+    }
+    for(LevelOfDetail& lod : _levelsOfDetail) {
+        lod.hidden.remove(item);
+    }
+    if(bucket != _itemsByType.end()) {
+        bucket->remove(item);
+        if(bucket->isEmpty()) {
+            _itemsByType.erase(bucket);
+        }
+    }
+}
+
+void GraphicsScene::updateRegistration(QGraphicsItem* item, QGraphicsScene* oldScene, QGraphicsScene* newScene)
+{
+    if(oldScene == newScene) {
+        return;
+    }
+    GraphicsScene* scene = qobject_cast<GraphicsScene*>(oldScene);
+    if(scene != nullptr) {
+        scene->unregisterItem(item);
+    }
+    scene = qobject_cast<GraphicsScene*>(newScene);
+    if(scene != nullptr) {
+        scene->registerItem(item);
+    }
+}
+
+void GraphicsScene::setLevelOfDetail(int type, double minimumScale, QGraphicsItem* proxy)
+{
+    auto existing = _levelsOfDetail.find(type);
+    if(existing != _levelsOfDetail.end() && existing->proxy == proxy) {
+        // Reused proxy: detach it so clearing the old rule does not delete it
+        existing->proxy = nullptr;
+    }
+    clearLevelOfDetail(type);
+
+    LevelOfDetail lod;
+    lod.minimumScale = minimumScale;
+    lod.proxy = proxy;
+    if(proxy != nullptr) {
+        proxy->setVisible(false);
+        if(proxy->scene() != this) {
+            addItem(proxy);
+        }
+    }
+    applyLevelOfDetail(type, lod, _levelOfDetailScale < minimumScale);
+    _levelsOfDetail.insert(type, lod);
+}
+
+void GraphicsScene::clearLevelOfDetail(int type)
+{
+    auto it = _levelsOfDetail.find(type);
+    if(it == _levelsOfDetail.end()) {
+        return;
+    }
+
+    applyLevelOfDetail(type, *it, false);
+    if(it->proxy != nullptr) {
+        delete it->proxy;
+    }
+    _levelsOfDetail.erase(it);
+}
+
+void GraphicsScene::setLevelOfDetailScale(double scale)
+{
+    _levelOfDetailScale = scale;
+    for(auto it = _levelsOfDetail.begin();it != _levelsOfDetail.end();++it) {
+        applyLevelOfDetail(it.key(), it.value(), scale < it->minimumScale);
+    }
+}
+
+void GraphicsScene::applyLevelOfDetail(int type, LevelOfDetail& lod, bool culled)
+{
+    if(culled == lod.culled) {
+        return;
+    }
+
+    lod.culled = culled;
+    int count = 0;
+    if(culled) {
+        // Items the application already hid are left out so restoring does not show them
+        const QSet<QGraphicsItem*> items = _itemsByType.value(type);
+        for(QGraphicsItem* item : items) {
+            if(item != lod.proxy && item->isVisibleTo(item->parentItem())) {
+                item->setVisible(false);
+                lod.hidden.insert(item);
+            }
+        }
+        count = lod.hidden.count();
+    }
+    else {
+        QSet<QGraphicsItem*> hidden;
+        hidden.swap(lod.hidden);
+        count = hidden.count();
+        for(QGraphicsItem* item : hidden) {
+            item->setVisible(true);
+        }
+    }
+    if(lod.proxy != nullptr) {
+        lod.proxy->setVisible(culled);
+    }
+    logText(LVL_DEBUG, QString("Level of detail for type %1 at scale %2: %3 %4 items")
+            .arg(type).arg(_levelOfDetailScale).arg(culled ? "culled" : "restored").arg(count));
+}
+
 #include "Kanoop/gui/graphics/moc_graphicsscene.cpp"
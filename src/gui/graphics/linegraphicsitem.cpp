@@ -1,4 +1,5 @@
 #include "linegraphicsitem.h"
+#include "graphics/graphicsscene.h"
 
 #include <QPen>
 
@@ -8,12 +9,25 @@ LineGraphicsItem::LineGraphicsItem(int type, QGraphicsItem* parent) :
     QGraphicsLineItem(parent),
     _type(type)
 {
+    // Added to the parent's scene by the base constructor, where itemChange() is not yet ours
+    if(scene() != nullptr) {
+        GraphicsScene::updateRegistration(this, nullptr, scene());
+    }
 }
 
 LineGraphicsItem::LineGraphicsItem(const Line& line, int type, QGraphicsItem* parent) :
     QGraphicsLineItem(line.toQLineF(), parent),
     _type(type)
 {
+    // Added to the parent's scene by the base constructor, where itemChange() is not yet ours
+    if(scene() != nullptr) {
+        GraphicsScene::updateRegistration(this, nullptr, scene());
+    }
+}
+
+LineGraphicsItem::~LineGraphicsItem()
+{
+    GraphicsScene::updateRegistration(this, scene(), nullptr);
 }
 
 void LineGraphicsItem::setWidth(double width)
@@ -51,3 +65,11 @@ void LineGraphicsItem::setLength(double length)
     line.setP2(Point(line.p1().x(), length - 1));
     setLine(line.toQLineF());
 }
+
+QVariant LineGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+    if(change == ItemSceneChange) {
+        GraphicsScene::updateRegistration(this, scene(), value.value<QGraphicsScene*>());
+    }
+    return QGraphicsLineItem::itemChange(change, value);
+}
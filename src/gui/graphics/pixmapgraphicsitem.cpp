@@ -1,12 +1,24 @@
 #include "pixmapgraphicsitem.h"
+#include "graphics/graphicsscene.h"
 
 PixmapGraphicsItem::PixmapGraphicsItem(int type, QGraphicsItem* parent) :
     QGraphicsPixmapItem(parent),
     _type(type)
 {
+    if(scene() != nullptr) {
+        GraphicsScene::updateRegistration(this, nullptr, scene());
+    }
+}
+
+PixmapGraphicsItem::~PixmapGraphicsItem()
+{
+    GraphicsScene::updateRegistration(this, scene(), nullptr);
 }
 
 QVariant PixmapGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value)
 {
+    if(change == ItemSceneChange) {
+        GraphicsScene::updateRegistration(this, scene(), value.value<QGraphicsScene*>());
+    }
     return QGraphicsPixmapItem::itemChange(change, value);
 }
@@ -0,0 +1,537 @@
+#include "pointcloudgraphicsitem.h"
+#include "graphics/graphicsscene.h"
+
+#include <QGraphicsView>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QVarLengthArray>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static const int PointChunkSize = 1024;
+static const int PointsPerCell = 4;
+static const int MaxGridDimension = 4096;
+static const qint64 MaxCachedImagePixels = 4096 * 4096;
+
+PointCloudGraphicsItem::PointCloudGraphicsItem(int type, QGraphicsItem* parent) :
+    QGraphicsItem(parent),
+    _type(type),
+    _color(Qt::black)
+{
+    setFlag(ItemUsesExtendedStyleOption);
+    // A parent already in a scene adds us from the QGraphicsItem constructor, before our itemChange() is reachable
+    if(scene() != nullptr) {
+        GraphicsScene::updateRegistration(this, nullptr, scene());
+    }
+}
+
+PointCloudGraphicsItem::~PointCloudGraphicsItem()
+{
+    GraphicsScene::updateRegistration(this, scene(), nullptr);
+}
+
+void PointCloudGraphicsItem::setPoints(const float* xy, int count, const QRgb* colors)
+{
+    prepareGeometryChange();
+    count = qMax(0, count);
+    _coordinates.resize(qsizetype(count) * 2);
+    if(count > 0) {
+        std::memcpy(_coordinates.data(), xy, sizeof(float) * 2 * count);
+    }
+    if(colors != nullptr && count > 0) {
+        _colors.resize(count);
+        std::memcpy(_colors.data(), colors, sizeof(QRgb) * count);
+    }
+    else {
+        _colors.clear();
+    }
+    recalculateBounds();
+    invalidate();
+    update();
+}
+
+void PointCloudGraphicsItem::setPoints(const QList<QPointF>& points, const QList<QRgb>& colors)
+{
+    QList<float> xy;
+    xy.reserve(points.count() * 2);
+    for(const QPointF& point : points) {
+        xy.append(float(point.x()));
+        xy.append(float(point.y()));
+    }
+    setPoints(xy.constData(), int(points.count()), colors.count() == points.count() ? colors.constData() : nullptr);
+}
+
+void PointCloudGraphicsItem::updatePoints(int first, const float* xy, int count, const QRgb* colors)
+{
+    if(first < 0 || first >= pointCount()) {
+        return;
+    }
+    count = qMin(count, pointCount() - first);
+    if(count <= 0) {
+        return;
+    }
+
+    // Area covered by the range before and after the change; only this is repainted
+    float* target = _coordinates.data() + qsizetype(first) * 2;
+    float minX = xy[0], maxX = xy[0];
+    float minY = xy[1], maxY = xy[1];
+    for(int i = 0;i < count * 2;i += 2) {
+        minX = qMin(minX, qMin(xy[i], target[i]));
+        maxX = qMax(maxX, qMax(xy[i], target[i]));
+        minY = qMin(minY, qMin(xy[i + 1], target[i + 1]));
+        maxY = qMax(maxY, qMax(xy[i + 1], target[i + 1]));
+    }
+    QRectF dirty(QPointF(minX, minY), QPointF(maxX, maxY));
+
+    // Bounds only grow on partial updates
+    QRectF bounds(QPointF(qMin(_bounds.left(), qreal(minX)), qMin(_bounds.top(), qreal(minY))),
+                  QPointF(qMax(_bounds.right(), qreal(maxX)), qMax(_bounds.bottom(), qreal(maxY))));
+    bool boundsChanged = bounds != _bounds;
+    if(boundsChanged) {
+        prepareGeometryChange();
+        _bounds = bounds;
+    }
+    std::memcpy(target, xy, sizeof(float) * 2 * count);
+
+    if(colors != nullptr) {
+        if(_colors.isEmpty()) {
+            _colors.fill(_color.rgba(), pointCount());
+        }
+        std::memcpy(_colors.data() + first, colors, sizeof(QRgb) * count);
+    }
+
+    moveGridPoints(first, count);
+
+    // A cached image sized to the old bounds is rebuilt; otherwise only the dirty area is redrawn
+    if(boundsChanged) {
+        _imageValid = false;
+    }
+    else if(_imageValid) {
+        updateImage(dirty);
+    }
+
+    double pad = pointPadding();
+    update(dirty.adjusted(-pad, -pad, pad, pad));
+}
+
+void PointCloudGraphicsItem::clear()
+{
+    setPoints(nullptr, 0);
+}
+
+void PointCloudGraphicsItem::setColor(const QColor& color)
+{
+    _color = color;
+    _imageValid = false;
+    update();
+}
+
+void PointCloudGraphicsItem::setPointSize(int pixels)
+{
+    prepareGeometryChange();
+    _pointSize = qMax(1, pixels);
+    _imageValid = false;
+    update();
+}
+
+void PointCloudGraphicsItem::setRenderMode(RenderMode mode)
+{
+    _renderMode = mode;
+    _image = QImage();
+    _imageValid = false;
+    update();
+}
+
+void PointCloudGraphicsItem::setPickRadius(double radius)
+{
+    prepareGeometryChange();
+    _pickRadius = qMax(0.0, radius);
+}
+
+int PointCloudGraphicsItem::pointAt(const QPointF& pos, double radius) const
+{
+    int result = -1;
+    buildGrid();
+    int firstColumn, firstRow, lastColumn, lastRow;
+    cellRange(QRectF(pos.x() - radius, pos.y() - radius, radius * 2, radius * 2), firstColumn, firstRow, lastColumn, lastRow);
+
+    double best = radius * radius;
+    for(int row = firstRow;row <= lastRow;row++) {
+        for(int column = firstColumn;column <= lastColumn;column++) {
+            visitCell(cellIndex(column, row), [&](int index) {
+                double dx = _coordinates.at(index * 2) - pos.x();
+                double dy = _coordinates.at(index * 2 + 1) - pos.y();
+                double distance = dx * dx + dy * dy;
+                if(distance <= best) {
+                    best = distance;
+                    result = index;
+                }
+            });
+        }
+    }
+    return result;
+}
+
+QList<int> PointCloudGraphicsItem::pointsIn(const QRectF& rect) const
+{
+    QList<int> result;
+    buildGrid();
+    int firstColumn, firstRow, lastColumn, lastRow;
+    cellRange(rect, firstColumn, firstRow, lastColumn, lastRow);
+
+    for(int row = firstRow;row <= lastRow;row++) {
+        for(int column = firstColumn;column <= lastColumn;column++) {
+            visitCell(cellIndex(column, row), [&](int index) {
+                if(rect.contains(_coordinates.at(index * 2), _coordinates.at(index * 2 + 1))) {
+                    result.append(index);
+                }
+            });
+        }
+    }
+    return result;
+}
+
+QRectF PointCloudGraphicsItem::boundingRect() const
+{
+    // Padding keeps edge points hittable and drawn, and a cloud lying on one line from having an empty rect.
+    // It is in item units so the rect does not change with the view scale behind the scene index's back.
+    if(_coordinates.isEmpty()) {
+        return QRectF();
+    }
+    double pad = qMax(_pickRadius, double(_pointSize));
+    return _bounds.adjusted(-pad, -pad, pad, pad);
+}
+
+bool PointCloudGraphicsItem::contains(const QPointF& point) const
+{
+    return pointAt(point, _pickRadius) >= 0;
+}
+
+void PointCloudGraphicsItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    Q_UNUSED(widget)
+    if(_coordinates.isEmpty()) {
+        return;
+    }
+
+    if(_renderMode == CachedImage) {
+        paintCachedImage(painter);
+    }
+    else {
+        paintPoints(painter, option->exposedRect);
+    }
+}
+
+QVariant PointCloudGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& value)
+{
+    if(change == ItemSceneChange) {
+        GraphicsScene::updateRegistration(this, scene(), value.value<QGraphicsScene*>());
+    }
+    return QGraphicsItem::itemChange(change, value);
+}
+
+void PointCloudGraphicsItem::paintPoints(QPainter* painter, const QRectF& exposedRect)
+{
+    // Points just outside the exposed rect still reach into it by up to the point size
+    QRectF exposed = exposedRect;
+    double scale = std::sqrt(std::abs(painter->worldTransform().determinant()));
+    if(scale > 0) {
+        double pad = _pointSize / scale;
+        exposed.adjust(-pad, -pad, pad, pad);
+    }
+
+    QPen pen(_color, _pointSize);
+    pen.setCosmetic(true);
+    pen.setCapStyle(Qt::SquareCap);
+
+    QRgb currentColor = _color.rgba();
+    painter->setPen(pen);
+
+    QVarLengthArray<QPointF, PointChunkSize> chunk;
+    bool perPoint = _colors.isEmpty() == false;
+    int count = pointCount();
+    const float* xy = _coordinates.constData();
+    for(int i = 0;i < count;i++) {
+        float x = xy[i * 2];
+        float y = xy[i * 2 + 1];
+        if(exposed.contains(x, y) == false) {
+            continue;
+        }
+
+        // Consecutive points of the same color go out in a single drawPoints() call
+        if(perPoint && _colors.at(i) != currentColor) {
+            if(chunk.isEmpty() == false) {
+                painter->drawPoints(chunk.constData(), int(chunk.size()));
+                chunk.clear();
+            }
+            currentColor = _colors.at(i);
+            pen.setColor(QColor::fromRgba(currentColor));
+            painter->setPen(pen);
+        }
+        chunk.append(QPointF(x, y));
+        if(chunk.size() == PointChunkSize) {
+            painter->drawPoints(chunk.constData(), int(chunk.size()));
+            chunk.clear();
+        }
+    }
+    if(chunk.isEmpty() == false) {
+        painter->drawPoints(chunk.constData(), int(chunk.size()));
+    }
+}
+
+void PointCloudGraphicsItem::paintCachedImage(QPainter* painter)
+{
+    QTransform world = painter->worldTransform();
+    int pad = _pointSize;
+
+    // Prefer an image in scaled item space so panning reuses it; fall back to the visible device area when that is too large
+    QTransform linear(world.m11(), world.m12(), world.m21(), world.m22(), 0, 0);
+    QRect scaledRect = linear.mapRect(_bounds).toAlignedRect().adjusted(-pad, -pad, pad, pad);
+    QTransform mapping;
+    QRect targetRect;
+    QTransform blit;
+    if(world.isAffine() && qint64(scaledRect.width()) * scaledRect.height() <= MaxCachedImagePixels) {
+        mapping = linear;
+        targetRect = scaledRect;
+        blit = QTransform::fromTranslate(world.dx(), world.dy());
+    }
+    else {
+        QRect deviceRect(0, 0, painter->device()->width(), painter->device()->height());
+        mapping = world;
+        targetRect = world.mapRect(_bounds).toAlignedRect().adjusted(-pad, -pad, pad, pad) & deviceRect;
+    }
+    if(targetRect.isEmpty()) {
+        return;
+    }
+
+    if(_imageValid == false || mapping != _imageTransform || targetRect != _imageRect) {
+        _image = QImage(targetRect.size(), QImage::Format_ARGB32_Premultiplied);
+        _image.fill(Qt::transparent);
+        _imageTransform = mapping;
+        _imageRect = targetRect;
+        rasterize(_image.rect(), nullptr);
+        _imageValid = true;
+    }
+
+    painter->save();
+    painter->setWorldTransform(blit);
+    painter->drawImage(targetRect.topLeft(), _image);
+    painter->restore();
+}
+
+void PointCloudGraphicsItem::rasterize(const QRect& clip, const QList<int>* indexes)
+{
+    QRgb* bits = reinterpret_cast<QRgb*>(_image.bits());
+    int stride = int(_image.bytesPerLine() / sizeof(QRgb));
+    int half = _pointSize / 2;
+    const QTransform& mapping = _imageTransform;
+    bool affine = mapping.isAffine();
+    QRgb defaultColor = qPremultiply(_color.rgba());
+    bool perPoint = _colors.isEmpty() == false;
+
+    // Pixels are written only inside the clip rect, in image coordinates
+    int clipLeft = clip.left();
+    int clipTop = clip.top();
+    int clipRight = clip.right() + 1;
+    int clipBottom = clip.bottom() + 1;
+
+    int count = indexes != nullptr ? int(indexes->count()) : pointCount();
+    const float* xy = _coordinates.constData();
+    for(int n = 0;n < count;n++) {
+        int i = indexes != nullptr ? indexes->at(n) : n;
+        double px, py;
+        if(affine) {
+            px = mapping.m11() * xy[i * 2] + mapping.m21() * xy[i * 2 + 1] + mapping.dx();
+            py = mapping.m12() * xy[i * 2] + mapping.m22() * xy[i * 2 + 1] + mapping.dy();
+        }
+        else {
+            QPointF p = mapping.map(QPointF(xy[i * 2], xy[i * 2 + 1]));
+            px = p.x();
+            py = p.y();
+        }
+        double x0 = std::floor(px) - _imageRect.left() - half;
+        double y0 = std::floor(py) - _imageRect.top() - half;
+        if(x0 >= clipRight || y0 >= clipBottom || x0 + _pointSize <= clipLeft || y0 + _pointSize <= clipTop) {
+            continue;
+        }
+        int left = int(x0);
+        int top = int(y0);
+
+        QRgb color = perPoint ? qPremultiply(_colors.at(i)) : defaultColor;
+        for(int y = qMax(clipTop, top);y < qMin(clipBottom, top + _pointSize);y++) {
+            QRgb* line = bits + qsizetype(y) * stride;
+            for(int x = qMax(clipLeft, left);x < qMin(clipRight, left + _pointSize);x++) {
+                line[x] = color;
+            }
+        }
+    }
+}
+
+void PointCloudGraphicsItem::updateImage(const QRectF& dirty)
+{
+    // Pixels covered by the old and new positions, in image coordinates
+    int pad = _pointSize;
+    QRect area = _imageTransform.mapRect(dirty).toAlignedRect().adjusted(-pad, -pad, pad, pad);
+    area = area.translated(-_imageRect.topLeft()) & _image.rect();
+    if(area.isEmpty()) {
+        return;
+    }
+
+    bool invertible = false;
+    QTransform inverse = _imageTransform.inverted(&invertible);
+    if(invertible == false) {
+        _imageValid = false;
+        return;
+    }
+
+    // Clear the area, then redraw every point reaching into it in index order as a full rasterize would
+    int stride = int(_image.bytesPerLine() / sizeof(QRgb));
+    QRgb* bits = reinterpret_cast<QRgb*>(_image.bits());
+    for(int y = area.top();y <= area.bottom();y++) {
+        QRgb* line = bits + qsizetype(y) * stride;
+        std::fill(line + area.left(), line + area.right() + 1, QRgb(0));
+    }
+
+    QRectF source = inverse.mapRect(QRectF(area.translated(_imageRect.topLeft())).adjusted(-pad, -pad, pad, pad));
+    QList<int> indexes = pointsIn(source);
+    std::sort(indexes.begin(), indexes.end());
+    rasterize(area, &indexes);
+}
+
+double PointCloudGraphicsItem::pointPadding() const
+{
+    // Points are drawn at a fixed pixel size, so convert that size to item units through the first view
+    double result = _pointSize;
+    if(scene() != nullptr && scene()->views().isEmpty() == false) {
+        QTransform transform = deviceTransform(scene()->views().first()->viewportTransform());
+        double scale = std::sqrt(std::abs(transform.determinant()));
+        if(scale > 0) {
+            result = _pointSize / scale;
+        }
+    }
+    return result;
+}
+
+void PointCloudGraphicsItem::recalculateBounds()
+{
+    _bounds = QRectF();
+    int count = pointCount();
+    if(count == 0) {
+        return;
+    }
+
+    const float* xy = _coordinates.constData();
+    float minX = xy[0], maxX = xy[0];
+    float minY = xy[1], maxY = xy[1];
+    for(int i = 1;i < count;i++) {
+        minX = qMin(minX, xy[i * 2]);
+        maxX = qMax(maxX, xy[i * 2]);
+        minY = qMin(minY, xy[i * 2 + 1]);
+        maxY = qMax(maxY, xy[i * 2 + 1]);
+    }
+    _bounds = QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+}
+
+void PointCloudGraphicsItem::invalidate()
+{
+    _imageValid = false;
+    _gridValid = false;
+}
+
+void PointCloudGraphicsItem::buildGrid() const
+{
+    if(_gridValid) {
+        return;
+    }
+
+    int count = pointCount();
+    double width = qMax(_bounds.width(), 1e-6);
+    double height = qMax(_bounds.height(), 1e-6);
+
+    // Aim for a few points per cell with cells roughly square
+    double cells = qMax(1, count / PointsPerCell);
+    _gridColumns = qBound(1, int(std::sqrt(cells * width / height)), MaxGridDimension);
+    _gridRows = qBound(1, int(cells / _gridColumns), MaxGridDimension);
+    _cellSize = QSizeF(width / _gridColumns, height / _gridRows);
+    _gridBounds = _bounds;
+    _movedPoints.clear();
+    _movedCount = 0;
+
+    // Counting sort of point indexes by cell
+    _cellStart.fill(0, _gridColumns * _gridRows + 1);
+    _cellPoints.resize(count);
+    _pointCells.resize(count);
+    const float* xy = _coordinates.constData();
+    for(int i = 0;i < count;i++) {
+        _pointCells[i] = cellAt(xy[i * 2], xy[i * 2 + 1]);
+        _cellStart[_pointCells[i] + 1]++;
+    }
+    for(int cell = 0;cell < _gridColumns * _gridRows;cell++) {
+        _cellStart[cell + 1] += _cellStart[cell];
+    }
+    QList<int> fill = _cellStart;
+    for(int i = 0;i < count;i++) {
+        _cellPoints[fill[_pointCells[i]]++] = i;
+    }
+    _gridValid = true;
+}
+
+void PointCloudGraphicsItem::moveGridPoints(int first, int count)
+{
+    if(_gridValid == false) {
+        return;
+    }
+
+    // Points outside the grid's original bounds land in the edge cells
+    const float* xy = _coordinates.constData();
+    for(int i = first;i < first + count;i++) {
+        int cell = cellAt(xy[i * 2], xy[i * 2 + 1]);
+        int current = _pointCells.at(i);
+        if(current == cell || current == -(cell + 1)) {
+            continue;
+        }
+        QList<int>& moved = _movedPoints[cell];
+        if(moved.contains(i) == false) {
+            moved.append(i);
+        }
+        _pointCells[i] = -(cell + 1);
+        _movedCount++;
+    }
+
+    // Stale entries slow every lookup, so rebuild once a quarter of the points has moved
+    if(_movedCount > pointCount() / 4) {
+        _gridValid = false;
+    }
+}
+
+int PointCloudGraphicsItem::cellAt(float x, float y) const
+{
+    // Clamp before converting so a point far outside the grid cannot overflow int
+    int column = int(qBound(0.0, std::floor((x - _gridBounds.left()) / _cellSize.width()), double(_gridColumns - 1)));
+    int row = int(qBound(0.0, std::floor((y - _gridBounds.top()) / _cellSize.height()), double(_gridRows - 1)));
+    return cellIndex(column, row);
+}
+
+void PointCloudGraphicsItem::cellRange(const QRectF& rect, int& firstColumn, int& firstRow, int& lastColumn, int& lastRow) const
+{
+    firstColumn = firstRow = 0;
+    lastColumn = lastRow = -1;
+    if(_coordinates.isEmpty()) {
+        return;
+    }
+
+    // Compare edges inclusively; QRectF::intersects() is false for the zero-size rect of a zero radius or a single point
+    QRectF search = rect.normalized();
+    if(search.right() < _bounds.left() || search.left() > _bounds.right() ||
+       search.bottom() < _bounds.top() || search.top() > _bounds.bottom()) {
+        return;
+    }
+
+    // Clamp before converting so a very large rect cannot overflow int
+    firstColumn = int(qBound(0.0, std::floor((search.left() - _gridBounds.left()) / _cellSize.width()), double(_gridColumns - 1)));
+    lastColumn = int(qBound(0.0, std::floor((search.right() - _gridBounds.left()) / _cellSize.width()), double(_gridColumns - 1)));
+    firstRow = int(qBound(0.0, std::floor((search.top() - _gridBounds.top()) / _cellSize.height()), double(_gridRows - 1)));
+    lastRow = int(qBound(0.0, std::floor((search.bottom() - _gridBounds.top()) / _cellSize.height()), double(_gridRows - 1)));
+}
@@ -1,4 +1,5 @@
 #include "rectanglegraphicsitem.h"
+#include "graphics/graphicsscene.h"
 
 #include <Kanoop/geometry/rectangle.h>
 
@@ -6,12 +7,23 @@ RectangleGraphicsItem::RectangleGraphicsItem(int type, QGraphicsItem *parent) :
     QGraphicsRectItem(parent),
     _type(type)
 {
+    if(scene() != nullptr) {
+        GraphicsScene::updateRegistration(this, nullptr, scene());
+    }
 }
 
 RectangleGraphicsItem::RectangleGraphicsItem(const Rectangle& rect, int type, QGraphicsItem* parent) :
     QGraphicsRectItem(rect, parent),
     _type(type)
 {
+    if(scene() != nullptr) {
+        GraphicsScene::updateRegistration(this, nullptr, scene());
+    }
+}
+
+RectangleGraphicsItem::~RectangleGraphicsItem()
+{
+    GraphicsScene::updateRegistration(this, scene(), nullptr);
 }
 
 Point RectangleGraphicsItem::centerPoint() const
@@ -29,5 +41,8 @@ Point RectangleGraphicsItem::sceneCenterPoint() const
 
 QVariant RectangleGraphicsItem::itemChange(GraphicsItemChange change, const QVariant &value)
 {
+    if(change == ItemSceneChange) {
+        GraphicsScene::updateRegistration(this, scene(), value.value<QGraphicsScene*>());
+    }
     return QGraphicsRectItem::itemChange(change, value);
 }
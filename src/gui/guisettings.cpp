@@ -17,6 +17,7 @@
 #include <QHeaderView>
 #include <QMdiSubWindow>
 #include <QScreen>
+#include <QSet>
 #include <QSplitter>
 #include <QTableView>
 #include <Kanoop/log.h>
@@ -28,6 +29,7 @@ const QString GuiSettings::KEY_HEADER_STATE_HORIZ           = "header_state_h";
 const QString GuiSettings::KEY_HEADER_STATE_VERT            = "header_state_v";
 const QString GuiSettings::KEY_LAST_WIDGET_POS              = "widget_pos";
 const QString GuiSettings::KEY_LAST_WIDGET_SIZE             = "widget_size";
+const QString GuiSettings::KEY_LAST_WIDGET_MAXIMIZED        = "widget_maximized";
 const QString GuiSettings::KEY_MODEL_HEADER_STATE_HORIZ     = "model_header_state_h";
 const QString GuiSettings::KEY_MODEL_HEADER_STATE_VERT      = "model_header_state_v";
 const QString GuiSettings::KEY_SPLITTER_STATE_HORIZ         = "splitter_state_h";
@@ -37,14 +39,26 @@ const QString GuiSettings::KEY_TREEVIEW_STATE               = "treeview_state";
 GuiSettings::GuiSettings() :
     AppSettings()
 {
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(DefaultFlushInterval);
+    connect(&_flushTimer, &QTimer::timeout, this, &GuiSettings::flush);
+}
+
+GuiSettings::~GuiSettings()
+{
+    flush();
 }
 
 QPoint GuiSettings::getLastWindowPosition(QWidget* widget, const QSize &defaultSize) const
 {
     QPoint result;
-    QString key = makeKey(KEY_LAST_WIDGET_POS, widget->objectName());
-    if(_settings.contains(key)) {
-        result = _settings.value(key).toPoint();
+    QString key = objectKey(KEY_LAST_WIDGET_POS, widget->objectName());
+    auto pending = _pendingGeometry.constFind(widget->objectName());
+    if(pending != _pendingGeometry.constEnd() && pending->hasPos) {
+        result = pending->pos;
+    }
+    else if(bufferedContains(key)) {
+        result = bufferedValue(key).toPoint();
     }
     else {
         QWidget* parent = widget->parentWidget();
@@ -67,9 +81,13 @@ QPoint GuiSettings::getLastWindowPosition(QWidget* widget, const QSize &defaultS
 QSize GuiSettings::getLastWindowSize(const QWidget *widget, const QSize &defaultSize)
 {
     QSize result;
-    QString key = makeKey(KEY_LAST_WIDGET_SIZE, widget->objectName());
-    if(_settings.contains(key)) {
-        result = _settings.value(key).toSize();
+    QString key = objectKey(KEY_LAST_WIDGET_SIZE, widget->objectName());
+    auto pending = _pendingGeometry.constFind(widget->objectName());
+    if(pending != _pendingGeometry.constEnd() && pending->hasSize) {
+        result = pending->size;
+    }
+    else if(bufferedContains(key)) {
+        result = bufferedValue(key).toSize();
     }
     else {
         result = defaultSize.isEmpty() ? QSize(500, 500) : defaultSize;
@@ -78,10 +96,43 @@ QSize GuiSettings::getLastWindowSize(const QWidget *widget, const QSize &default
     return result;
 }
 
+void GuiSettings::recordWindowPosition(const QWidget* widget, const QPoint& pos)
+{
+    WindowGeometry& geometry = pendingGeometry(widget);
+    geometry.maximized = isWindowMaximized(widget);
+    if(geometry.maximized == false) {
+        geometry.pos = pos;
+        geometry.hasPos = true;
+    }
+}
+
+void GuiSettings::recordWindowSize(const QWidget* widget, const QSize& size)
+{
+    WindowGeometry& geometry = pendingGeometry(widget);
+    geometry.maximized = isWindowMaximized(widget);
+    if(geometry.maximized == false) {
+        geometry.size = size;
+        geometry.hasSize = true;
+    }
+}
+
+bool GuiSettings::getLastWindowMaximized(const QWidget* widget) const
+{
+    auto pending = _pendingGeometry.constFind(widget->objectName());
+    if(pending != _pendingGeometry.constEnd()) {
+        return pending->maximized;
+    }
+    return bufferedValue(objectKey(KEY_LAST_WIDGET_MAXIMIZED, widget->objectName()), false).toBool();
+}
+
 bool GuiSettings::widgetHasPersistentGeometry(const QWidget* widget) const
 {
-    QString key = makeKey(KEY_LAST_WIDGET_SIZE, widget->objectName());
-    return _settings.contains(key);
+    auto pending = _pendingGeometry.constFind(widget->objectName());
+    if(pending != _pendingGeometry.constEnd() && pending->hasSize) {
+        return true;
+    }
+    QString key = objectKey(KEY_LAST_WIDGET_SIZE, widget->objectName());
+    return bufferedContains(key);
 }
 
 void GuiSettings::saveLastSplitterState(QSplitter *splitter)
@@ -89,7 +140,7 @@ void GuiSettings::saveLastSplitterState(QSplitter *splitter)
     QString key = makeCompoundObjectKey(splitter->orientation() == Qt::Vertical
                                         ? KEY_SPLITTER_STATE_VERT
                                         : KEY_SPLITTER_STATE_HORIZ, splitter);
-    _settings.setValue(key, splitter->saveState());
+    setBufferedValue(key, splitter->saveState());
 }
 
 void GuiSettings::restoreLastSplitterState(QSplitter *splitter)
@@ -99,7 +150,7 @@ void GuiSettings::restoreLastSplitterState(QSplitter *splitter)
                                         : KEY_SPLITTER_STATE_HORIZ, splitter);
 
     QByteArray savedState = splitter->saveState();
-    QVariant value = _settings.value(key);
+    QVariant value = bufferedValue(key);
     QByteArray splitterState = value.toByteArray();
     if(splitterState.isEmpty() == false) {
         // if the count has changed, we should not restore the state
@@ -114,13 +165,16 @@ void GuiSettings::restoreLastSplitterState(QSplitter *splitter)
 
 void GuiSettings::saveLastHeaderState(QHeaderView *header)
 {
+    if(_restoringHeaderState) {
+        return;
+    }
     if(header->orientation() == Qt::Vertical) {
-        _settings.setValue(makeKey(KEY_HEADER_STATE_VERT, makeObjectKey(header->parent())), header->saveState());
+        setBufferedValue(objectKey(KEY_HEADER_STATE_VERT, makeObjectKey(header->parent())), header->saveState());
     }
     else {
-        QString key = makeKey(KEY_HEADER_STATE_HORIZ, makeObjectKey(header->parent()));
+        QString key = objectKey(KEY_HEADER_STATE_HORIZ, makeObjectKey(header->parent()));
         QByteArray headerState = header->saveState();
-        _settings.setValue(key, headerState);
+        setBufferedValue(key, headerState);
     }
 }
 
@@ -128,11 +182,11 @@ void GuiSettings::restoreLastHeaderState(QHeaderView *header)
 {
     QByteArray headerState;
     if(header->orientation() == Qt::Vertical) {
-        headerState = _settings.value(makeKey(KEY_HEADER_STATE_VERT, makeObjectKey(header->parent()))).toByteArray();
+        headerState = bufferedValue(objectKey(KEY_HEADER_STATE_VERT, makeObjectKey(header->parent()))).toByteArray();
     }
     else {
-        QString key = makeKey(KEY_HEADER_STATE_HORIZ, makeObjectKey(header->parent()));
-        headerState = _settings.value(key).toByteArray();
+        QString key = objectKey(KEY_HEADER_STATE_HORIZ, makeObjectKey(header->parent()));
+        headerState = bufferedValue(key).toByteArray();
     }
     if(headerState.isEmpty() == false) {
         // Save the state. If the count of items has changed, we can't restore it
@@ -148,7 +202,7 @@ void GuiSettings::restoreLastHeaderState(QHeaderView *header)
 
 void GuiSettings::saveLastHeaderState(QHeaderView *header, AbstractItemModel *model)
 {
-    if(model == nullptr) {
+    if(model == nullptr || _restoringHeaderState) {
         return;
     }
     TableHeader::List headers = model->columnHeaders();
@@ -157,60 +211,266 @@ void GuiSettings::saveLastHeaderState(QHeaderView *header, AbstractItemModel *mo
         TableHeader tableHeader = headers.at(section);
         headerState.addSection(section, tableHeader.text(), header->sectionSize(section), tableHeader.isVisible());
     }
-    QByteArray jsonHeaderState = headerState.serializeToJson();
+    QByteArray binaryHeaderState = headerState.serializeToBinary();
     if(header->orientation() == Qt::Vertical) {
-        _settings.setValue(makeKey(KEY_MODEL_HEADER_STATE_VERT, makeObjectKey(header->parent())), jsonHeaderState);
+        setBufferedValue(objectKey(KEY_MODEL_HEADER_STATE_VERT, makeObjectKey(header->parent())), binaryHeaderState);
     }
     else {
-        _settings.setValue(makeKey(KEY_MODEL_HEADER_STATE_HORIZ, makeObjectKey(header->parent())), jsonHeaderState);
+        setBufferedValue(objectKey(KEY_MODEL_HEADER_STATE_HORIZ, makeObjectKey(header->parent())), binaryHeaderState);
     }
 }
 
 void GuiSettings::restoreLastHeaderState(QHeaderView *header, AbstractItemModel *model)
 {
+    if(model == nullptr) {
+        return;
+    }
+
     HeaderState headerState;
-    QByteArray jsonState;
     QString key = header->orientation() == Qt::Vertical
-                      ? makeKey(KEY_MODEL_HEADER_STATE_VERT, makeObjectKey(header->parent()))
-                      : makeKey(KEY_MODEL_HEADER_STATE_HORIZ, makeObjectKey(header->parent()));
-    jsonState = _settings.value(key).toByteArray();
-    headerState.deserializeFromJson(jsonState);
+                      ? objectKey(KEY_MODEL_HEADER_STATE_VERT, makeObjectKey(header->parent()))
+                      : objectKey(KEY_MODEL_HEADER_STATE_HORIZ, makeObjectKey(header->parent()));
+    // Accepts both the binary format and the JSON format written by earlier versions
+    if(headerState.deserialize(bufferedValue(key).toByteArray()) == false) {
+        return;
+    }
+
+    // Apply everything in one go. Resizing sections re-enters saveLastHeaderState()
+    // through the views' sectionResized handlers, which is pointless while restoring.
+    QTableView* view = qobject_cast<QTableView*>(header->parent());
+    QWidget* updateWidget = view != nullptr ? static_cast<QWidget*>(view) : static_cast<QWidget*>(header);
+    bool updatesEnabled = updateWidget->updatesEnabled();
+    updateWidget->setUpdatesEnabled(false);
+    _restoringHeaderState = true;
 
     TableHeader::List headers = model->columnHeaders();
     for(int section = 0;section < headers.count();section++) {
         TableHeader tableHeader = headers.at(section);
         QString sectionText = tableHeader.text();
         HeaderState::SectionState sectionState = headerState.getSection(section);
-        if(sectionState.isValid() && sectionState.text() == sectionText) {
+        if(sectionState.isValid() == false || sectionState.text() != sectionText) {
+            // The column may have moved since the state was saved
+            sectionState = headerState.getSection(sectionText);
+        }
+        if(sectionState.isValid()) {
             // A stretch section derives its width from the layout, so restoring a persisted
             // width onto it would defeat the stretch until the next layout pass and can force
             // horizontal scrolling. Only restore widths on sections the user actually sizes.
             bool stretchSection = header->sectionResizeMode(section) == QHeaderView::Stretch ||
                                   (header->stretchLastSection() && section == header->count() - 1);
-            if(stretchSection == false) {
+            if(stretchSection == false && header->sectionSize(section) != sectionState.size()) {
                 header->resizeSection(section, sectionState.size());
             }
-            QTableView* view = qobject_cast<QTableView*>(header->parent());
             if(view != nullptr) {
-                if(sectionState.isVisible() == false) {
+                bool hidden = sectionState.isVisible() == false;
+                if(hidden) {
                     Log::logText(LVL_DEBUG, QString("Section %1 of %2 not visible").arg(section).arg(view->objectName()));
                 }
-                view->setColumnHidden(section, sectionState.isVisible() == false);
+                if(view->isColumnHidden(section) != hidden) {
+                    view->setColumnHidden(section, hidden);
+                }
             }
         }
     }
+
+    _restoringHeaderState = false;
+    updateWidget->setUpdatesEnabled(updatesEnabled);
 }
 
 void GuiSettings::saveTreeViewState(TreeViewBase *treeView)
 {
     QByteArray state = treeView->saveState();
-    _settings.setValue(makeKey(KEY_TREEVIEW_STATE, treeView->objectName()), state);
+    setBufferedValue(objectKey(KEY_TREEVIEW_STATE, treeView->objectName()), state);
+}
+
+void GuiSettings::restoreTreeViewState(TreeViewBase *treeView, bool incremental)
+{
+    QByteArray state = bufferedValue(objectKey(KEY_TREEVIEW_STATE, treeView->objectName())).toByteArray();
+    if(incremental) {
+        treeView->restoreStateIncrementally(state);
+    }
+    else {
+        treeView->restoreState(state);
+    }
+}
+
+void GuiSettings::resetWriteStatistics()
+{
+    _writeRequestCount = 0;
+    _writeCount = 0;
+    _flushCount = 0;
+}
+
+void GuiSettings::flush()
+{
+    _flushTimer.stop();
+    commitPendingGeometry();
+    if(_pendingWrites.isEmpty()) {
+        return;
+    }
+
+    int count = _pendingWrites.count();
+    for(auto it = _pendingWrites.constBegin();it != _pendingWrites.constEnd();it++) {
+        _settings.setValue(it.key(), it.value());
+        if(_snapshotLoaded) {
+            _snapshot.insert(it.key(), it.value());
+        }
+    }
+    _pendingWrites.clear();
+    _writeCount += count;
+    _flushCount++;
+    emit flushed(count);
+}
+
+void GuiSettings::setBufferedValue(const QString& key, const QVariant& value)
+{
+    installQuitHook();
+    _pendingWrites.insert(key, value);
+    _writeRequestCount++;
+    _flushTimer.start();
 }
 
-void GuiSettings::restoreTreeViewState(TreeViewBase *treeView)
+GuiSettings::WindowGeometry& GuiSettings::pendingGeometry(const QWidget* widget)
 {
-    QByteArray state = _settings.value(makeKey(KEY_TREEVIEW_STATE, treeView->objectName())).toByteArray();
-    treeView->restoreState(state);
+    // Move and resize events arrive in bursts; count one request per window per flush and
+    // leave a running timer alone so a long drag cannot keep postponing the write
+    installQuitHook();
+    auto it = _pendingGeometry.find(widget->objectName());
+    if(it == _pendingGeometry.end()) {
+        it = _pendingGeometry.insert(widget->objectName(), WindowGeometry());
+        _writeRequestCount++;
+    }
+    if(_flushTimer.isActive() == false) {
+        _flushTimer.start();
+    }
+    return it.value();
+}
+
+void GuiSettings::commitPendingGeometry()
+{
+    for(auto it = _pendingGeometry.constBegin();it != _pendingGeometry.constEnd();it++) {
+        const WindowGeometry& geometry = it.value();
+        if(geometry.hasPos) {
+            _pendingWrites.insert(objectKey(KEY_LAST_WIDGET_POS, it.key()), geometry.pos);
+        }
+        if(geometry.hasSize) {
+            _pendingWrites.insert(objectKey(KEY_LAST_WIDGET_SIZE, it.key()), geometry.size);
+        }
+        _pendingWrites.insert(objectKey(KEY_LAST_WIDGET_MAXIMIZED, it.key()), geometry.maximized);
+    }
+    _pendingGeometry.clear();
+}
+
+void GuiSettings::installQuitHook()
+{
+    if(_quitHookInstalled == false && QCoreApplication::instance() != nullptr) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &GuiSettings::flush);
+        _quitHookInstalled = true;
+    }
+}
+
+bool GuiSettings::isWindowMaximized(const QWidget* widget)
+{
+    // A widget hosted in an MDI subwindow is maximized along with its frame
+    const QWidget* window = qobject_cast<const QMdiSubWindow*>(widget->parentWidget()) != nullptr
+                                ? widget->parentWidget()
+                                : widget;
+    return window->windowState().testAnyFlags(Qt::WindowMaximized | Qt::WindowFullScreen);
+}
+
+QVariant GuiSettings::bufferedValue(const QString& key, const QVariant& defaultValue) const
+{
+    auto it = _pendingWrites.constFind(key);
+    if(it != _pendingWrites.constEnd()) {
+        return it.value();
+    }
+    if(_snapshotLoaded) {
+        return _snapshot.value(key, defaultValue);
+    }
+    return _settings.value(key, defaultValue);
+}
+
+bool GuiSettings::bufferedContains(const QString& key) const
+{
+    if(_pendingWrites.contains(key)) {
+        return true;
+    }
+    return _snapshotLoaded ? _snapshot.contains(key) : _settings.contains(key);
+}
+
+void GuiSettings::prefetch()
+{
+    _snapshot.clear();
+    const QStringList keys = _settings.allKeys();
+    for(const QString& key : keys) {
+        QString keyName = guiKeyName(key);
+        if(keyName.isEmpty() == false) {
+            _snapshot.insert(key, typedValue(keyName, _settings.value(key)));
+        }
+    }
+    _snapshotLoaded = true;
+    _fontSize = bufferedValue(fontSizeKey()).toInt();
+    Log::logText(LVL_DEBUG, QString("Prefetched %1 of %2 settings keys").arg(_snapshot.count()).arg(keys.count()));
+}
+
+QString GuiSettings::objectKey(const QString& keyName, const QString& objectName) const
+{
+    // Restores look up the same handful of keys for every widget; build each one once
+    QHash<QString, QString>& keys = _objectKeys[keyName];
+    auto it = keys.constFind(objectName);
+    if(it == keys.constEnd()) {
+        it = keys.insert(objectName, makeKey(keyName, objectName));
+    }
+    return it.value();
+}
+
+QString GuiSettings::fontSizeKey() const
+{
+    if(_fontSizeKey.isEmpty()) {
+        _fontSizeKey = makeStandardKey(KEY_FONT_SIZE);
+    }
+    return _fontSizeKey;
+}
+
+QString GuiSettings::guiKeyName(const QString& key)
+{
+    // Every key GuiSettings reads is built from one of these, so the snapshot is exhaustive
+    static const QSet<QString> guiKeyNames = {
+        KEY_FONT_SIZE, KEY_HEADER_STATE_HORIZ, KEY_HEADER_STATE_VERT,
+        KEY_LAST_WIDGET_POS, KEY_LAST_WIDGET_SIZE, KEY_LAST_WIDGET_MAXIMIZED,
+        KEY_MODEL_HEADER_STATE_HORIZ, KEY_MODEL_HEADER_STATE_VERT,
+        KEY_SPLITTER_STATE_HORIZ, KEY_SPLITTER_STATE_VERT, KEY_TREEVIEW_STATE,
+    };
+
+    // makeKey() and makeStandardKey() join names with '/', so compare whole segments;
+    // an application key that merely contains one of the names is not a GUI key
+    const QStringList segments = key.split('/');
+    for(const QString& segment : segments) {
+        auto it = guiKeyNames.constFind(segment);
+        if(it != guiKeyNames.constEnd()) {
+            return *it;
+        }
+    }
+    return QString();
+}
+
+QVariant GuiSettings::typedValue(const QString& keyName, const QVariant& value)
+{
+    // Text-based stores hand back strings; convert once here so reads from the
+    // snapshot do not repeat the conversion every time a widget is restored
+    if(keyName == KEY_LAST_WIDGET_POS) {
+        return value.toPoint();
+    }
+    if(keyName == KEY_LAST_WIDGET_SIZE) {
+        return value.toSize();
+    }
+    if(keyName == KEY_LAST_WIDGET_MAXIMIZED) {
+        return value.toBool();
+    }
+    if(keyName == KEY_FONT_SIZE) {
+        return value.toInt();
+    }
+    return value.toByteArray();
 }
 
 void GuiSettings::ensureValidDefaults()
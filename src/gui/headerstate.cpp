@@ -1,7 +1,12 @@
 #include "headerstate.h"
 
+#include <QDataStream>
 #include <QJsonDocument>
 
+// Binary layout: "KHS" | quint8 version | quint32 count | { qint32 section, QString text, qint32 size, bool visible }...
+static const QByteArray BinaryMagic = QByteArrayLiteral("KHS");
+static const quint8 BinaryVersion = 1;
+
 QByteArray HeaderState::serializeToJson() const
 {
     QJsonDocument doc;
@@ -17,12 +22,117 @@ QByteArray HeaderState::serializeToJson() const
 void HeaderState::deserializeFromJson(const QByteArray &json)
 {
     QJsonDocument doc = QJsonDocument::fromJson(json);
+    _sections.clear();
     _sections.deserializeFromJsonArray(doc["sections"].toArray());
+    rebuildIndex();
+}
+
+QByteArray HeaderState::serializeToBinary() const
+{
+    QByteArray result;
+    result.reserve(BinaryMagic.size() + 5 + _sections.count() * 32);
+    result.append(BinaryMagic);
+    result.append(static_cast<char>(BinaryVersion));
+
+    QDataStream stream(&result, QIODevice::Append);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << static_cast<quint32>(_sections.count());
+    for(const SectionState& sectionState : _sections) {
+        stream << static_cast<qint32>(sectionState.section())
+               << sectionState.text()
+               << static_cast<qint32>(sectionState.size())
+               << sectionState.isVisible();
+    }
+    return result;
+}
+
+bool HeaderState::deserializeFromBinary(const QByteArray& data)
+{
+    _sections.clear();
+    rebuildIndex();
+    if(isBinary(data) == false || data.size() < BinaryMagic.size() + 1) {
+        return false;
+    }
+    if(static_cast<quint8>(data.at(BinaryMagic.size())) > BinaryVersion) {
+        return false;
+    }
+
+    QDataStream stream(data.mid(BinaryMagic.size() + 1));
+    stream.setVersion(QDataStream::Qt_6_0);
+    quint32 count = 0;
+    stream >> count;
+    for(quint32 i = 0;i < count && stream.status() == QDataStream::Ok;i++) {
+        qint32 section = 0;
+        QString text;
+        qint32 size = 0;
+        bool visible = true;
+        stream >> section >> text >> size >> visible;
+        if(stream.status() == QDataStream::Ok) {
+            _sections.append(SectionState(section, text, size, visible));
+        }
+    }
+
+    bool result = stream.status() == QDataStream::Ok;
+    if(result == false) {
+        _sections.clear();
+    }
+    rebuildIndex();
+    return result;
+}
+
+bool HeaderState::deserialize(const QByteArray& data)
+{
+    if(isBinary(data)) {
+        return deserializeFromBinary(data);
+    }
+    deserializeFromJson(data);
+    return _sections.isEmpty() == false;
+}
+
+bool HeaderState::isBinary(const QByteArray& data)
+{
+    return data.startsWith(BinaryMagic);
 }
 
 void HeaderState::addSection(int section, const QString &text, int size, bool visible)
 {
     _sections.append(SectionState(section, text, size, visible));
+    indexSection(int(_sections.count()) - 1);
+}
+
+HeaderState::SectionState HeaderState::getSection(int section) const
+{
+    int index = _indexBySection.value(section, -1);
+    return index >= 0 ? _sections.at(index) : SectionState();
+}
+
+HeaderState::SectionState HeaderState::getSection(const QString& text) const
+{
+    int index = _indexByText.value(text, -1);
+    return index >= 0 ? _sections.at(index) : SectionState();
+}
+
+void HeaderState::rebuildIndex()
+{
+    _indexBySection.clear();
+    _indexByText.clear();
+    _indexBySection.reserve(_sections.count());
+    _indexByText.reserve(_sections.count());
+    for(int index = 0;index < _sections.count();index++) {
+        indexSection(index);
+    }
+}
+
+void HeaderState::indexSection(int index)
+{
+    // The first section with a given number or text wins; sections without text are found by number only
+    const SectionState& sectionState = _sections.at(index);
+    if(_indexBySection.contains(sectionState.section()) == false) {
+        _indexBySection.insert(sectionState.section(), index);
+    }
+    if(sectionState.isValid() && _indexByText.contains(sectionState.text()) == false) {
+        _indexByText.insert(sectionState.text(), index);
+    }
 }
 
 QJsonObject HeaderState::SectionState::serializeToJsonObject() const
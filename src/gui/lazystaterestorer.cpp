@@ -0,0 +1,75 @@
+#include "lazystaterestorer.h"
+#include "guisettings.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QPointer>
+#include <QSplitter>
+
+const char* LazyStateRestorer::PendingProperty = "_kanoopRestorePending";
+quint64 LazyStateRestorer::_nextSerial = 0;
+
+LazyStateRestorer::LazyStateRestorer(QObject* parent) :
+    QObject(parent),
+    _serial(++_nextSerial) {}
+
+LazyStateRestorer* LazyStateRestorer::instance()
+{
+    // Owned by the application; the QPointer clears when it is destroyed, so a new application gets a new instance
+    static QPointer<LazyStateRestorer> _instance;
+    if(_instance.isNull()) {
+        _instance = new LazyStateRestorer(QCoreApplication::instance());
+    }
+    return _instance;
+}
+
+void LazyStateRestorer::registerSplitter(QSplitter* splitter)
+{
+    if(GuiSettings::globalInstance() == nullptr) {
+        return;
+    }
+
+    // Already on screen (e.g. objectName changed after show); no point in waiting
+    if(splitter->isVisible()) {
+        GuiSettings::globalInstance()->restoreLastSplitterState(splitter);
+        _restoredCount++;
+        return;
+    }
+
+    // A tag left by a destroyed instance does not count; its event filter went with it
+    if(splitter->property(PendingProperty).toULongLong() != _serial) {
+        splitter->setProperty(PendingProperty, QVariant::fromValue(_serial));
+        splitter->installEventFilter(this);
+    }
+}
+
+void LazyStateRestorer::registerSplitters(QWidget* root)
+{
+    for(QSplitter* splitter : root->findChildren<QSplitter*>()) {
+        registerSplitter(splitter);
+    }
+}
+
+bool LazyStateRestorer::eventFilter(QObject* watched, QEvent* event)
+{
+    if(event->type() == QEvent::Show) {
+        QSplitter* splitter = qobject_cast<QSplitter*>(watched);
+        if(splitter != nullptr) {
+            restore(splitter);
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void LazyStateRestorer::restore(QSplitter* splitter)
+{
+    splitter->removeEventFilter(this);
+    splitter->setProperty(PendingProperty, QVariant());
+
+    if(GuiSettings::globalInstance() != nullptr) {
+        GuiSettings::globalInstance()->restoreLastSplitterState(splitter);
+        _restoredCount++;
+    }
+}
+
+#include "moc_lazystaterestorer.cpp"
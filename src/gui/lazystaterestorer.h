@@ -0,0 +1,43 @@
+#ifndef LAZYSTATERESTORER_H
+#define LAZYSTATERESTORER_H
+
+#include <QObject>
+
+class QSplitter;
+class QWidget;
+
+/**
+ * Restores persisted splitter state the first time each splitter is shown.
+ * A single shared instance is installed as the event filter on every
+ * registered splitter and removes itself once the splitter is restored,
+ * so widgets in hidden tabs or collapsed panes cost nothing at construction.
+ * Pending splitters are tagged with the serial of the instance that filters
+ * them, so a recreated instance registers them again.
+ */
+class LazyStateRestorer : public QObject
+{
+    Q_OBJECT
+public:
+    static LazyStateRestorer* instance();
+
+    void registerSplitter(QSplitter* splitter);
+    void registerSplitters(QWidget* root);
+
+    int restoredCount() const { return _restoredCount; }
+
+protected:
+    virtual bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    explicit LazyStateRestorer(QObject* parent = nullptr);
+
+    void restore(QSplitter* splitter);
+
+    static const char* PendingProperty;
+    static quint64 _nextSerial;
+
+    quint64 _serial;
+    int _restoredCount = 0;
+};
+
+#endif // LAZYSTATERESTORER_H
@@ -71,6 +71,18 @@ void ListView::setCurrentUuid(const QUuid& uuid, ScrollHint scrollHint)
     }
 }
 
+void ListView::reset()
+{
+    _selectedItems.invalidate();
+    QListView::reset();
+}
+
+void ListView::selectionChanged(const QItemSelection& selected, const QItemSelection& deselected)
+{
+    _selectedItems.invalidate();
+    QListView::selectionChanged(selected, deselected);
+}
+
 void ListView::onCurrentSelectionChanged(const QModelIndex& current, const QModelIndex& previous)
 {
     Q_UNUSED(previous)
@@ -0,0 +1,91 @@
+#include "logentryqueue.h"
+
+#include <QtMath>
+
+static const quint64 AllLevels = ~quint64(0);
+
+LogEntryQueue::LogEntryQueue(int capacity) :
+    _enqueuePosition(0),
+    _dequeuePosition(0),
+    _levelMask(AllLevels),
+    _dropped(0)
+{
+    // Slots are addressed by masking the position, so round up to a power of two
+    int size = capacity > 2 ? int(qNextPowerOfTwo(quint32(capacity - 1))) : 2;
+    _cells = new Cell[size];
+    _mask = size - 1;
+    for(int i = 0;i < size;i++) {
+        _cells[i].sequence.storeRelaxed(quintptr(i));
+    }
+}
+
+LogEntryQueue::~LogEntryQueue()
+{
+    delete[] _cells;
+}
+
+bool LogEntryQueue::enqueue(const Log::LogEntry& entry)
+{
+    if(acceptsLevel(entry.level()) == false) {
+        return false;
+    }
+
+    // Each slot's sequence tells producers whether it is free for the position they claim
+    Cell* cell;
+    quintptr position = _enqueuePosition.loadRelaxed();
+    for(;;) {
+        cell = &_cells[position & quintptr(_mask)];
+        qintptr diff = qintptr(cell->sequence.loadAcquire()) - qintptr(position);
+        if(diff == 0) {
+            if(_enqueuePosition.testAndSetRelaxed(position, position + 1, position)) {
+                break;
+            }
+        }
+        else if(diff < 0) {
+            _dropped.fetchAndAddRelaxed(1);
+            return false;
+        }
+        else {
+            position = _enqueuePosition.loadRelaxed();
+        }
+    }
+
+    cell->entry = entry;
+    cell->sequence.storeRelease(position + 1);
+    return true;
+}
+
+QList<Log::LogEntry> LogEntryQueue::drain(int maximum)
+{
+    QList<Log::LogEntry> result;
+    while(result.count() < maximum) {
+        Cell* cell = &_cells[_dequeuePosition & quintptr(_mask)];
+        if(cell->sequence.loadAcquire() != _dequeuePosition + 1) {
+            break;
+        }
+        result.append(cell->entry);
+        cell->entry = Log::LogEntry();
+        cell->sequence.storeRelease(_dequeuePosition + quintptr(_mask) + 1);
+        _dequeuePosition++;
+    }
+    return result;
+}
+
+void LogEntryQueue::setLevels(const QList<Log::LogLevel>& levels)
+{
+    quint64 mask = levels.isEmpty() ? AllLevels : 0;
+    for(Log::LogLevel level : levels) {
+        if(int(level) >= 0 && int(level) < 64) {
+            mask |= quint64(1) << int(level);
+        }
+    }
+    _levelMask.storeRelaxed(mask);
+}
+
+bool LogEntryQueue::acceptsLevel(Log::LogLevel level) const
+{
+    if(int(level) < 0 || int(level) >= 64) {
+        return true;
+    }
+    return (_levelMask.loadRelaxed() & (quint64(1) << int(level))) != 0;
+}
@@ -0,0 +1,48 @@
+#ifndef LOGENTRYQUEUE_H
+#define LOGENTRYQUEUE_H
+
+#include <QAtomicInteger>
+#include <QList>
+#include <Kanoop/utility/loggingbaseclass.h>
+
+/**
+ * Bounded lock-free queue carrying log entries from logging threads to the GUI thread.
+ * Any number of threads may enqueue; a single consumer drains. When the queue is
+ * full new entries are dropped and counted rather than blocking the logger.
+ * Entries whose level is not in the filter are discarded before queuing.
+ */
+class LogEntryQueue
+{
+public:
+    explicit LogEntryQueue(int capacity);
+    ~LogEntryQueue();
+
+    bool enqueue(const Log::LogEntry& entry);
+    QList<Log::LogEntry> drain(int maximum);
+
+    int capacity() const { return _mask + 1; }
+
+    void setLevels(const QList<Log::LogLevel>& levels);
+    bool acceptsLevel(Log::LogLevel level) const;
+
+    int takeDroppedCount() { return _dropped.fetchAndStoreRelaxed(0); }
+
+private:
+    Q_DISABLE_COPY(LogEntryQueue)
+
+    class Cell
+    {
+    public:
+        QAtomicInteger<quintptr> sequence;
+        Log::LogEntry entry;
+    };
+
+    Cell* _cells;
+    int _mask;
+    QAtomicInteger<quintptr> _enqueuePosition;
+    quintptr _dequeuePosition;
+    QAtomicInteger<quint64> _levelMask;
+    QAtomicInt _dropped;
+};
+
+#endif // LOGENTRYQUEUE_H
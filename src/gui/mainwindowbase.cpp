@@ -10,8 +10,11 @@
 ******************************************************************************************/
 #include "guisettings.h"
 #include "mainwindowbase.h"
+#include "lazystaterestorer.h"
+#include "utility/fontscaler.h"
 
 #include <QGuiApplication>
+#include <QCloseEvent>
 #include <QHBoxLayout>
 #include <QMdiArea>
 #include <QMenu>
@@ -61,7 +64,7 @@ void MainWindowBase::initializeBase()
 
     if(GuiSettings::globalInstance() != nullptr) {
         for(QSplitter* splitter : findChildren<QSplitter*>()) {
-            GuiSettings::globalInstance()->restoreLastSplitterState(splitter);
+            LazyStateRestorer::instance()->registerSplitter(splitter);
             connect(splitter, &QSplitter::splitterMoved, this, &MainWindowBase::onSpliltterMoved);
         }
     }
@@ -91,7 +94,7 @@ void MainWindowBase::moveEvent(QMoveEvent *event)
 {
     // logText(LVL_DEBUG, QString("%1 - move to %2").arg(objectName()).arg(Point(event->pos()).toString()));
     if(_formLoadComplete && _persistPosition) {
-        GuiSettings::globalInstance()->setLastWindowPosition(this, event->pos());
+        GuiSettings::globalInstance()->recordWindowPosition(this, event->pos());
     }
     QMainWindow::moveEvent(event);
 }
@@ -100,7 +103,7 @@ void MainWindowBase::resizeEvent(QResizeEvent *event)
 {
     // logText(LVL_DEBUG, QString("%1 - resize to %2").arg(objectName()).arg(Size(event->size()).toString()));
     if(_formLoadComplete && _persistSize) {
-        GuiSettings::globalInstance()->setLastWindowSize(this, event->size());
+        GuiSettings::globalInstance()->recordWindowSize(this, event->size());
     }
     QMainWindow::resizeEvent(event);
 }
@@ -141,6 +144,10 @@ void MainWindowBase::showEvent(QShowEvent *event)
                 else {
                     resize(geometryRect.size());
                     move(geometryRect.topLeft());
+                    // The normal geometry above is what the window returns to when un-maximized
+                    if(_persistSize && GuiSettings::globalInstance()->getLastWindowMaximized(this)) {
+                        setWindowState(windowState() | Qt::WindowMaximized);
+                    }
                 }
             }
         }
@@ -152,23 +159,17 @@ void MainWindowBase::showEvent(QShowEvent *event)
     QMainWindow::showEvent(event);
 }
 
-void MainWindowBase::onPreferencesChanged()
+void MainWindowBase::closeEvent(QCloseEvent* event)
 {
-    if(GuiSettings::globalInstance() == nullptr) {
-        return;
+    if(GuiSettings::globalInstance() != nullptr) {
+        GuiSettings::globalInstance()->flush();
     }
+    QMainWindow::closeEvent(event);
+}
 
-    QFont newFont(font());
-    int pointSize = GuiSettings::globalInstance()->fontSize();
-    newFont.setPointSize(pointSize);
-    setFont(newFont);
-
-    // Force all child widgets to update their fonts
-    for (QWidget* widget : findChildren<QWidget*>()) {
-        if (widget != this) { // Don't set font on self again
-            widget->setFont(newFont);
-        }
-    }
+void MainWindowBase::onPreferencesChanged()
+{
+    FontScaler::applyPreferredPointSize(this);
 }
 
 void MainWindowBase::onSpliltterMoved()
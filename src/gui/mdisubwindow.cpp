@@ -1,6 +1,7 @@
 #include "mdisubwindow.h"
 
 #include "guisettings.h"
+#include "utility/fontscaler.h"
 
 #include <QMenu>
 #include <QMoveEvent>
@@ -18,7 +19,7 @@ void MdiSubWindow::moveEvent(QMoveEvent* event)
 {
     // Log::logText(LVL_DEBUG, QString("%1: move to %2").arg(objectName()).arg(Point(event->pos()).toString()));
     if(GuiSettings::globalInstance() != nullptr) {
-        GuiSettings::globalInstance()->setLastWindowPosition(this, event->pos());
+        GuiSettings::globalInstance()->recordWindowPosition(this, event->pos());
     }
     QMdiSubWindow::moveEvent(event);
 }
@@ -27,7 +28,7 @@ void MdiSubWindow::resizeEvent(QResizeEvent* event)
 {
     // Log::logText(LVL_DEBUG, QString("%1: resize to %2").arg(objectName()).arg(Size(event->size()).toString()));
     if(GuiSettings::globalInstance() != nullptr) {
-        GuiSettings::globalInstance()->setLastWindowSize(this, event->size());
+        GuiSettings::globalInstance()->recordWindowSize(this, event->size());
     }
     QMdiSubWindow::resizeEvent(event);
 }
@@ -43,22 +44,15 @@ void MdiSubWindow::showEvent(QShowEvent* event)
 void MdiSubWindow::closeEvent(QCloseEvent* event)
 {
     emit closing();
+    if(GuiSettings::globalInstance() != nullptr) {
+        GuiSettings::globalInstance()->flush();
+    }
     QMdiSubWindow::closeEvent(event);
 }
 
 void MdiSubWindow::onPreferencesChanged()
 {
-    if(GuiSettings::globalInstance() != nullptr) {
-        QFont newFont(font());
-        int pointSize = GuiSettings::globalInstance()->fontSize();
-        newFont.setPointSize(pointSize);
-        setFont(newFont);
-
-        QList<QMenu*> menus = findChildren<QMenu*>();
-        for(QMenu* menu : menus) {
-            menu->setFont(newFont);
-        }
-    }
+    FontScaler::applyPreferredPointSize(this);
 }
 
 #include "Kanoop/gui/moc_mdisubwindow.cpp"
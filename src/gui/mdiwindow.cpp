@@ -54,7 +54,12 @@ MdiSubWindow* MdiWindow::openSubWindow(MainWindowBase* window, int type)
         mdiSubWindow->resize(size);
     }
 
-    mdiSubWindow->show();
+    if(window->persistSize() && GuiSettings::globalInstance()->getLastWindowMaximized(mdiSubWindow)) {
+        mdiSubWindow->showMaximized();
+    }
+    else {
+        mdiSubWindow->show();
+    }
     window->show();
 
     return mdiSubWindow;
@@ -6,7 +6,7 @@
 const Palette::ColorGroupToStringMap Palette::_ColorGroupToStringMap;
 const Palette::ColorRoleToStringMap Palette::_ColorRoleToStringMap;
 
-Palette Palette::fusionLight()
+static Palette buildFusionLight()
 {
     const QColor windowTextColor = Qt::black;
     const QColor backGroundColor = QColor(239, 239, 239);
@@ -55,7 +55,7 @@ Palette Palette::fusionLight()
     return palette;
 }
 
-Palette Palette::fusionDark()
+static Palette buildFusionDark()
 {
     const QColor windowTextColor = QColor(240, 240, 240);
     const QColor backGroundColor = QColor(50, 50, 50);
@@ -105,6 +105,19 @@ Palette Palette::fusionDark()
     return palette;
 }
 
+Palette Palette::fusionLight()
+{
+    // built once; theme switches copy the cached palette
+    static const Palette palette = buildFusionLight();
+    return palette;
+}
+
+Palette Palette::fusionDark()
+{
+    static const Palette palette = buildFusionDark();
+    return palette;
+}
+
 void Palette::debugDumpPalette(const Palette& palette)
 {
     static const QList<ColorRole> roles = {
@@ -0,0 +1,6 @@
+#include "resourceloader.h"
+
+ResourceLoader::ResourceLoader(QObject* parent) :
+    QObject(parent) {}
+
+#include "Kanoop/gui/moc_resourceloader.cpp"
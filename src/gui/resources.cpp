@@ -9,53 +9,329 @@
 **
 ******************************************************************************************/
 #include "resources.h"
+#include "resourceloader.h"
 
 #include <Kanoop/log.h>
 
+#include <QCoreApplication>
 #include <QIcon>
+#include <QImage>
 #include <QMutex>
+#include <QPainter>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QtMath>
 
 #include <Kanoop/pathutil.h>
 
+// Guards the registry, the caches and the statistics. Constant-initialized, so it is
+// ready before the static registration of the standard images below.
+static QMutex _lock;
+
 const Resources::StandardImageToStringMap Resources::_StandardImageToStringMap;
 
 QMap<int, QString> Resources::_registeredImages;
+QHash<Resources::PixmapKey, QPixmap> Resources::_pixmapCache;
+QHash<int, QIcon> Resources::_iconCache;
+quint64 Resources::_cacheHits = 0;
+quint64 Resources::_cacheMisses = 0;
+QSet<int> Resources::_loadingIds;
+int Resources::_loadingPlaceholderId = UnknownImage;
+bool Resources::_blockWhileLoading = false;
+QHash<quint64, Resources::Atlas> Resources::_atlases;
 bool Resources::_standardImagesRegistered = Resources::registerStandardImages();
 
 void Resources::registerImage(int id, const QString &resourcePath)
 {
-    static QMutex _lock;
-    _lock.lock();
+    {
+        QMutexLocker locker(&_lock);
+        registerImageLocked(id, resourcePath);
+        if(_atlases.isEmpty()) {
+            return;
+        }
+    }
+    addToAtlases(id);
+}
+
+void Resources::registerImageLocked(int id, const QString& resourcePath)
+{
     if(_registeredImages.contains(id) && _registeredImages.value(id) != resourcePath) {
         Log::logText(LVL_WARNING, QString("Replacing metadata type %1").arg(resourcePath));
+        for(auto it = _pixmapCache.begin();it != _pixmapCache.end();) {
+            if(it.key().id() == id) {
+                it = _pixmapCache.erase(it);
+            }
+            else {
+                it++;
+            }
+        }
+        _iconCache.remove(id);
     }
     _registeredImages.insert(id, resourcePath);
-    _lock.unlock();
-
 }
 
 QIcon Resources::getIcon(int id)
 {
-    QIcon result = QIcon(getPixmap(id));
+    QPixmap placeholder;
+    if(loadingPlaceholder(id, placeholder)) {
+        return placeholder.isNull() ? QIcon() : QIcon(placeholder);
+    }
+
+    {
+        QMutexLocker locker(&_lock);
+        auto it = _iconCache.constFind(id);
+        if(it != _iconCache.constEnd()) {
+            _cacheHits++;
+            return it.value();
+        }
+    }
+
+    QIcon result = QIcon(cachedPixmap(id, QSize(), 1.0));
     if(result.isNull()) {
         Log::logText(LVL_DEBUG, QString("No icon found for %1").arg(id));
+        return result;
     }
+
+    QMutexLocker locker(&_lock);
+    _iconCache.insert(id, result);
     return result;
 }
 
 QPixmap Resources::getPixmap(int id)
 {
+    return cachedPixmap(id, QSize(), 1.0);
+}
+
+QPixmap Resources::getPixmap(int id, const QSize& size, qreal devicePixelRatio)
+{
+    return cachedPixmap(id, size, devicePixelRatio);
+}
+
+void Resources::preload(const QList<int>& ids, const QList<QSize>& sizes, qreal devicePixelRatio)
+{
+    for(int id : ids) {
+        cachedPixmap(id, QSize(), 1.0);
+        for(const QSize& size : sizes) {
+            cachedPixmap(id, size, devicePixelRatio);
+        }
+    }
+}
+
+void Resources::preloadAsync(const QList<int>& ids)
+{
+    ResourceLoader* notifier = loader();
+
+    QList<QPair<int, QString>> jobs;
+    {
+        QMutexLocker locker(&_lock);
+        for(int id : ids) {
+            QString resourcePath = _registeredImages.value(id);
+            if(resourcePath.isEmpty() || _loadingIds.contains(id) || _pixmapCache.contains(PixmapKey(id, QSize(), 1.0))) {
+                continue;
+            }
+            _loadingIds.insert(id);
+            jobs.append(QPair<int, QString>(id, resourcePath));
+        }
+    }
+
+    if(jobs.isEmpty()) {
+        // deliver asynchronously all the same, so callers can connect after calling
+        QMetaObject::invokeMethod(notifier, [notifier, ids]() { emit notifier->preloadFinished(ids); }, Qt::QueuedConnection);
+        return;
+    }
+
+    // The notifier may be destroyed while the workers run. Results are posted to the
+    // application instead, which waits for the global pool before it goes away, and the
+    // notifier is only touched back on the GUI thread once it is known to be alive.
+    QPointer<ResourceLoader> guard(notifier);
+    // only touched from the GUI thread
+    QSharedPointer<int> remaining(new int(jobs.count()));
+    for(const QPair<int, QString>& job : jobs) {
+        int id = job.first;
+        QString resourcePath = job.second;
+        QThreadPool::globalInstance()->start([guard, id, resourcePath, remaining, ids]() {
+            QImage image(resourcePath);
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, id, image, remaining, ids]() {
+                completeLoad(id, image);
+                if(--(*remaining) == 0 && guard.isNull() == false) {
+                    emit guard->preloadFinished(ids);
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+bool Resources::isLoading(int id)
+{
+    QMutexLocker locker(&_lock);
+    return _loadingIds.contains(id);
+}
+
+ResourceLoader* Resources::loader()
+{
+    // Owned by the application; recreated if it has been destroyed along with it
+    static QPointer<ResourceLoader> _loader;
+    if(_loader.isNull()) {
+        _loader = new ResourceLoader(QCoreApplication::instance());
+    }
+    return _loader;
+}
+
+void Resources::setLoadingPlaceholder(int id)
+{
+    QMutexLocker locker(&_lock);
+    _loadingPlaceholderId = id;
+}
+
+void Resources::setBlockWhileLoading(bool value)
+{
+    QMutexLocker locker(&_lock);
+    _blockWhileLoading = value;
+}
+
+void Resources::createAtlas(const QSize& cellSize, qreal devicePixelRatio)
+{
+    if(cellSize.isEmpty()) {
+        return;
+    }
+
+    quint64 key = atlasKey(cellSize);
+    QList<int> ids;
+    {
+        QMutexLocker locker(&_lock);
+        Atlas atlas;
+        atlas.cellSize = cellSize;
+        atlas.devicePixelRatio = devicePixelRatio;
+        _atlases.insert(key, atlas);
+        ids = _registeredImages.keys();
+    }
+
+    for(int id : ids) {
+        addToAtlas(key, id);
+    }
+
+    QMutexLocker locker(&_lock);
+    const Atlas& atlas = _atlases[key];
+    Log::logText(LVL_DEBUG, QString("Packed %1 images into a %2x%3 atlas of %4x%5 cells")
+                 .arg(atlas.rects.count()).arg(atlas.pixmap.width()).arg(atlas.pixmap.height())
+                 .arg(cellSize.width()).arg(cellSize.height()));
+}
+
+bool Resources::hasAtlas(const QSize& cellSize)
+{
+    QMutexLocker locker(&_lock);
+    return _atlases.contains(atlasKey(cellSize));
+}
+
+QPixmap Resources::atlasPixmap(const QSize& cellSize)
+{
+    QMutexLocker locker(&_lock);
+    return _atlases.value(atlasKey(cellSize)).pixmap;
+}
+
+QRect Resources::atlasRect(int id, const QSize& cellSize)
+{
+    QMutexLocker locker(&_lock);
+    auto it = _atlases.constFind(atlasKey(cellSize));
+    if(it == _atlases.constEnd()) {
+        return QRect();
+    }
+    return it.value().rects.value(id);
+}
+
+bool Resources::drawAtlasImage(QPainter* painter, const QRect& target, int id, const QSize& cellSize)
+{
+    QPixmap pixmap;
+    QRect source;
+    {
+        QMutexLocker locker(&_lock);
+        auto it = _atlases.constFind(atlasKey(cellSize));
+        if(it == _atlases.constEnd()) {
+            return false;
+        }
+        source = it.value().rects.value(id);
+        pixmap = it.value().pixmap;
+    }
+
+    if(source.isNull()) {
+        return false;
+    }
+    painter->drawPixmap(target, pixmap, source);
+    return true;
+}
+
+void Resources::clearCache()
+{
+    QMutexLocker locker(&_lock);
+    _pixmapCache.clear();
+    _iconCache.clear();
+}
+
+quint64 Resources::cacheHits()
+{
+    QMutexLocker locker(&_lock);
+    return _cacheHits;
+}
+
+quint64 Resources::cacheMisses()
+{
+    QMutexLocker locker(&_lock);
+    return _cacheMisses;
+}
+
+void Resources::resetCacheStatistics()
+{
+    QMutexLocker locker(&_lock);
+    _cacheHits = 0;
+    _cacheMisses = 0;
+}
+
+QPixmap Resources::cachedPixmap(int id, const QSize& size, qreal devicePixelRatio)
+{
+    PixmapKey key(id, size, devicePixelRatio);
+    QString resourcePath;
+    QPixmap placeholder;
+    if(loadingPlaceholder(id, placeholder)) {
+        return placeholder;
+    }
+
+    {
+        QMutexLocker locker(&_lock);
+        auto it = _pixmapCache.constFind(key);
+        if(it != _pixmapCache.constEnd()) {
+            _cacheHits++;
+            return it.value();
+        }
+        _cacheMisses++;
+        resourcePath = _registeredImages.value(id);
+    }
+
     QPixmap result;
-    QString resourcePath = _registeredImages.value(id);
-    if(resourcePath.isEmpty() == false) {
-        result = QPixmap(resourcePath);
-        if(result.isNull()) {
-            Log::logText(LVL_DEBUG, QString("No registered resource found for %1").arg(id));
+    if(resourcePath.isEmpty()) {
+        Log::logText(LVL_DEBUG, QString("No resource Pixmap for id %1 from path %2").arg(id).arg(resourcePath));
+        return result;
+    }
+
+    // Decode outside the lock; scaled variants are derived from the cached original
+    if(size.isValid()) {
+        QPixmap original = cachedPixmap(id, QSize(), 1.0);
+        if(original.isNull() == false) {
+            result = original.scaled(size * devicePixelRatio, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            result.setDevicePixelRatio(devicePixelRatio);
         }
     }
     else {
-        Log::logText(LVL_DEBUG, QString("No resource Pixmap for id %1 from path %2").arg(id).arg(resourcePath));
+        result = QPixmap(resourcePath);
     }
+
+    if(result.isNull()) {
+        Log::logText(LVL_DEBUG, QString("No registered resource found for %1").arg(id));
+        return result;
+    }
+
+    QMutexLocker locker(&_lock);
+    _pixmapCache.insert(key, result);
     return result;
 }
 
@@ -68,3 +344,121 @@ bool Resources::registerStandardImages()
     }
     return true;
 }
+
+bool Resources::loadingPlaceholder(int id, QPixmap& placeholder)
+{
+    int placeholderId = UnknownImage;
+    {
+        QMutexLocker locker(&_lock);
+        if(_blockWhileLoading || _loadingIds.contains(id) == false) {
+            return false;
+        }
+        placeholderId = _loadingPlaceholderId;
+    }
+
+    if(placeholderId != UnknownImage && placeholderId != id) {
+        placeholder = cachedPixmap(placeholderId, QSize(), 1.0);
+    }
+    return true;
+}
+
+void Resources::completeLoad(int id, const QImage& image)
+{
+    QPixmap pixmap;
+    if(image.isNull() == false) {
+        pixmap = QPixmap::fromImage(image);
+    }
+
+    {
+        QMutexLocker locker(&_lock);
+        _loadingIds.remove(id);
+        PixmapKey key(id, QSize(), 1.0);
+        // a blocking caller may have decoded it already
+        if(pixmap.isNull() == false && _pixmapCache.contains(key) == false) {
+            _pixmapCache.insert(key, pixmap);
+        }
+    }
+
+    if(pixmap.isNull()) {
+        Log::logText(LVL_DEBUG, QString("Failed to decode resource %1 in the background").arg(id));
+        return;
+    }
+    addToAtlases(id);
+    emit loader()->imageReady(id);
+}
+
+void Resources::addToAtlases(int id)
+{
+    QList<quint64> keys;
+    {
+        QMutexLocker locker(&_lock);
+        keys = _atlases.keys();
+    }
+    for(quint64 key : keys) {
+        addToAtlas(key, id);
+    }
+}
+
+void Resources::addToAtlas(quint64 key, int id)
+{
+    QSize cellSize;
+    qreal devicePixelRatio = 1.0;
+    {
+        QMutexLocker locker(&_lock);
+        auto it = _atlases.constFind(key);
+        // images still loading are added by completeLoad()
+        if(it == _atlases.constEnd() || _loadingIds.contains(id)) {
+            return;
+        }
+        cellSize = it.value().cellSize;
+        devicePixelRatio = it.value().devicePixelRatio;
+    }
+
+    QPixmap pixmap = cachedPixmap(id, cellSize, devicePixelRatio);
+    if(pixmap.isNull()) {
+        return;
+    }
+
+    QMutexLocker locker(&_lock);
+    auto it = _atlases.find(key);
+    if(it != _atlases.end()) {
+        packIntoAtlas(it.value(), id, pixmap);
+    }
+}
+
+void Resources::packIntoAtlas(Atlas& atlas, int id, const QPixmap& pixmap)
+{
+    QSize cellPixels = atlas.cellSize * atlas.devicePixelRatio;
+    QRect rect = atlas.rects.value(id);
+    if(rect.isNull()) {
+        int index = atlas.rects.count();
+        rect = QRect(QPoint((index % AtlasColumns) * cellPixels.width(), (index / AtlasColumns) * cellPixels.height()), cellPixels);
+
+        if(atlas.pixmap.isNull() || rect.bottom() >= atlas.pixmap.height()) {
+            // Grow to the next power of two in each direction, keeping what is already packed
+            int width = qNextPowerOfTwo(static_cast<quint32>(AtlasColumns * cellPixels.width() - 1));
+            int height = atlas.pixmap.isNull() ? qNextPowerOfTwo(static_cast<quint32>(cellPixels.height() - 1)) : atlas.pixmap.height();
+            while(rect.bottom() >= height) {
+                height *= 2;
+            }
+            QPixmap grown(width, height);
+            grown.fill(Qt::transparent);
+            if(atlas.pixmap.isNull() == false) {
+                QPainter painter(&grown);
+                painter.drawPixmap(0, 0, atlas.pixmap);
+            }
+            atlas.pixmap = grown;
+        }
+        atlas.rects.insert(id, rect);
+    }
+
+    QPainter painter(&atlas.pixmap);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(rect, Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    // The scaled pixmap keeps its aspect ratio; center it in the cell
+    QRect target(QPoint(0, 0), pixmap.size());
+    target.moveCenter(rect.center());
+    painter.drawPixmap(target, pixmap);
+}
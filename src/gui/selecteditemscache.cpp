@@ -0,0 +1,84 @@
+#include "selecteditemscache.h"
+#include "abstractitemmodel.h"
+
+#include <QAbstractProxyModel>
+#include <QItemSelectionModel>
+#include <QSet>
+#include <QVarLengthArray>
+
+const AbstractModelItem::List& SelectedItemsCache::items(const QItemSelectionModel* selectionModel) const
+{
+    // Proxies between the view and the source model, outermost first
+    const QAbstractItemModel* model = selectionModel != nullptr ? selectionModel->model() : nullptr;
+    QVarLengthArray<const QAbstractProxyModel*, 4> proxyModels;
+    const QAbstractItemModel* sourceModel = model;
+    while(const QAbstractProxyModel* proxyModel = qobject_cast<const QAbstractProxyModel*>(sourceModel)) {
+        proxyModels.append(proxyModel);
+        sourceModel = proxyModel->sourceModel();
+    }
+
+    // A replaced selection model, view model or proxy source makes the result stale
+    if(_itemsValid && selectionModel == _selectionModel && model == _model && sourceModel == _sourceModel) {
+        return _items;
+    }
+
+    _items.clear();
+    _itemsValid = true;
+    _uuidsValid = false;
+    _selectionModel = selectionModel;
+    _model = model;
+    _sourceModel = sourceModel;
+    if(model == nullptr || qobject_cast<const AbstractItemModel*>(sourceModel) == nullptr) {
+        // internal pointers are only known to be AbstractModelItems for our own models
+        return _items;
+    }
+
+    const QItemSelection selection = selectionModel->selection();
+    bool checkDuplicates = selection.count() > 1;
+    QSet<AbstractModelItem*> seen;
+    for(const QItemSelectionRange& range : selection) {
+        for(int row = range.top();row <= range.bottom();row++) {
+            QModelIndex index = model->index(row, range.left(), range.parent());
+            for(const QAbstractProxyModel* proxyModel : proxyModels) {
+                index = proxyModel->mapToSource(index);
+            }
+            AbstractModelItem* item = static_cast<AbstractModelItem*>(index.internalPointer());
+            if(item == nullptr) {
+                continue;
+            }
+            // ranges covering different columns of the same row yield the item only once
+            if(checkDuplicates) {
+                if(seen.contains(item)) {
+                    continue;
+                }
+                seen.insert(item);
+            }
+            _items.append(item);
+        }
+    }
+    return _items;
+}
+
+const QList<QUuid>& SelectedItemsCache::uuids(const QItemSelectionModel* selectionModel) const
+{
+    const AbstractModelItem::List& selected = items(selectionModel);
+    if(_uuidsValid) {
+        return _uuids;
+    }
+
+    _uuids.clear();
+    _uuids.reserve(selected.count());
+    for(const AbstractModelItem* item : selected) {
+        _uuids.append(item->uuid());
+    }
+    _uuidsValid = true;
+    return _uuids;
+}
+
+void SelectedItemsCache::invalidate()
+{
+    _itemsValid = false;
+    _uuidsValid = false;
+    _items.clear();
+    _uuids.clear();
+}
@@ -251,6 +251,18 @@ void TableViewBase::currentChanged(const QModelIndex& current, const QModelIndex
     emit currentIndexChanged(current, previous);
 }
 
+void TableViewBase::reset()
+{
+    _selectedItems.invalidate();
+    QTableView::reset();
+}
+
+void TableViewBase::selectionChanged(const QItemSelection& selected, const QItemSelection& deselected)
+{
+    _selectedItems.invalidate();
+    QTableView::selectionChanged(selected, deselected);
+}
+
 void TableViewBase::onHorizontalHeaderResized(int, int, int)
 {
     if(GuiSettings::globalInstance() != nullptr && model() != nullptr) {
@@ -3,14 +3,31 @@
 TreeSelectionModel::TreeSelectionModel(QAbstractItemModel* model, QObject* parent) :
     QItemSelectionModel(model, parent)
 {
+    connect(this, &TreeSelectionModel::selectionChanged, this, &TreeSelectionModel::invalidateSelectionParent);
+    connect(this, &TreeSelectionModel::modelChanged, this, &TreeSelectionModel::connectModelSignals);
+    connectModelSignals();
+}
+
+QModelIndex TreeSelectionModel::selectionParent() const
+{
+    if(hasSelection() == false) {
+        return QModelIndex();
+    }
+
+    if(_selectionParentValid == false) {
+        // All ranges share a parent, so the first one is enough
+        const QItemSelection current = selection();
+        _selectionParent = current.isEmpty() ? QModelIndex() : current.first().parent();
+        _selectionParentValid = true;
+    }
+    return _selectionParent;
 }
 
 void TreeSelectionModel::select(const QModelIndex& index, SelectionFlags command)
 {
     QModelIndex parentIndex = index.parent();
-    QModelIndexList selectedIndexes = selection().indexes();
 
-    if (selectedIndexes.isEmpty() || selectedIndexes.first().parent() == parentIndex) {
+    if (hasSelection() == false || selectionParent() == parentIndex) {
         // Allow selection if no items are selected, or if the new item shares the same parent.
         QItemSelectionModel::select(index, command);
     } else {
@@ -23,18 +40,23 @@ void TreeSelectionModel::select(const QModelIndex& index, SelectionFlags command
 void TreeSelectionModel::select(const QItemSelection& selection, SelectionFlags command)
 {
     if(selection.count() > 0) {
-        QModelIndexList indexes = selection.indexes();
-        QModelIndex parent = indexes.at(0).parent();
-        bool haveSameParent = true;
-        for(const QModelIndex& index : indexes) {
-            if(index.parent() != parent) {
-                haveSameParent = false;
+        // Compare range parents only; every index within a range shares its parent
+        QModelIndex parent = selection.first().parent();
+        for(const QItemSelectionRange& range : selection) {
+            if(range.parent() != parent) {
                 clearSelection();
+                return;
             }
         }
 
-        if(haveSameParent) {
-            QItemSelectionModel::select(selection, command);
+        bool hadSelection = hasSelection();
+        QItemSelectionModel::select(selection, command);
+
+        // When the new ranges replace (or start) the selection, we already know its parent
+        if(command.testAnyFlags(Deselect | Toggle) == false && command.testFlag(Select) &&
+           (command.testFlag(Clear) || hadSelection == false)) {
+            _selectionParent = parent;
+            _selectionParentValid = true;
         }
     }
     else {
@@ -42,4 +64,18 @@ void TreeSelectionModel::select(const QItemSelection& selection, SelectionFlags
     }
 }
 
+void TreeSelectionModel::connectModelSignals()
+{
+    invalidateSelectionParent();
+    if(model() != nullptr) {
+        connect(model(), &QAbstractItemModel::modelReset, this, &TreeSelectionModel::invalidateSelectionParent, Qt::UniqueConnection);
+        connect(model(), &QAbstractItemModel::layoutChanged, this, &TreeSelectionModel::invalidateSelectionParent, Qt::UniqueConnection);
+    }
+}
+
+void TreeSelectionModel::invalidateSelectionParent()
+{
+    _selectionParentValid = false;
+}
+
 #include "Kanoop/gui/moc_treeselectionmodel.cpp"
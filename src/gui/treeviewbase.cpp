@@ -10,6 +10,8 @@
 ******************************************************************************************/
 #include "columnsettingsdialog.h"
 
+#include <QDataStream>
+#include <QElapsedTimer>
 #include <QMenu>
 #include <QSortFilterProxyModel>
 #include "abstractitemmodel.h"
@@ -45,6 +47,14 @@ TreeViewBase::TreeViewBase(QWidget *parent) :
     connect(_actionHideCol, &QAction::triggered, this, &TreeViewBase::onHideColumnClicked);
     connect(_actionAutoResizeCols, &QAction::triggered, this, &TreeViewBase::onAutoResizeColumnsClicked);
     connect(_actionResetCols, &QAction::triggered, this, &TreeViewBase::onResetColumnsClicked);
+
+    _restoreTimer.setSingleShot(true);
+    _restoreTimer.setInterval(0);
+    connect(&_restoreTimer, &QTimer::timeout, this, &TreeViewBase::onRestoreTimer);
+
+    _restoreIdleTimer.setSingleShot(true);
+    _restoreIdleTimer.setInterval(DefaultRestoreIdleTimeout);
+    connect(&_restoreIdleTimer, &QTimer::timeout, this, &TreeViewBase::onRestoreIdleTimer);
 }
 
 int TreeViewBase::entityTypeAtPos(const QPoint &pos)
@@ -233,41 +243,215 @@ QModelIndex TreeViewBase::currentSourceIndex() const
     return result;
 }
 
-QByteArray TreeViewBase::saveState() const
+// Binary tree state layout (version 1):
+//   "KTVS" | quint8 version | quint8 flags | payload
+// payload (optionally qCompress'ed):
+//   quint32 expandedCount | expanded UUIDs (16 bytes each)
+//   quint32 selectedCount | selected UUIDs (16 bytes each)
+//   current UUID (16 bytes) | scroll anchor UUID (16 bytes)
+static const QByteArray StateMagic = QByteArrayLiteral("KTVS");
+static const quint8 StateVersion = 1;
+static const quint8 StateFlagCompressed = 0x01;
+static const int StateHeaderSize = 6;
+static const int DefaultCompressionThreshold = 1024;
+
+static void writeUuids(QDataStream& stream, const QSet<QUuid>& uuids)
+{
+    stream << static_cast<quint32>(uuids.count());
+    for(const QUuid& uuid : uuids) {
+        QByteArray raw = uuid.toRfc4122();
+        stream.writeRawData(raw.constData(), raw.size());
+    }
+}
+
+static QUuid readUuid(QDataStream& stream)
+{
+    char raw[16];
+    if(stream.readRawData(raw, sizeof(raw)) != sizeof(raw)) {
+        stream.setStatus(QDataStream::ReadPastEnd);
+        return QUuid();
+    }
+    return QUuid::fromRfc4122(QByteArrayView(raw, sizeof(raw)));
+}
+
+static QSet<QUuid> readUuids(QDataStream& stream)
+{
+    QSet<QUuid> result;
+    quint32 count = 0;
+    stream >> count;
+    // never trust the count more than the bytes actually available
+    if(stream.device() != nullptr && count > stream.device()->bytesAvailable() / 16) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+        return result;
+    }
+    result.reserve(count);
+    for(quint32 i = 0;i < count && stream.status() == QDataStream::Ok;i++) {
+        result.insert(readUuid(stream));
+    }
+    return result;
+}
+
+QByteArray TreeViewBase::saveState(bool allowCompression) const
 {
     QByteArray result;
-    AbstractItemModel* itemModel = dynamic_cast<AbstractItemModel*>(model());
-    if(itemModel != nullptr) {
-        QList<QUuid> uuids;
-        QModelIndexList persistentIndexes = itemModel->getPersistentIndexes();
-        for(const QModelIndex& index : persistentIndexes) {
-            if(isExpanded(index)) {
-                QUuid uuid = index.data(KANOOP::UUidRole).toUuid();
-                if(uuid.isNull() == false) {
-                    uuids.append(uuid);
-                }
-            }
-        }
+    if(model() == nullptr) {
+        return result;
+    }
 
-        result = StringUtil::toString(uuids).toUtf8();
+    QSet<QUuid> selected = selectedRowUuids();
+    QUuid current = currentIndex().data(KANOOP::UUidRole).toUuid();
+    QUuid anchor = indexAt(QPoint(0, 0)).data(KANOOP::UUidRole).toUuid();
+
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    writeUuids(stream, expandedUuids());
+    writeUuids(stream, selected);
+    stream.writeRawData(current.toRfc4122().constData(), 16);
+    stream.writeRawData(anchor.toRfc4122().constData(), 16);
+
+    quint8 flags = 0;
+    if(allowCompression && payload.size() > DefaultCompressionThreshold) {
+        payload = qCompress(payload);
+        flags |= StateFlagCompressed;
     }
+
+    result.reserve(StateHeaderSize + payload.size());
+    result.append(StateMagic);
+    result.append(static_cast<char>(StateVersion));
+    result.append(static_cast<char>(flags));
+    result.append(payload);
     return result;
 }
 
 void TreeViewBase::restoreState(const QByteArray &state)
 {
-    AbstractItemModel* itemModel = dynamic_cast<AbstractItemModel*>(model());
-    if(itemModel == nullptr) {
+    if(model() == nullptr) {
         return;
     }
-    QList<QUuid> uuids = StringUtil::uuidsFromString(QString(state));
-    for(const QUuid& uuid : uuids) {
-        QModelIndex index = itemModel->firstIndexOfEntityUuid(uuid);
-        if(index.isValid()) {
-            scrollTo(index, EnsureVisible);
-            expand(index);
+
+    TreeState parsed;
+    if(parseState(state, parsed) == false) {
+        return;
+    }
+
+    // Resolve everything we need in a single pass over the tree
+    QSet<QUuid> wanted = parsed.expanded;
+    wanted.unite(parsed.selected);
+    wanted.insert(parsed.current);
+    wanted.insert(parsed.anchor);
+    wanted.remove(QUuid());
+
+    QModelIndexList expandIndexes;
+    QItemSelection selection;
+    QModelIndex currentIdx;
+    QModelIndex anchorIdx;
+    const QModelIndexList indexes = indexesOfUuids(wanted);
+    for(const QModelIndex& index : indexes) {
+        QUuid uuid = index.data(KANOOP::UUidRole).toUuid();
+        if(parsed.expanded.contains(uuid)) {
+            expandIndexes.append(index);
+        }
+        if(parsed.selected.contains(uuid)) {
+            selection.select(index, index);
+        }
+        if(uuid == parsed.current && currentIdx.isValid() == false) {
+            currentIdx = index;
+        }
+        if(uuid == parsed.anchor && anchorIdx.isValid() == false) {
+            anchorIdx = index;
         }
     }
+
+    beginBulkExpansion();
+    for(const QModelIndex& index : expandIndexes) {
+        expand(index);
+    }
+    endBulkExpansion();
+
+    if(selectionModel() != nullptr) {
+        if(selection.isEmpty() == false) {
+            selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+        }
+        if(currentIdx.isValid()) {
+            selectionModel()->setCurrentIndex(currentIdx, QItemSelectionModel::NoUpdate);
+        }
+    }
+    if(anchorIdx.isValid()) {
+        scrollTo(anchorIdx, PositionAtTop);
+    }
+    // The saved top row wins, but never at the cost of hiding the current item
+    if(currentIdx.isValid()) {
+        scrollTo(currentIdx, EnsureVisible);
+    }
+}
+
+void TreeViewBase::restoreStateIncrementally(const QByteArray& state)
+{
+    cancelPendingRestore();
+
+    TreeState parsed;
+    if(parseState(state, parsed) == false) {
+        return;
+    }
+
+    _savedState = parsed;
+    _pendingState = parsed;
+    _restoreSelectionCleared = false;
+    _restorePending = true;
+
+    if(_pendingState.isResolved()) {
+        finishPendingRestore(true);
+        return;
+    }
+
+    if(model() != nullptr) {
+        enqueuePendingRows(QModelIndex(), 0, model()->rowCount() - 1);
+    }
+}
+
+void TreeViewBase::cancelPendingRestore()
+{
+    if(_restorePending) {
+        finishPendingRestore(false);
+    }
+}
+
+bool TreeViewBase::parseState(const QByteArray& state, TreeState& result) const
+{
+    if(state.startsWith(StateMagic) == false) {
+        // legacy string format: a list of expanded UUIDs
+        QList<QUuid> uuids = StringUtil::uuidsFromString(QString(state));
+        result.expanded = QSet<QUuid>(uuids.begin(), uuids.end());
+        return true;
+    }
+
+    if(state.size() < StateHeaderSize) {
+        logText(LVL_WARNING, "Truncated tree view state");
+        return false;
+    }
+
+    quint8 version = static_cast<quint8>(state.at(4));
+    quint8 flags = static_cast<quint8>(state.at(5));
+    if(version > StateVersion) {
+        logText(LVL_WARNING, QString("Unsupported tree view state version %1").arg(version));
+        return false;
+    }
+
+    QByteArray payload = state.mid(StateHeaderSize);
+    if(flags & StateFlagCompressed) {
+        payload = qUncompress(payload);
+    }
+
+    QDataStream stream(payload);
+    result.expanded = readUuids(stream);
+    result.selected = readUuids(stream);
+    result.current = readUuid(stream);
+    result.anchor = readUuid(stream);
+    if(stream.status() != QDataStream::Ok) {
+        logText(LVL_WARNING, "Corrupt tree view state");
+        return false;
+    }
+    return true;
 }
 
 void TreeViewBase::restoreHeaderStates()
@@ -280,6 +464,7 @@ void TreeViewBase::restoreHeaderStates()
 
 void TreeViewBase::setModel(QAbstractItemModel* model)
 {
+    cancelPendingRestore();
     QSortFilterProxyModel* proxyModel = dynamic_cast<QSortFilterProxyModel*>(model);
     if(proxyModel == nullptr) {
         QTreeView::setModel(model);
@@ -307,14 +492,29 @@ void TreeViewBase::setSelectionModel(QItemSelectionModel* selectionModel)
 
 void TreeViewBase::collapseRecursively(const QModelIndex& index, int depth)
 {
-    collapse(index);
-    int rows = model()->rowCount(index);
-    if(depth != 0) {
+    if(model() == nullptr) {
+        return;
+    }
+
+    beginBulkExpansion();
+    QList<QPair<QModelIndex, int>> stack;
+    stack.append(QPair<QModelIndex, int>(index, depth));
+    while(stack.isEmpty() == false) {
+        QPair<QModelIndex, int> entry = stack.takeLast();
+        collapse(entry.first);
+        if(entry.second == 0) {
+            continue;
+        }
+        int childDepth = entry.second < 0 ? -1 : entry.second - 1;
+        int rows = model()->rowCount(entry.first);
         for(int row = 0;row < rows;row++) {
-            QModelIndex child = model()->index(row, 0, index);
-            collapseRecursively(child, depth < 0 ? -1 : depth - 1);
+            QModelIndex child = model()->index(row, 0, entry.first);
+            if(model()->hasChildren(child)) {
+                stack.append(QPair<QModelIndex, int>(child, childDepth));
+            }
         }
     }
+    endBulkExpansion();
 }
 
 bool TreeViewBase::isLeafExpanded(const QModelIndex& index, bool recursive) const
@@ -323,27 +523,131 @@ bool TreeViewBase::isLeafExpanded(const QModelIndex& index, bool recursive) cons
         return false;
     }
 
-    bool result = isExpanded(index);
-    if(result == false) {
+    if(isExpanded(index) == false) {
         return false;
     }
 
     if(recursive == false) {
-        return result;
+        return true;
     }
 
-    int rowCount = model()->rowCount(index);
-    for(int row = 0;row < rowCount;row++) {
-        QModelIndex childIndex = model()->index(row, 0, index);
-        if (childIndex.isValid()) {
-            if(isLeafExpanded(childIndex, recursive) == false) {
-                return false;
+    QModelIndexList stack;
+    stack.append(index);
+    while(stack.isEmpty() == false) {
+        QModelIndex parentIndex = stack.takeLast();
+        int rowCount = model()->rowCount(parentIndex);
+        for(int row = 0;row < rowCount;row++) {
+            QModelIndex childIndex = model()->index(row, 0, parentIndex);
+            if(childIndex.isValid()) {
+                if(isExpanded(childIndex) == false) {
+                    return false;
+                }
+                stack.append(childIndex);
             }
         }
     }
     return true;
 }
 
+QModelIndexList TreeViewBase::indexesOfUuids(const QSet<QUuid>& uuids) const
+{
+    QModelIndexList result;
+    if(model() == nullptr || uuids.isEmpty()) {
+        return result;
+    }
+
+    QModelIndexList stack;
+    stack.append(QModelIndex());
+    while(stack.isEmpty() == false) {
+        QModelIndex parentIndex = stack.takeLast();
+        int rows = model()->rowCount(parentIndex);
+        for(int row = 0;row < rows;row++) {
+            QModelIndex index = model()->index(row, 0, parentIndex);
+            if(uuids.contains(index.data(KANOOP::UUidRole).toUuid())) {
+                result.append(index);
+            }
+            if(model()->hasChildren(index)) {
+                stack.append(index);
+            }
+        }
+    }
+    return result;
+}
+
+QSet<QUuid> TreeViewBase::expandedUuids() const
+{
+    QSet<QUuid> result;
+    if(model() == nullptr) {
+        return result;
+    }
+
+    // Walk the whole tree; QTreeView remembers expanded items beneath collapsed parents too
+    QModelIndexList stack;
+    stack.append(QModelIndex());
+    while(stack.isEmpty() == false) {
+        QModelIndex parentIndex = stack.takeLast();
+        int rows = model()->rowCount(parentIndex);
+        for(int row = 0;row < rows;row++) {
+            QModelIndex index = model()->index(row, 0, parentIndex);
+            if(model()->hasChildren(index) == false) {
+                continue;
+            }
+            if(isExpanded(index)) {
+                QUuid uuid = index.data(KANOOP::UUidRole).toUuid();
+                if(uuid.isNull() == false) {
+                    result.insert(uuid);
+                }
+            }
+            stack.append(index);
+        }
+    }
+    return result;
+}
+
+QSet<QUuid> TreeViewBase::selectedRowUuids() const
+{
+    QSet<QUuid> result;
+    if(selectionModel() == nullptr) {
+        return result;
+    }
+
+    const QItemSelection selection = selectionModel()->selection();
+    for(const QItemSelectionRange& range : selection) {
+        for(int row = range.top();row <= range.bottom();row++) {
+            QUuid uuid = model()->index(row, 0, range.parent()).data(KANOOP::UUidRole).toUuid();
+            if(uuid.isNull() == false) {
+                result.insert(uuid);
+            }
+        }
+    }
+    return result;
+}
+
+void TreeViewBase::expandUuids(const QSet<QUuid>& uuids)
+{
+    setUuidsExpanded(uuids, true);
+}
+
+void TreeViewBase::collapseUuids(const QSet<QUuid>& uuids)
+{
+    setUuidsExpanded(uuids, false);
+}
+
+void TreeViewBase::setExpandedUuids(const QSet<QUuid>& uuids)
+{
+    if(model() == nullptr) {
+        return;
+    }
+
+    QModelIndexList indexes = indexesOfUuids(uuids);
+    beginBulkExpansion();
+    collapseAll();
+    for(const QModelIndex& index : indexes) {
+        expand(index);
+    }
+    endBulkExpansion();
+}
+
 bool TreeViewBase::isIndexVisible(const QModelIndex& index) const
 {
     Rectangle rectForIndex = visualRect(index);
@@ -499,6 +803,39 @@ void TreeViewBase::clear()
     }
 }
 
+void TreeViewBase::reset()
+{
+    _selectedItems.invalidate();
+    QTreeView::reset();
+
+    if(_restorePending) {
+        // Everything applied so far is gone; start over against the new contents
+        _pendingRows.clear();
+        _queuedParents.clear();
+        _restoreAnchor = QPersistentModelIndex();
+        _pendingState = _savedState;
+        _restoreSelectionCleared = false;
+        _restoreAwaitingFetch = false;
+        if(model() != nullptr) {
+            enqueuePendingRows(QModelIndex(), 0, model()->rowCount() - 1);
+        }
+    }
+}
+
+void TreeViewBase::selectionChanged(const QItemSelection& selected, const QItemSelection& deselected)
+{
+    _selectedItems.invalidate();
+    QTreeView::selectionChanged(selected, deselected);
+}
+
+void TreeViewBase::rowsInserted(const QModelIndex& parent, int start, int end)
+{
+    QTreeView::rowsInserted(parent, start, end);
+    if(_restorePending) {
+        enqueuePendingRows(parent, start, end);
+    }
+}
+
 EntityMetadata TreeViewBase::findCurrentParent(int entityMetadataType) const
 {
     return findFirstParent(currentIndex(), entityMetadataType);
@@ -597,6 +934,198 @@ bool TreeViewBase::testMatch(const QModelIndex& index, int role, const QVariant&
     return false;
 }
 
+void TreeViewBase::beginBulkExpansion()
+{
+    if(_bulkExpansionDepth++ == 0) {
+        setUpdatesEnabled(false);
+        // With a layout pending, QTreeView only records expand/collapse
+        // requests instead of laying out the rows for each one
+        scheduleDelayedItemsLayout();
+    }
+}
+
+void TreeViewBase::endBulkExpansion()
+{
+    if(--_bulkExpansionDepth == 0) {
+        executeDelayedItemsLayout();
+        setUpdatesEnabled(true);
+    }
+}
+
+void TreeViewBase::setUuidsExpanded(const QSet<QUuid>& uuids, bool expanded)
+{
+    QModelIndexList indexes = indexesOfUuids(uuids);
+    if(indexes.isEmpty()) {
+        return;
+    }
+
+    beginBulkExpansion();
+    for(const QModelIndex& index : indexes) {
+        setExpanded(index, expanded);
+    }
+    endBulkExpansion();
+}
+
+void TreeViewBase::enqueuePendingRows(const QModelIndex& parent, int first, int last)
+{
+    if(last < first) {
+        return;
+    }
+
+    PendingRows rows;
+    rows.parent = parent;
+    rows.isRoot = parent.isValid() == false;
+    rows.first = first;
+    rows.last = last;
+
+    // Fold in ranges already queued for this parent so a subtree is not walked twice
+    if(_queuedParents.contains(rows.parent)) {
+        for(int i = _pendingRows.count() - 1;i >= 0;i--) {
+            const PendingRows& queued = _pendingRows.at(i);
+            if(queued.isRoot == rows.isRoot && queued.parent == rows.parent &&
+               queued.first <= rows.last + 1 && rows.first <= queued.last + 1) {
+                rows.first = qMin(rows.first, queued.first);
+                rows.last = qMax(rows.last, queued.last);
+                _pendingRows.removeAt(i);
+            }
+        }
+    }
+    _queuedParents.insert(rows.parent);
+    _pendingRows.append(rows);
+
+    _restoreIdleTimer.stop();
+    if(_restoreTimer.isActive() == false) {
+        _restoreTimer.start();
+    }
+}
+
+void TreeViewBase::finishPendingRestore(bool complete)
+{
+    _restoreTimer.stop();
+    _restoreIdleTimer.stop();
+    _pendingRows.clear();
+    _queuedParents.clear();
+    _restorePending = false;
+    _restoreAwaitingFetch = false;
+
+    if(complete && _restoreAnchor.isValid()) {
+        scrollTo(_restoreAnchor, PositionAtTop);
+    }
+
+    _restoreAnchor = QPersistentModelIndex();
+    _savedState = TreeState();
+    _pendingState = TreeState();
+    emit stateRestoreFinished(complete);
+}
+
+void TreeViewBase::onRestoreTimer()
+{
+    QAbstractItemModel* itemModel = model();
+    if(itemModel == nullptr) {
+        return;
+    }
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    QModelIndexList expandIndexes;
+    QItemSelection selection;
+    bool sliceExpired = false;
+    while(_pendingRows.isEmpty() == false && _pendingState.isResolved() == false && sliceExpired == false) {
+        PendingRows rows = _pendingRows.takeFirst();
+        _queuedParents.remove(rows.parent);
+        QModelIndex parent = rows.parent;
+        if(rows.isRoot == false && parent.isValid() == false) {
+            // parent was removed while queued
+            continue;
+        }
+
+        int rowCount = itemModel->rowCount(parent);
+        int last = qMin(rows.last, rowCount - 1);
+        for(int row = rows.first;row <= last;row++) {
+            QModelIndex index = itemModel->index(row, 0, parent);
+            QUuid uuid = index.data(KANOOP::UUidRole).toUuid();
+            if(uuid.isNull() == false) {
+                if(_pendingState.expanded.remove(uuid)) {
+                    expandIndexes.append(index);
+                }
+                if(_pendingState.selected.remove(uuid)) {
+                    selection.select(index, index);
+                }
+                if(uuid == _pendingState.current) {
+                    if(selectionModel() != nullptr) {
+                        selectionModel()->setCurrentIndex(index, QItemSelectionModel::NoUpdate);
+                    }
+                    _pendingState.current = QUuid();
+                }
+                if(uuid == _pendingState.anchor) {
+                    _restoreAnchor = index;
+                    _pendingState.anchor = QUuid();
+                }
+            }
+
+            // Lazily fetched children arrive later through rowsInserted()
+            enqueuePendingRows(index, 0, itemModel->rowCount(index) - 1);
+
+            if((row & 0x3f) == 0 && elapsed.hasExpired(_restoreTimeSlice)) {
+                if(row < last) {
+                    rows.first = row + 1;
+                    _queuedParents.insert(rows.parent);
+                    _pendingRows.prepend(rows);
+                }
+                sliceExpired = true;
+                break;
+            }
+        }
+    }
+
+    // Expanding may fetch children, which re-enters through rowsInserted()
+    if(expandIndexes.isEmpty() == false) {
+        beginBulkExpansion();
+        for(const QModelIndex& index : expandIndexes) {
+            if(itemModel->canFetchMore(index)) {
+                _restoreAwaitingFetch = true;
+            }
+            expand(index);
+        }
+        endBulkExpansion();
+    }
+
+    if(selection.isEmpty() == false && selectionModel() != nullptr) {
+        QItemSelectionModel::SelectionFlags command = _restoreSelectionCleared ? QItemSelectionModel::Select : QItemSelectionModel::ClearAndSelect;
+        selectionModel()->select(selection, command | QItemSelectionModel::Rows);
+        _restoreSelectionCleared = true;
+    }
+
+    if(_pendingState.isResolved()) {
+        finishPendingRestore(true);
+    }
+    else if(_pendingRows.isEmpty() == false) {
+        _restoreTimer.start();
+    }
+    else {
+        // Caught up with the model; keep the saved top row in place
+        if(_restoreAnchor.isValid()) {
+            scrollTo(_restoreAnchor, PositionAtTop);
+        }
+        if(_restoreAwaitingFetch) {
+            // a lazy fetch may still deliver rows through rowsInserted()
+            _restoreIdleTimer.start();
+        }
+        else {
+            // the whole model has been walked; the remaining items no longer exist
+            finishPendingRestore(false);
+        }
+    }
+}
+
+void TreeViewBase::onRestoreIdleTimer()
+{
+    if(_restorePending && _pendingRows.isEmpty()) {
+        finishPendingRestore(false);
+    }
+}
+
 void TreeViewBase::onHorizontalHeaderResized(int, int, int)
 {
     if(GuiSettings::globalInstance() != nullptr && model() != nullptr) {
@@ -0,0 +1,63 @@
+#include "utility/fontscaler.h"
+#include "guisettings.h"
+
+#include <QWidget>
+
+const char* FontScaler::ScaledProperty = "_kanoopFontScaled";
+
+int FontScaler::applyPointSize(QWidget* root, int pointSize)
+{
+    int result = 0;
+    if(root == nullptr || pointSize <= 0) {
+        return result;
+    }
+
+    bool suspendUpdates = root->updatesEnabled();
+    if(suspendUpdates) {
+        root->setUpdatesEnabled(false);
+    }
+
+    if(setPointSize(root, pointSize)) {
+        result++;
+    }
+
+    // Children already picked up the new size from the root, unless they were sized on purpose.
+    // Windows only inherit from their parent when they ask to, so menus and popups are visited.
+    const QList<QWidget*> children = root->findChildren<QWidget*>();
+    for(QWidget* widget : children) {
+        if(widget->isWindow() == false || widget->testAttribute(Qt::WA_WindowPropagation)) {
+            continue;
+        }
+        bool explicitlySized = (widget->font().resolveMask() & QFont::SizeResolved) != 0 &&
+                               widget->property(ScaledProperty).toBool() == false;
+        if(explicitlySized == false && setPointSize(widget, pointSize)) {
+            widget->setProperty(ScaledProperty, true);
+            result++;
+        }
+    }
+
+    if(suspendUpdates) {
+        root->setUpdatesEnabled(true);
+    }
+    return result;
+}
+
+int FontScaler::applyPreferredPointSize(QWidget* root)
+{
+    if(GuiSettings::globalInstance() == nullptr) {
+        return 0;
+    }
+    return applyPointSize(root, GuiSettings::globalInstance()->fontSize());
+}
+
+bool FontScaler::setPointSize(QWidget* widget, int pointSize)
+{
+    QFont font = widget->font();
+    // Pixel-sized fonts were sized deliberately; leave them alone
+    if(font.pointSize() < 0 || font.pointSize() == pointSize) {
+        return false;
+    }
+    font.setPointSize(pointSize);
+    widget->setFont(font);
+    return true;
+}
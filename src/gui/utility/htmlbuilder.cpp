@@ -1,77 +1,165 @@
 #include "utility/htmlbuilder.h"
 
+#include <QAbstractItemModel>
 
-HtmlBuilder::HtmlBuilder() :
-    _output(&_result)
+HtmlBuilder::HtmlBuilder(qsizetype reserveSize)
 {
+    _result.reserve(reserveSize);
 }
 
 void HtmlBuilder::startParagraph(const QColor& color, const QColor& backgroundColor)
 {
-    _output << HtmlUtil::startParagraph(color, backgroundColor);
+    _result.append(QLatin1StringView("<p"));
+    if(color.isValid()) {
+        _result.append(QLatin1StringView(" style=\"color: ")).append(color.name(QColor::HexArgb)).append(QLatin1Char(';'));
+        if(backgroundColor.isValid()) {
+            _result.append(QLatin1StringView("background-color: ")).append(backgroundColor.name(QColor::HexArgb)).append(QLatin1Char(';'));
+        }
+        _result.append(QLatin1Char('\"'));
+    }
+    _result.append(QLatin1Char('>'));
 }
 
 void HtmlBuilder::endParagraph()
 {
-    _output << HtmlUtil::endParagraph();
+    _result.append(QLatin1StringView("</p>"));
 }
 
 void HtmlBuilder::startBold()
 {
-    _output << HtmlUtil::startBold();
+    _result.append(QLatin1StringView("<b>"));
 }
 
 void HtmlBuilder::endBold()
 {
-    _output << HtmlUtil::endBold();
+    _result.append(QLatin1StringView("</b>"));
 }
 
 void HtmlBuilder::startStrong()
 {
-    _output << HtmlUtil::startStrong();
+    _result.append(QLatin1StringView("<strong>"));
 }
 
 void HtmlBuilder::endStrong()
 {
-    _output << HtmlUtil::endStrong();
+    _result.append(QLatin1StringView("</strong>"));
 }
 
 void HtmlBuilder::startTable(int cellPadding, int cellSpacing)
 {
-    _output << HtmlUtil::startTable(cellPadding, cellSpacing);
+    _result.append(QLatin1StringView("<table cellpadding=\"")).append(QString::number(cellPadding))
+           .append(QLatin1StringView("\" cellspacing=\"")).append(QString::number(cellSpacing))
+           .append(QLatin1StringView("\">"));
 }
 
 void HtmlBuilder::endTable()
 {
-    _output << HtmlUtil::endTable();
+    _result.append(QLatin1StringView("</table>"));
 }
 
 void HtmlBuilder::startRow()
 {
-    _output << HtmlUtil::startRow();
+    _result.append(QLatin1StringView("<tr>"));
 }
 
 void HtmlBuilder::endRow()
 {
-    _output << HtmlUtil::endRow();
+    _result.append(QLatin1StringView("</tr>"));
 }
 
 void HtmlBuilder::startCell(Qt::Alignment alignment)
 {
-    _output << HtmlUtil::startCell(alignment);
+    appendAlignedTag(QLatin1StringView("td"), alignment);
 }
 
 void HtmlBuilder::endCell()
 {
-    _output << HtmlUtil::endCell();
+    _result.append(QLatin1StringView("</td>"));
 }
 
 void HtmlBuilder::appendCell(const QString& text, Qt::Alignment alignment)
 {
-    _output << HtmlUtil::startCell(alignment) << HtmlUtil::escape(text) << HtmlUtil::endCell();
+    appendAlignedTag(QLatin1StringView("td"), alignment);
+    HtmlUtil::appendEscaped(_result, text);
+    _result.append(QLatin1StringView("</td>"));
+}
+
+void HtmlBuilder::appendRow(const QStringList& cells, Qt::Alignment alignment)
+{
+    _result.append(QLatin1StringView("<tr>"));
+    for(const QString& cell : cells) {
+        appendCell(cell, alignment);
+    }
+    _result.append(QLatin1StringView("</tr>"));
+}
+
+int HtmlBuilder::appendTable(const QAbstractItemModel* model, int firstRow, int lastRow, const QModelIndex& parent, int cellPadding, int cellSpacing)
+{
+    int result = 0;
+    if(model == nullptr) {
+        return result;
+    }
+
+    int rowCount = model->rowCount(parent);
+    int columnCount = model->columnCount(parent);
+    if(lastRow < 0 || lastRow >= rowCount) {
+        lastRow = rowCount - 1;
+    }
+    firstRow = qMax(firstRow, 0);
+
+    startTable(cellPadding, cellSpacing);
+
+    QStringList headers;
+    bool haveHeaders = false;
+    for(int col = 0;col < columnCount;col++) {
+        QString header = model->headerData(col, Qt::Horizontal, Qt::DisplayRole).toString();
+        haveHeaders |= header.isEmpty() == false;
+        headers.append(header);
+    }
+    if(haveHeaders) {
+        _result.append(QLatin1StringView("<tr>"));
+        for(const QString& header : headers) {
+            appendAlignedTag(QLatin1StringView("th"), Qt::AlignLeft);
+            HtmlUtil::appendEscaped(_result, header);
+            _result.append(QLatin1StringView("</th>"));
+        }
+        _result.append(QLatin1StringView("</tr>"));
+    }
+
+    for(int row = firstRow;row <= lastRow;row++) {
+        _result.append(QLatin1StringView("<tr>"));
+        for(int col = 0;col < columnCount;col++) {
+            QModelIndex index = model->index(row, col, parent);
+            QVariant alignment = index.data(Qt::TextAlignmentRole);
+            appendCell(index.data(Qt::DisplayRole).toString(),
+                       alignment.isValid() ? Qt::Alignment(alignment.toInt()) : Qt::Alignment(Qt::AlignLeft));
+        }
+        _result.append(QLatin1StringView("</tr>"));
+        result++;
+    }
+
+    endTable();
+    return result;
 }
 
 void HtmlBuilder::appendText(const QString& text)
 {
-    _output << text;
+    _result.append(text);
+}
+
+void HtmlBuilder::appendEscapedText(const QString& text)
+{
+    HtmlUtil::appendEscaped(_result, text);
+}
+
+void HtmlBuilder::appendAlignedTag(QLatin1StringView tag, Qt::Alignment alignment)
+{
+    QLatin1StringView align("left");
+    if(alignment.testFlag(Qt::AlignRight)) {
+        align = QLatin1StringView("right");
+    }
+    else if(alignment.testFlag(Qt::AlignHCenter)) {
+        align = QLatin1StringView("center");
+    }
+    _result.append(QLatin1Char('<')).append(tag).append(QLatin1StringView(" align=\"")).append(align).append(QLatin1StringView("\">"));
 }
@@ -92,3 +92,30 @@ QString HtmlUtil::escape(const QString& text)
 {
     return text.toHtmlEscaped();
 }
+
+void HtmlUtil::appendEscaped(QString& output, QStringView text)
+{
+    qsizetype runStart = 0;
+    for(qsizetype i = 0;i < text.size();i++) {
+        QLatin1StringView entity;
+        switch(text.at(i).unicode()) {
+        case '<':
+            entity = QLatin1StringView("&lt;");
+            break;
+        case '>':
+            entity = QLatin1StringView("&gt;");
+            break;
+        case '&':
+            entity = QLatin1StringView("&amp;");
+            break;
+        case '"':
+            entity = QLatin1StringView("&quot;");
+            break;
+        default:
+            continue;
+        }
+        output.append(text.mid(runStart, i - runStart)).append(entity);
+        runStart = i + 1;
+    }
+    output.append(text.mid(runStart));
+}
@@ -22,63 +22,101 @@
 #include <QGroupBox>
 #include <QWizard>
 
+#include <algorithm>
+
 
 template<typename T>
 void StyleSheet<T>::setProperty(StyleSheetProperty property, const QString& value)
 {
-    _properties.insert(property, value);
+    auto it = std::lower_bound(_properties.begin(), _properties.end(), property,
+                               [](const Entry& entry, StyleSheetProperty p) { return entry.property < p; });
+    if(it != _properties.end() && it->property == property) {
+        it->value = value;
+    }
+    else {
+        _properties.insert(it, Entry{ property, value });
+    }
 }
 
 template<typename T>
 void StyleSheet<T>::setProperty(StyleSheetProperty property, const QColor& value)
 {
-    _properties.insert(property, value.name(QColor::HexArgb));
+    setProperty(property, value.name(QColor::HexArgb));
 }
 
 template<typename T>
 void StyleSheet<T>::setPropertyPixels(StyleSheetProperty property, int value)
 {
-    _properties.insert(property, QString("%1px").arg(value));
+    QString s = QString::number(value);
+    s.append(QLatin1StringView("px"));
+    setProperty(property, s);
 }
 
 template<typename T>
 QString StyleSheet<T>::toString() const
 {
+    // Size the output first so the result is built with one allocation
+    qsizetype length = _typeName.size() + _propertySelectors.size() + 4;
+    if(_subControl.isEmpty() == false) {
+        length += _subControl.size() + 2;
+    }
+    for(StyleSheetPseudoState ps : _pseudoStates) {
+        length += StyleSheetStrings::pseudoStateName(ps).size() + 1;
+    }
+    for(const Entry& entry : _properties) {
+        length += StyleSheetStrings::propertyName(entry.property).size() + entry.value.size() + 4;
+    }
+
     QString result;
-    QTextStream output(&result);
-    output << _typeName;
+    result.reserve(length);
+    result.append(_typeName).append(_propertySelectors);
     if(_subControl.isEmpty() == false) {
-        output << "::" << _subControl;
+        result.append(QLatin1StringView("::")).append(_subControl);
     }
     for(StyleSheetPseudoState ps : _pseudoStates) {
-        output << ':' << StyleSheetStrings::getPseudoStateString(ps);
+        result.append(QLatin1Char(':')).append(StyleSheetStrings::pseudoStateName(ps));
     }
-    output << " {";
-    QList<StyleSheetProperty> keys = _properties.keys();
-    for(int i = 0; i < keys.count();i++) {
-        StyleSheetProperty p = keys.at(i);
-        output << ' ' << StyleSheetStrings::getPropertyString(p) << ": " << _properties.value(p);
-        if(i < keys.count() - 1) {
-            output << ';';
+    result.append(QLatin1StringView(" {"));
+    for(qsizetype i = 0;i < _properties.size();i++) {
+        const Entry& entry = _properties.at(i);
+        result.append(QLatin1Char(' ')).append(StyleSheetStrings::propertyName(entry.property))
+              .append(QLatin1StringView(": ")).append(entry.value);
+        if(i < _properties.size() - 1) {
+            result.append(QLatin1Char(';'));
         }
     }
-    output << " }";
+    result.append(QLatin1StringView(" }"));
     return result;
 }
 
+/**
+ * Append "rgba(r,g,b,a)" without intermediate strings
+ */
+static void appendRgba(QString& output, const QColor& c)
+{
+    output.append(QLatin1StringView("rgba("))
+          .append(QString::number(c.red())).append(QLatin1Char(','))
+          .append(QString::number(c.green())).append(QLatin1Char(','))
+          .append(QString::number(c.blue())).append(QLatin1Char(','))
+          .append(QString::number(c.alpha())).append(QLatin1Char(')'));
+}
 
 template<typename T>
 void StyleSheet<T>::setRadialGradient(double cx, double cy, double radius, double fx, double fy,
                                       const QGradientStops& stops)
 {
-    QString s = QString("qradialgradient(cx:%1, cy:%2, radius:%3, fx:%4, fy:%5")
-        .arg(cx).arg(cy).arg(radius).arg(fx).arg(fy);
+    QString s;
+    s.reserve(64 + stops.count() * 40);
+    s.append(QLatin1StringView("qradialgradient(cx:")).append(QString::number(cx))
+     .append(QLatin1StringView(", cy:")).append(QString::number(cy))
+     .append(QLatin1StringView(", radius:")).append(QString::number(radius))
+     .append(QLatin1StringView(", fx:")).append(QString::number(fx))
+     .append(QLatin1StringView(", fy:")).append(QString::number(fy));
     for(const QGradientStop& stop : stops) {
-        const QColor& c = stop.second;
-        s += QString(", stop:%1 rgba(%2,%3,%4,%5)")
-            .arg(stop.first).arg(c.red()).arg(c.green()).arg(c.blue()).arg(c.alpha());
+        s.append(QLatin1StringView(", stop:")).append(QString::number(stop.first)).append(QLatin1Char(' '));
+        appendRgba(s, stop.second);
     }
-    s += QLatin1Char(')');
+    s.append(QLatin1Char(')'));
     setGradient(s);
 }
 
@@ -95,8 +133,11 @@ template<typename T>
 void StyleSheet<T>::setBorder(int widthPx, const QColor& topLeft, const QColor& bottomRight)
 {
     auto make = [widthPx](const QColor& c) {
-        return QString("%1px solid rgba(%2,%3,%4,%5)")
-            .arg(widthPx).arg(c.red()).arg(c.green()).arg(c.blue()).arg(c.alpha());
+        QString s;
+        s.reserve(40);
+        s.append(QString::number(widthPx)).append(QLatin1StringView("px solid "));
+        appendRgba(s, c);
+        return s;
     };
     setBorder(make(topLeft), make(bottomRight));
 }
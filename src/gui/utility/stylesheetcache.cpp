@@ -0,0 +1,66 @@
+#include "utility/stylesheetcache.h"
+
+#include <QMutex>
+#include <QSet>
+#include <QWidget>
+
+static QMutex _lock;
+static QSet<QString> _sheets;
+static quint64 _appliedCount = 0;
+static quint64 _skippedCount = 0;
+
+QString StyleSheetCache::intern(const QString& styleSheet)
+{
+    QMutexLocker locker(&_lock);
+    auto it = _sheets.constFind(styleSheet);
+    if(it != _sheets.constEnd()) {
+        return *it;
+    }
+    if(_sheets.count() < MaxInternedSheets) {
+        _sheets.insert(styleSheet);
+    }
+    return styleSheet;
+}
+
+bool StyleSheetCache::apply(QWidget* widget, const QString& styleSheet)
+{
+    QString sheet = intern(styleSheet);
+    QString current = widget->styleSheet();
+    // Interned strings share data, so the common case is a pointer comparison
+    if(current.constData() == sheet.constData() || current == sheet) {
+        QMutexLocker locker(&_lock);
+        _skippedCount++;
+        return false;
+    }
+
+    widget->setStyleSheet(sheet);
+    QMutexLocker locker(&_lock);
+    _appliedCount++;
+    return true;
+}
+
+int StyleSheetCache::count()
+{
+    QMutexLocker locker(&_lock);
+    return _sheets.count();
+}
+
+quint64 StyleSheetCache::appliedCount()
+{
+    QMutexLocker locker(&_lock);
+    return _appliedCount;
+}
+
+quint64 StyleSheetCache::skippedCount()
+{
+    QMutexLocker locker(&_lock);
+    return _skippedCount;
+}
+
+void StyleSheetCache::clear()
+{
+    QMutexLocker locker(&_lock);
+    _sheets.clear();
+    _appliedCount = 0;
+    _skippedCount = 0;
+}
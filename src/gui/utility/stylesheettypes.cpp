@@ -1,7 +1,216 @@
 #include "utility/stylesheettypes.h"
 
-const StyleSheetStrings::PropertyToStringMap StyleSheetStrings::_PropertyToStringMap;
-const StyleSheetStrings::PseudoStateToStringMap StyleSheetStrings::_PseudoStateToStringMap;
-const StyleSheetStrings::SubControlToStringMap StyleSheetStrings::_SubControlToStringMap;
+// Indexed by enum value; keep in the same order as the enums in stylesheettypes.h
 
+static constexpr const char* PropertyNames[] = {
+    "accent-color",                                // SP_AccentColor
+    "alternate-background-color",                  // SP_AlternateBackgroundColor
+    "background",                                  // SP_Background
+    "background-color",                            // SP_BackgroundColor
+    "background-image",                            // SP_BackgroundImage
+    "background-repeat",                           // SP_BackgroundRepeat
+    "background-position",                         // SP_BackgroundPosition
+    "background-attachment",                       // SP_BackgroundAttachment
+    "background-clip",                             // SP_BackgroundClip
+    "background-origin",                           // SP_BackgroundOrigin
+    "border",                                      // SP_Border
+    "border-top",                                  // SP_BorderTop
+    "border-right",                                // SP_BorderRight
+    "border-bottom",                               // SP_BorderBottom
+    "border-left",                                 // SP_BorderLeft
+    "border-color",                                // SP_BorderColor
+    "border-top-color",                            // SP_BorderTopColor
+    "border-right-color",                          // SP_BorderRightColor
+    "border-bottom-color",                         // SP_BorderBottomColor
+    "border-left-color",                           // SP_BorderLeftColor
+    "border-image",                                // SP_BorderImage
+    "border-radius",                               // SP_BorderRadius
+    "border-top-left-radius",                      // SP_BorderTopLeftRadius
+    "border-top-right-radius",                     // SP_BorderTopRightRadius
+    "border-bottom-right-radius",                  // SP_BorderBottomRightRadius
+    "border-bottom-left-radius",                   // SP_BorderBottomLeftRadius
+    "border-style",                                // SP_BorderStyle
+    "border-top-style",                            // SP_BorderTopStyle
+    "border-right-style",                          // SP_BorderRightStyle
+    "border-bottom-style",                         // SP_BorderBottomStyle
+    "border-left-style",                           // SP_BorderLeftStyle
+    "border-width",                                // SP_BorderWidth
+    "border-top-width",                            // SP_BorderTopWidth
+    "border-right-width",                          // SP_BorderRightWidth
+    "border-bottom-width",                         // SP_BorderBottomWidth
+    "border-left-width",                           // SP_BorderLeftWidth
+    "bottom",                                      // SP_Bottom
+    "button-layout",                               // SP_ButtonLayout
+    "color",                                       // SP_Color
+    "dialogbuttonbox-buttons-have-icons",          // SP_DialogbuttonboxButtonsHaveIcons
+    "font",                                        // SP_Font
+    "font-family",                                 // SP_FontFamily
+    "font-size",                                   // SP_FontSize
+    "font-style",                                  // SP_FontStyle
+    "font-weight",                                 // SP_FontWeight
+    "gridline-color",                              // SP_GridlineColor
+    "height",                                      // SP_Height
+    "icon",                                        // SP_Icon
+    "icon-size",                                   // SP_IconSize
+    "image",                                       // SP_Image
+    "image-position",                              // SP_ImagePosition
+    "left",                                        // SP_Left
+    "lineedit-password-character",                 // SP_LineeditPasswordCharacter
+    "lineedit-password-mask-delay",                // SP_LineeditPasswordMaskDelay
+    "margin",                                      // SP_Margin
+    "margin-top",                                  // SP_MarginTop
+    "margin-right",                                // SP_MarginRight
+    "margin-bottom",                               // SP_MarginBottom
+    "margin-left",                                 // SP_MarginLeft
+    "max-height",                                  // SP_MaxHeight
+    "max-width",                                   // SP_MaxWidth
+    "messagebox-text-interaction-flags",           // SP_MessageboxTextInteractionFlags
+    "min-height",                                  // SP_MinHeight
+    "min-width",                                   // SP_MinWidth
+    "opacity",                                     // SP_Opacity
+    "outline",                                     // SP_Outline
+    "outline-color",                               // SP_OutlineColor
+    "outline-offset",                              // SP_OutlineOffset
+    "outline-style",                               // SP_OutlineStyle
+    "outline-radius",                              // SP_OutlineRadius
+    "outline-bottom-left-radius",                  // SP_OutlineBottomLeftRadius
+    "outline-bottom-right-radius",                 // SP_OutlineBottomRightRadius
+    "outline-top-left-radius",                     // SP_OutlineTopLeftRadius
+    "outline-top-right-radius",                    // SP_OutlineTopRightRadius
+    "padding",                                     // SP_Padding
+    "padding-top",                                 // SP_PaddingTop
+    "padding-right",                               // SP_PaddingRight
+    "padding-bottom",                              // SP_PaddingBottom
+    "padding-left",                                // SP_PaddingLeft
+    "paint-alternating-row-colors-for-empty-area", // SP_PaintAlternatingRowColorsForEmptyArea
+    "placeholder-text-color",                      // SP_PlaceholderTextColor
+    "position",                                    // SP_Position
+    "right",                                       // SP_Right
+    "selection-background-color",                  // SP_SelectionBackgroundColor
+    "selection-color",                             // SP_SelectionColor
+    "show-decoration-selected",                    // SP_ShowDecorationSelected
+    "spacing",                                     // SP_Spacing
+    "subcontrol-origin",                           // SP_SubcontrolOrigin
+    "subcontrol-position",                         // SP_SubcontrolPosition
+    "titlebar-show-tooltips-on-buttons",           // SP_TitlebarShowTooltipsOnButtons
+    "widget-animation-duration",                   // SP_WidgetAnimationDuration
+    "text-align",                                  // SP_TextAlign
+    "text-decoration",                             // SP_TextDecoration
+    "top",                                         // SP_Top
+    "width",                                       // SP_Width
+    "-qt-background-role",                         // SP_QtBackgroundRole
+    "-qt-style-features",                          // SP_QtStyleFeatures
+};
+static_assert(sizeof(PropertyNames) / sizeof(PropertyNames[0]) == SP_QtStyleFeatures + 1, "PropertyNames table out of sync with StyleSheetProperty");
 
+static constexpr const char* PseudoStateNames[] = {
+    "",                       // PS_Invalid
+    "active",                 // PS_Active
+    "adjoins-item",           // PS_AdjoinsItem
+    "alternate",              // PS_Alternate
+    "bottom",                 // PS_Bottom
+    "checked",                // PS_Checked
+    "closable",               // PS_Closable
+    "closed",                 // PS_Closed
+    "default",                // PS_Default
+    "disabled",               // PS_Disabled
+    "editable",               // PS_Editable
+    "edit-focus",             // PS_EditFocus
+    "enabled",                // PS_Enabled
+    "exclusive",              // PS_Exclusive
+    "first",                  // PS_First
+    "flat",                   // PS_Flat
+    "floatable",              // PS_Floatable
+    "focus",                  // PS_Focus
+    "has-children",           // PS_HasChildren
+    "has-siblings",           // PS_HasSiblings
+    "horizontal",             // PS_Horizontal
+    "hover",                  // PS_Hover
+    "indeterminate",          // PS_Indeterminate
+    "last",                   // PS_Last
+    "left",                   // PS_Left
+    "maximized",              // PS_Maximized
+    "middle",                 // PS_Middle
+    "minimized",              // PS_Minimized
+    "movable",                // PS_Movable
+    "no-frame",               // PS_NoFrame
+    "non-exclusive",          // PS_NonExclusive
+    "off",                    // PS_Off
+    "on",                     // PS_On
+    "only-one",               // PS_OnlyOne
+    "open",                   // PS_Open
+    "next-selected",          // PS_NextSelected
+    "pressed",                // PS_Pressed
+    "previous-selected",      // PS_PreviousSelected
+    "read-only",              // PS_ReadOnly
+    "right",                  // PS_Right
+    "selected",               // PS_Selected
+    "top",                    // PS_Top
+    "unchecked",              // PS_Unchecked
+    "vertical",               // PS_Vertical
+    "window",                 // PS_Window
+};
+static_assert(sizeof(PseudoStateNames) / sizeof(PseudoStateNames[0]) == PS_Window + 1, "PseudoStateNames table out of sync with StyleSheetPseudoState");
+
+static constexpr const char* SubControlNames[] = {
+    "",                    // SC_Invalid
+    "add-line",            // SC_AddLine
+    "add-page",            // SC_AddPage
+    "branch",              // SC_Branch
+    "chunk",               // SC_Chunk
+    "close-button",        // SC_CloseButton
+    "corner",              // SC_Corner
+    "down-arrow",          // SC_DownArrow
+    "down-button",         // SC_DownButton
+    "drop-down",           // SC_DropDown
+    "float-button",        // SC_FloatButton
+    "groove",              // SC_Groove
+    "handle",              // SC_Handle
+    "icon",                // SC_Icon
+    "indicator",           // SC_Indicator
+    "item",                // SC_Item
+    "left-arrow",          // SC_LeftArrow
+    "left-corner",         // SC_LeftCorner
+    "menu-arrow",          // SC_MenuArrow
+    "menu-button",         // SC_MenuButton
+    "menu-indicator",      // SC_MenuIndicator
+    "pane",                // SC_Pane
+    "right-arrow",         // SC_RightArrow
+    "right-corner",        // SC_RightCorner
+    "scroller",            // SC_Scroller
+    "section",             // SC_Section
+    "separator",           // SC_Separator
+    "sub-line",            // SC_SubLine
+    "sub-page",            // SC_SubPage
+    "tab",                 // SC_Tab
+    "tab-bar",             // SC_TabBar
+    "tear",                // SC_Tear
+    "tearoff",             // SC_TearOff
+    "text",                // SC_Text
+    "title",               // SC_Title
+    "up-arrow",            // SC_UpArrow
+    "up-button",           // SC_UpButton
+};
+static_assert(sizeof(SubControlNames) / sizeof(SubControlNames[0]) == SC_UpButton + 1, "SubControlNames table out of sync with StyleSheetSubControl");
+
+template <typename E, size_t N>
+static inline QLatin1StringView lookupName(const char* const (&names)[N], E value)
+{
+    size_t index = static_cast<size_t>(value);
+    return index < N ? QLatin1StringView(names[index]) : QLatin1StringView();
+}
+
+QLatin1StringView StyleSheetStrings::propertyName(StyleSheetProperty property)
+{
+    return lookupName(PropertyNames, property);
+}
+
+QLatin1StringView StyleSheetStrings::pseudoStateName(StyleSheetPseudoState pseudoState)
+{
+    return lookupName(PseudoStateNames, pseudoState);
+}
+
+QLatin1StringView StyleSheetStrings::subControlName(StyleSheetSubControl subControl)
+{
+    return lookupName(SubControlNames, subControl);
+}
@@ -0,0 +1,136 @@
+#include "utility/theme.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFrame>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QStatusBar>
+#include <QStyle>
+#include <QWidget>
+#include <Kanoop/log.h>
+
+const char* Theme::StateProperty = "themeState";
+const QString Theme::ErrorState = QStringLiteral("error");
+const QString Theme::WarningState = QStringLiteral("warning");
+const QString Theme::SuccessState = QStringLiteral("success");
+const QString Theme::HighlightState = QStringLiteral("highlight");
+
+template <typename T>
+static void appendStateRule(QString& sheet, const QString& state, const QColor& foreground, const QColor& background)
+{
+    StyleSheet<T> rule;
+    rule.addPropertySelector(Theme::StateProperty, state);
+    if(foreground.isValid()) {
+        rule.setProperty(SP_Color, foreground);
+    }
+    if(background.isValid()) {
+        rule.setProperty(SP_BackgroundColor, background);
+    }
+    sheet.append(rule.toString());
+    sheet.append(QLatin1Char('\n'));
+}
+
+void Theme::setStateColors(const QString& state, const QColor& foreground, const QColor& background)
+{
+    StateColors colors;
+    colors.foreground = foreground;
+    colors.background = background;
+    _states.insert(state, colors);
+    _compiled = false;
+}
+
+void Theme::addRule(const QString& rule)
+{
+    _rules.append(rule);
+    _compiled = false;
+}
+
+QString Theme::styleSheet() const
+{
+    if(_compiled == false) {
+        qsizetype length = 0;
+        for(const QString& rule : _rules) {
+            length += rule.length() + 1;
+        }
+        _styleSheet.clear();
+        _styleSheet.reserve(length + _states.count() * 256);
+        compileStateRules(_styleSheet);
+        for(const QString& rule : _rules) {
+            _styleSheet.append(rule);
+            _styleSheet.append(QLatin1Char('\n'));
+        }
+        _compiled = true;
+    }
+    return _styleSheet;
+}
+
+void Theme::compileStateRules(QString& sheet) const
+{
+    // QFrame comes before QLabel so the more derived class wins where both match
+    for(auto it = _states.constBegin();it != _states.constEnd();it++) {
+        appendStateRule<QFrame>(sheet, it.key(), it.value().foreground, it.value().background);
+        appendStateRule<QLabel>(sheet, it.key(), it.value().foreground, it.value().background);
+        appendStateRule<QLineEdit>(sheet, it.key(), it.value().foreground, it.value().background);
+        appendStateRule<QPushButton>(sheet, it.key(), it.value().foreground, it.value().background);
+        appendStateRule<QStatusBar>(sheet, it.key(), it.value().foreground, it.value().background);
+    }
+}
+
+qint64 Theme::apply() const
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QString sheet = styleSheet();
+    bool paletteChanged = QApplication::palette() != _palette;
+    bool sheetChanged = qApp->styleSheet() != sheet;
+
+    // Setting the palette only sends palette change events; polish reads the new palette,
+    // so the stylesheet change that follows is the one repolish pass
+    if(paletteChanged) {
+        QApplication::setPalette(_palette);
+    }
+    if(sheetChanged) {
+        qApp->setStyleSheet(sheet);
+    }
+
+    qint64 result = timer.elapsed();
+    Log::logText(LVL_DEBUG, QString("Applied theme '%1' (%2 states, %3 rules, %4 repolish) in %5 ms")
+                 .arg(_name).arg(_states.count()).arg(_rules.count()).arg(sheetChanged ? 1 : 0).arg(result));
+    return result;
+}
+
+bool Theme::setWidgetState(QWidget* widget, const char* name, const QVariant& value)
+{
+    if(widget->property(name) == value) {
+        return false;
+    }
+    widget->setProperty(name, value);
+    // Property selectors are only re-evaluated on polish
+    widget->style()->unpolish(widget);
+    widget->style()->polish(widget);
+    widget->update();
+    return true;
+}
+
+Theme Theme::fusionLight()
+{
+    Theme result("Fusion Light", Palette::fusionLight());
+    result.setStateColors(ErrorState, QColor(192, 0, 0));
+    result.setStateColors(WarningState, QColor(176, 112, 0));
+    result.setStateColors(SuccessState, QColor(0, 128, 0));
+    result.setStateColors(HighlightState, result._palette.color(QPalette::HighlightedText), result._palette.color(QPalette::Highlight));
+    return result;
+}
+
+Theme Theme::fusionDark()
+{
+    Theme result("Fusion Dark", Palette::fusionDark());
+    result.setStateColors(ErrorState, QColor(255, 110, 110));
+    result.setStateColors(WarningState, QColor(255, 190, 80));
+    result.setStateColors(SuccessState, QColor(120, 220, 120));
+    result.setStateColors(HighlightState, result._palette.color(QPalette::HighlightedText), result._palette.color(QPalette::Highlight));
+    return result;
+}
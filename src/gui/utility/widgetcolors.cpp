@@ -0,0 +1,108 @@
+#include "utility/widgetcolors.h"
+
+#include "utility/stylesheetcache.h"
+
+#include <QApplication>
+#include <QWidget>
+
+bool WidgetColors::_paletteModeEnabled = true;
+
+const char* WidgetColors::FallbackStyleSheetProperty = "kanoopFallbackStyleSheet";
+
+bool WidgetColors::usePalette(const QWidget* widget, bool styleOnlyProperties)
+{
+    if(_paletteModeEnabled == false || styleOnlyProperties) {
+        return false;
+    }
+    return colorStyleSheetInEffect(widget) == false;
+}
+
+bool WidgetColors::colorStyleSheetInEffect(const QWidget* widget)
+{
+    // Only sheets that can set a color compete with the palette
+    auto setsColors = [](const QString& styleSheet) {
+        return styleSheet.isEmpty() == false &&
+               (styleSheet.contains(QLatin1String("color"), Qt::CaseInsensitive) ||
+                styleSheet.contains(QLatin1String("background"), Qt::CaseInsensitive));
+    };
+
+    if(setsColors(qApp->styleSheet())) {
+        return true;
+    }
+    QVariant fallback = widget->property(FallbackStyleSheetProperty);
+    if(widget->styleSheet() != fallback.toString() && setsColors(widget->styleSheet())) {
+        return true;
+    }
+    for(const QWidget* ancestor = widget->parentWidget();ancestor != nullptr;ancestor = ancestor->parentWidget()) {
+        if(setsColors(ancestor->styleSheet())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WidgetColors::applyStyleSheet(QWidget* widget, const QString& styleSheet)
+{
+    bool result = StyleSheetCache::apply(widget, styleSheet);
+    if(result) {
+        widget->setProperty(FallbackStyleSheetProperty, widget->styleSheet());
+    }
+    return result;
+}
+
+bool WidgetColors::clearStyleSheet(QWidget* widget)
+{
+    // Cheap test first; palette-mode widgets normally carry no sheet at all
+    if(widget->styleSheet().isEmpty()) {
+        return false;
+    }
+    QVariant fallback = widget->property(FallbackStyleSheetProperty);
+    if(fallback.isValid() == false) {
+        return false;
+    }
+    widget->setProperty(FallbackStyleSheetProperty, QVariant());
+    if(widget->styleSheet() != fallback.toString()) {
+        return false;
+    }
+    widget->setStyleSheet(QString());
+    return true;
+}
+
+bool WidgetColors::setColor(QWidget* widget, QPalette::ColorRole role, const QColor& color)
+{
+    QPalette palette = widget->palette();
+    if(color.isValid()) {
+        if(palette.color(QPalette::Active, role) == color &&
+           palette.color(QPalette::Inactive, role) == color &&
+           palette.color(QPalette::Disabled, role) == color) {
+            return false;
+        }
+        palette.setColor(role, color);
+    }
+    else {
+        QPalette defaultPalette = QApplication::palette(widget);
+        bool changed = false;
+        for(QPalette::ColorGroup group : { QPalette::Active, QPalette::Inactive, QPalette::Disabled }) {
+            if(palette.color(group, role) != defaultPalette.color(group, role)) {
+                palette.setColor(group, role, defaultPalette.color(group, role));
+                changed = true;
+            }
+        }
+        if(changed == false) {
+            return false;
+        }
+    }
+    widget->setPalette(palette);
+    return true;
+}
+
+bool WidgetColors::setBackgroundColor(QWidget* widget, QPalette::ColorRole role, const QColor& color)
+{
+    bool result = setColor(widget, role, color);
+    bool fill = color.isValid();
+    if(widget->autoFillBackground() != fill) {
+        widget->setAutoFillBackground(fill);
+        result = true;
+    }
+    return result;
+}
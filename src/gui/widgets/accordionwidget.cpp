@@ -5,6 +5,7 @@
 #include <QPainter>
 #include <QVBoxLayout>
 #include <guisettings.h>
+#include <utility/fontscaler.h>
 
 AccordionWidget::AccordionWidget(QWidget *parent) :
     QWidget(parent)
@@ -160,14 +161,7 @@ AccordionItem* AccordionWidget::findItemForWidget(QWidget* widget) const
 
 void AccordionWidget::onPreferencesChanged()
 {
-    if(GuiSettings::globalInstance() == nullptr) {
-        return;
-    }
-
-    QFont newFont(font());
-    int pointSize = GuiSettings::globalInstance()->fontSize();
-    newFont.setPointSize(pointSize);
-    setFont(newFont);
+    FontScaler::applyPreferredPointSize(this);
 }
 
 
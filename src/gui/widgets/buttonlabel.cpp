@@ -5,6 +5,8 @@
 #include <QToolButton>
 
 #include <utility/stylesheet.h>
+#include <utility/theme.h>
+#include <utility/widgetcolors.h>
 
 ButtonLabel::ButtonLabel(QWidget *parent) :
     QWidget(parent),
@@ -29,10 +31,9 @@ void ButtonLabel::commonInit()
     _layout->addWidget(_label);
     _layout->addWidget(_button);
 
+    // Colors are only applied once set, so the label follows the application palette and theme
     _backgroundColor = palette().color(QPalette::Window);
     _foregroundColor = palette().color(QPalette::Text);
-    setBackgroundColor(_backgroundColor);
-    setForegroundColor(_foregroundColor);
 
     setLayout(_layout);
 
@@ -41,10 +42,17 @@ void ButtonLabel::commonInit()
 
 void ButtonLabel::makeStyleSheet()
 {
+    if(WidgetColors::usePalette(_label)) {
+        WidgetColors::clearStyleSheet(_label);
+        WidgetColors::setColor(_label, QPalette::WindowText, _foregroundColor);
+        WidgetColors::setBackgroundColor(_label, QPalette::Window, _backgroundColor);
+        return;
+    }
+
     StyleSheet<QLabel> ss;
     ss.setProperty(SP_Color, _foregroundColor);
     ss.setProperty(SP_BackgroundColor, _backgroundColor);
-    _label->setStyleSheet(ss.toString());
+    WidgetColors::applyStyleSheet(_label, ss.toString());
 }
 
 void ButtonLabel::setText(const QString& text)
@@ -115,4 +123,14 @@ void ButtonLabel::onButtonClicked()
     emit clicked();
 }
 
+void ButtonLabel::setThemeState(const QString& state)
+{
+    Theme::setWidgetState(_label, Theme::StateProperty, state.isEmpty() ? QVariant() : QVariant(state));
+}
+
+QString ButtonLabel::themeState() const
+{
+    return _label->property(Theme::StateProperty).toString();
+}
+
 #include "Kanoop/gui/widgets/moc_buttonlabel.cpp"
@@ -1,6 +1,8 @@
 #include "widgets/frame.h"
 
 #include <utility/stylesheet.h>
+#include <utility/theme.h>
+#include <utility/widgetcolors.h>
 
 Frame::Frame(QWidget *parent) :
     QFrame(parent)
@@ -11,18 +13,39 @@ Frame::Frame(QWidget *parent) :
 void Frame::setForegroundColor(const QColor& color)
 {
     _foregroundColor = color;
+    if(WidgetColors::usePalette(this)) {
+        WidgetColors::clearStyleSheet(this);
+        WidgetColors::setColor(this, QPalette::WindowText, color);
+        return;
+    }
+
     StyleSheet<QFrame> ss;
     ss.setProperty(SP_Color, color);
-    setStyleSheet(ss.toString());
+    WidgetColors::applyStyleSheet(this, ss.toString());
 }
 
 void Frame::setBackgroundColor(const QColor& color)
 {
     _backgroundColor = color;
+    if(WidgetColors::usePalette(this)) {
+        WidgetColors::clearStyleSheet(this);
+        WidgetColors::setBackgroundColor(this, QPalette::Window, color);
+        return;
+    }
+
     StyleSheet<QFrame> ss;
     ss.setProperty(SP_BackgroundColor, color);
-    setStyleSheet(ss.toString());
+    WidgetColors::applyStyleSheet(this, ss.toString());
 }
 
+void Frame::setThemeState(const QString& state)
+{
+    Theme::setWidgetState(this, Theme::StateProperty, state.isEmpty() ? QVariant() : QVariant(state));
+}
+
+QString Frame::themeState() const
+{
+    return property(Theme::StateProperty).toString();
+}
 
 #include "Kanoop/gui/widgets/moc_frame.cpp"
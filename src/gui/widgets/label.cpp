@@ -3,6 +3,8 @@
 #include <stylesheets.h>
 
 #include <utility/stylesheet.h>
+#include <utility/theme.h>
+#include <utility/widgetcolors.h>
 
 Label::Label(QWidget *parent, Qt::WindowFlags f) :
     QLabel(parent, f)
@@ -66,6 +68,13 @@ void Label::setDefaultBackgroundColor()
 
 void Label::applyStylesheet()
 {
+    if(WidgetColors::usePalette(this)) {
+        WidgetColors::clearStyleSheet(this);
+        WidgetColors::setColor(this, QPalette::WindowText, _foregroundExplicitlySet ? _foregroundColor : QColor());
+        WidgetColors::setBackgroundColor(this, QPalette::Window, _backgroundExplicitlySet ? _backgroundColor : QColor());
+        return;
+    }
+
     StyleSheet<QLabel> ss;
     if(_foregroundExplicitlySet) {
         ss.setProperty(SP_Color, _foregroundColor);
@@ -73,7 +82,17 @@ void Label::applyStylesheet()
     if(_backgroundExplicitlySet) {
         ss.setProperty(SP_BackgroundColor, _backgroundColor);
     }
-    setStyleSheet(ss.toString());
+    WidgetColors::applyStyleSheet(this, ss.toString());
+}
+
+void Label::setThemeState(const QString& state)
+{
+    Theme::setWidgetState(this, Theme::StateProperty, state.isEmpty() ? QVariant() : QVariant(state));
+}
+
+QString Label::themeState() const
+{
+    return property(Theme::StateProperty).toString();
 }
 
 
@@ -1,6 +1,8 @@
 #include "widgets/lineedit.h"
 
 #include <utility/stylesheet.h>
+#include <utility/theme.h>
+#include <utility/widgetcolors.h>
 
 
 LineEdit::LineEdit(QWidget *parent) :
@@ -15,16 +17,38 @@ LineEdit::LineEdit(const QString& text, QWidget* parent) :
 
 void LineEdit::setForegroundColor(const QColor& color)
 {
+    if(WidgetColors::usePalette(this)) {
+        WidgetColors::clearStyleSheet(this);
+        WidgetColors::setColor(this, QPalette::Text, color);
+        return;
+    }
+
     StyleSheet<QLineEdit> ss;
     ss.setProperty(SP_Color, color);
-    setStyleSheet(ss.toString());
+    WidgetColors::applyStyleSheet(this, ss.toString());
 }
 
 void LineEdit::setBackgroundColor(const QColor& color)
 {
+    if(WidgetColors::usePalette(this)) {
+        WidgetColors::clearStyleSheet(this);
+        WidgetColors::setColor(this, QPalette::Base, color);
+        return;
+    }
+
     StyleSheet<QLineEdit> ss;
     ss.setProperty(SP_BackgroundColor, color);
-    setStyleSheet(ss.toString());
+    WidgetColors::applyStyleSheet(this, ss.toString());
+}
+
+void LineEdit::setThemeState(const QString& state)
+{
+    Theme::setWidgetState(this, Theme::StateProperty, state.isEmpty() ? QVariant() : QVariant(state));
+}
+
+QString LineEdit::themeState() const
+{
+    return property(Theme::StateProperty).toString();
 }
 
 #include "Kanoop/gui/widgets/moc_lineedit.cpp"
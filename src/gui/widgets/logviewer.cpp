@@ -0,0 +1,393 @@
+#include "widgets/logviewer.h"
+
+#include <QPaintEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QTextLine>
+
+#include <cmath>
+#include <limits>
+
+static const int MaxCachedLayouts = 1024;
+static const int UpdateInterval = 16;
+static const int TextMargin = 4;
+static const qsizetype MinCompactBytes = 1024 * 1024;
+
+LogViewer::LogViewer(QWidget* parent) :
+    QAbstractScrollArea(parent),
+    _encoder(QStringEncoder::Utf8, QStringConverter::Flag::Stateless),
+    _layouts(MaxCachedLayouts)
+{
+    _updateTimer.setSingleShot(true);
+    _updateTimer.setInterval(UpdateInterval);
+    connect(&_updateTimer, &QTimer::timeout, this, &LogViewer::onUpdateTimer);
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &LogViewer::onVerticalScroll);
+}
+
+void LogViewer::appendText(const QString& text, const QColor& foregroundColor, const QColor& backgroundColor)
+{
+    appendFormattedText(text, NoTextFlags, foregroundColor, backgroundColor);
+}
+
+void LogViewer::appendFormattedText(const QString& text, TextFlags flags, const QColor& foregroundColor, const QColor& backgroundColor)
+{
+    qsizetype start = 0;
+    qsizetype newline;
+    while((newline = text.indexOf(QLatin1Char('\n'), start)) >= 0) {
+        qsizetype end = newline > start && text.at(newline - 1) == QLatin1Char('\r') ? newline - 1 : newline;
+        appendLine(QStringView(text).mid(start, end - start), flags, foregroundColor, backgroundColor);
+        start = newline + 1;
+    }
+    appendLine(QStringView(text).mid(start), flags, foregroundColor, backgroundColor);
+}
+
+void LogViewer::appendLogEntry(const Log::LogEntry& entry)
+{
+    appendText(entry.text(), _levelColors.value(entry.level()));
+}
+
+void LogViewer::appendLogEntries(const QList<Log::LogEntry>& entries)
+{
+    // Appends only schedule a repaint, so the whole batch costs one scroll bar update
+    for(const Log::LogEntry& entry : entries) {
+        appendLogEntry(entry);
+    }
+}
+
+void LogViewer::clear()
+{
+    _firstSequence += _count;
+    _lines.clear();
+    _arena.clear();
+    _deadBytes = 0;
+    _head = 0;
+    _count = 0;
+    _maxLineWidth = 0;
+    _layouts.clear();
+    updateScrollBars();
+    viewport()->update();
+}
+
+QString LogViewer::lineText(int index) const
+{
+    QString result;
+    if(index >= 0 && index < _count) {
+        const LineRecord& line = lineAt(index);
+        result = QString::fromUtf8(_arena.constData() + line.offset, line.length);
+    }
+    return result;
+}
+
+void LogViewer::setMaximumLines(int value)
+{
+    value = qMax(1, value);
+    if(value == _capacity) {
+        return;
+    }
+
+    // Rebuild in order so the newest lines survive and the head returns to zero
+    int keep = qMin(_count, value);
+    QList<LineRecord> lines;
+    lines.reserve(keep);
+    for(int i = 0;i < _count;i++) {
+        const LineRecord& line = lineAt(i);
+        if(i < _count - keep) {
+            _deadBytes += line.length;
+        }
+        else {
+            lines.append(line);
+        }
+    }
+    int dropped = _count - keep;
+    _firstSequence += dropped;
+    _lines = lines;
+    _head = 0;
+    _count = keep;
+    _capacity = value;
+    compactArena();
+    shiftScrollPosition(dropped);
+    scheduleUpdate();
+}
+
+void LogViewer::setFollowTail(bool value)
+{
+    _followTail = value;
+    updateScrollBars();
+    viewport()->update();
+}
+
+int LogViewer::find(const QString& text, bool backward, Qt::CaseSensitivity cs)
+{
+    int result = -1;
+    if(text.isEmpty() || _count == 0) {
+        return result;
+    }
+
+    QByteArray utf8 = text.toUtf8();
+    int current = currentMatch();
+    int start;
+    if(current >= 0) {
+        start = backward ? current - 1 : current + 1;
+    }
+    else {
+        start = backward ? _count - 1 : verticalScrollBar()->value();
+    }
+    start = ((start % _count) + _count) % _count;
+
+    for(int n = 0;n < _count;n++) {
+        int index = backward ? (start - n + _count) % _count : (start + n) % _count;
+        if(lineMatches(lineAt(index), text, utf8, cs)) {
+            result = index;
+            break;
+        }
+    }
+
+    if(result >= 0) {
+        _matchSequence = _firstSequence + result;
+        scrollToLine(result);
+        viewport()->update();
+    }
+    return result;
+}
+
+int LogViewer::currentMatch() const
+{
+    if(_matchSequence < 0 || quint64(_matchSequence) < _firstSequence) {
+        return -1;
+    }
+    quint64 index = quint64(_matchSequence) - _firstSequence;
+    return index < quint64(_count) ? int(index) : -1;
+}
+
+void LogViewer::scrollToLine(int index)
+{
+    updateScrollBars();
+    int visible = qMax(1, viewport()->height() / lineHeight());
+    verticalScrollBar()->setValue(qBound(0, index - visible / 2, verticalScrollBar()->maximum()));
+}
+
+void LogViewer::paintEvent(QPaintEvent* event)
+{
+    QPainter painter(viewport());
+    painter.setPen(palette().color(QPalette::Text));
+
+    int height = lineHeight();
+    int first = verticalScrollBar()->value() + event->rect().top() / height;
+    int last = qMin(_count - 1, verticalScrollBar()->value() + event->rect().bottom() / height);
+    int x = TextMargin - horizontalScrollBar()->value();
+    int width = viewport()->width();
+    int match = currentMatch();
+
+    for(int i = first;i <= last;i++) {
+        int y = (i - verticalScrollBar()->value()) * height;
+        const LineRecord& line = lineAt(i);
+        QTextLayout* layout = layoutFor(i);
+        if(i == match) {
+            painter.fillRect(0, y, width, height, palette().color(QPalette::Highlight));
+            QTextLayout::FormatRange selection;
+            selection.start = 0;
+            selection.length = layout->text().length();
+            selection.format.setForeground(palette().color(QPalette::HighlightedText));
+            selection.format.setBackground(palette().color(QPalette::Highlight));
+            layout->draw(&painter, QPointF(x, y), { selection });
+        }
+        else {
+            if(line.flags & HasBackground) {
+                painter.fillRect(0, y, width, height, QColor::fromRgba(line.background));
+            }
+            layout->draw(&painter, QPointF(x, y));
+        }
+    }
+}
+
+void LogViewer::resizeEvent(QResizeEvent* event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void LogViewer::changeEvent(QEvent* event)
+{
+    if(event->type() == QEvent::FontChange) {
+        _layouts.clear();
+        _maxLineWidth = 0;
+        updateScrollBars();
+    }
+    QAbstractScrollArea::changeEvent(event);
+}
+
+void LogViewer::scrollContentsBy(int dx, int dy)
+{
+    // Scroll positions are in lines, not pixels, so repaint rather than blit
+    Q_UNUSED(dx)
+    Q_UNUSED(dy)
+    viewport()->update();
+}
+
+void LogViewer::appendLine(QStringView text, TextFlags flags, const QColor& foregroundColor, const QColor& backgroundColor)
+{
+    // Encode straight into the arena rather than through a temporary QByteArray
+    LineRecord line;
+    line.offset = _arena.size();
+    _arena.resize(line.offset + _encoder.requiredSpace(text.size()));
+    char* end = _encoder.appendToBuffer(_arena.data() + line.offset, text);
+    _arena.resize(end - _arena.constData());
+    line.length = int(_arena.size() - line.offset);
+    if(flags & (BoldText | StrongText)) {
+        line.flags |= IsBold;
+    }
+    if(foregroundColor.isValid()) {
+        line.foreground = foregroundColor.rgba();
+        line.flags |= HasForeground;
+    }
+    if(backgroundColor.isValid()) {
+        line.background = backgroundColor.rgba();
+        line.flags |= HasBackground;
+    }
+
+    if(_count < _capacity) {
+        _lines.append(line);
+        _count++;
+    }
+    else {
+        // Full: overwrite the oldest line, leaving its bytes dead in the arena
+        _deadBytes += _lines.at(_head).length;
+        _lines[_head] = line;
+        _head = (_head + 1) % _capacity;
+        _firstSequence++;
+        shiftScrollPosition(1);
+        if(_deadBytes > MinCompactBytes && _deadBytes > _arena.size() / 2) {
+            compactArena();
+        }
+    }
+    scheduleUpdate();
+}
+
+bool LogViewer::lineMatches(const LineRecord& line, const QString& text, const QByteArray& utf8, Qt::CaseSensitivity cs) const
+{
+    QByteArray bytes = lineBytes(line);
+    if(cs == Qt::CaseSensitive) {
+        return bytes.contains(utf8);
+    }
+    return QString::fromUtf8(bytes).contains(text, cs);
+}
+
+void LogViewer::compactArena()
+{
+    // Copy the live lines oldest first; the records keep their ring positions
+    QByteArray arena;
+    arena.reserve(_arena.size() - _deadBytes);
+    for(int i = 0;i < _count;i++) {
+        LineRecord& line = _lines[(_head + i) % _capacity];
+        qsizetype offset = arena.size();
+        arena.append(_arena.constData() + line.offset, line.length);
+        line.offset = offset;
+    }
+    _arena = arena;
+    _deadBytes = 0;
+}
+
+void LogViewer::shiftScrollPosition(int lines)
+{
+    if(_followTail || lines <= 0) {
+        return;
+    }
+
+    // Keep the lines on screen in place as older lines are dropped above them
+    QScrollBar* vbar = verticalScrollBar();
+    QSignalBlocker blocker(vbar);
+    vbar->setValue(qMax(0, vbar->value() - lines));
+}
+
+QTextLayout* LogViewer::layoutFor(int index)
+{
+    quint64 sequence = _firstSequence + index;
+    QTextLayout* result = _layouts.object(sequence);
+    if(result != nullptr) {
+        return result;
+    }
+
+    const LineRecord& line = lineAt(index);
+    result = new QTextLayout(QString::fromUtf8(_arena.constData() + line.offset, line.length), font());
+    result->setCacheEnabled(true);
+
+    QTextOption option;
+    option.setWrapMode(QTextOption::NoWrap);
+    result->setTextOption(option);
+
+    if(line.flags & (HasForeground | IsBold)) {
+        QTextLayout::FormatRange range;
+        range.start = 0;
+        range.length = result->text().length();
+        if(line.flags & HasForeground) {
+            range.format.setForeground(QColor::fromRgba(line.foreground));
+        }
+        if(line.flags & IsBold) {
+            range.format.setFontWeight(QFont::Bold);
+        }
+        result->setFormats({ range });
+    }
+
+    result->beginLayout();
+    QTextLine textLine = result->createLine();
+    if(textLine.isValid()) {
+        textLine.setLineWidth(std::numeric_limits<int>::max() / 2);
+        textLine.setPosition(QPointF(0, 0));
+    }
+    result->endLayout();
+
+    int width = int(std::ceil(result->maximumWidth())) + TextMargin * 2;
+    if(width > _maxLineWidth) {
+        _maxLineWidth = width;
+        scheduleUpdate();
+    }
+
+    _layouts.insert(sequence, result);
+    return result;
+}
+
+int LogViewer::lineHeight() const
+{
+    return qMax(1, fontMetrics().lineSpacing());
+}
+
+void LogViewer::updateScrollBars()
+{
+    QScrollBar* vbar = verticalScrollBar();
+    int value = vbar->value();
+
+    int visible = qMax(1, viewport()->height() / lineHeight());
+    {
+        // Range changes must not be mistaken for the user scrolling away from the tail
+        QSignalBlocker blocker(vbar);
+        vbar->setRange(0, qMax(0, _count - visible));
+        vbar->setPageStep(visible);
+        vbar->setSingleStep(1);
+        vbar->setValue(_followTail ? vbar->maximum() : qMax(0, value));
+    }
+
+    QScrollBar* hbar = horizontalScrollBar();
+    hbar->setRange(0, qMax(0, _maxLineWidth - viewport()->width()));
+    hbar->setPageStep(viewport()->width());
+    hbar->setSingleStep(qMax(1, fontMetrics().averageCharWidth()));
+}
+
+void LogViewer::scheduleUpdate()
+{
+    if(_updateTimer.isActive() == false) {
+        _updateTimer.start();
+    }
+}
+
+void LogViewer::onUpdateTimer()
+{
+    updateScrollBars();
+    viewport()->update();
+}
+
+void LogViewer::onVerticalScroll(int value)
+{
+    _followTail = value >= verticalScrollBar()->maximum();
+}
+
+#include "Kanoop/gui/widgets/moc_logviewer.cpp"
@@ -2,6 +2,31 @@
 
 #include <utility/htmlbuilder.h>
 
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTextDocument>
+
+static const int MaxCachedLogFormats = 256;
+
+PlainTextEdit::PlainTextEdit(QWidget* parent) :
+    QPlainTextEdit(parent)
+{
+    commonInit();
+}
+
+PlainTextEdit::PlainTextEdit(const QString& text, QWidget* parent) :
+    QPlainTextEdit(text, parent)
+{
+    commonInit();
+}
+
+void PlainTextEdit::commonInit()
+{
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(DefaultFlushInterval);
+    connect(&_flushTimer, &QTimer::timeout, this, &PlainTextEdit::flushPendingLines);
+}
+
 void PlainTextEdit::appendText(const QString& text, const QColor& foregroundColor, const QColor& backgroundColor)
 {
     appendFormattedText(text, NoTextFlags, foregroundColor, backgroundColor);
@@ -9,6 +34,14 @@ void PlainTextEdit::appendText(const QString& text, const QColor& foregroundColo
 
 void PlainTextEdit::appendFormattedText(const QString& text, TextFlags flags, const QColor& foregroundColor, const QColor& backgroundColor)
 {
+    if(_logMode) {
+        _pendingLines.append(PendingLine(text, flags, foregroundColor, backgroundColor));
+        if(_flushTimer.isActive() == false) {
+            _flushTimer.start();
+        }
+        return;
+    }
+
     HtmlBuilder html;
     html.startParagraph(foregroundColor, backgroundColor);
     if(flags & BoldText) {
@@ -31,4 +64,132 @@ void PlainTextEdit::appendFormattedText(const QString& text, TextFlags flags, co
     appendHtml(result);
 }
 
+void PlainTextEdit::setLogModeEnabled(bool enabled)
+{
+    if(enabled == _logMode) {
+        return;
+    }
+
+    if(enabled) {
+        _undoRedoWasEnabled = document()->isUndoRedoEnabled();
+        document()->setUndoRedoEnabled(false);
+        _logMode = true;
+    }
+    else {
+        flushPendingLines();
+        _logMode = false;
+        _logFormats.clear();
+        document()->setUndoRedoEnabled(_undoRedoWasEnabled);
+    }
+}
+
+void PlainTextEdit::appendPlainText(const QString& text)
+{
+    // Keep direct appends in order with lines still waiting in the log queue
+    flushPendingLines();
+    QPlainTextEdit::appendPlainText(text);
+}
+
+void PlainTextEdit::appendHtml(const QString& html)
+{
+    flushPendingLines();
+    QPlainTextEdit::appendHtml(html);
+}
+
+bool PlainTextEdit::isPinnedToBottom() const
+{
+    return verticalScrollBar()->value() >= verticalScrollBar()->maximum();
+}
+
+void PlainTextEdit::flushPendingLines()
+{
+    _flushTimer.stop();
+    if(_pendingLines.isEmpty()) {
+        return;
+    }
+
+    // lines that would be trimmed straight away are never inserted
+    if(_maximumLogBlocks > 0 && _pendingLines.count() > _maximumLogBlocks) {
+        _pendingLines.remove(0, _pendingLines.count() - _maximumLogBlocks);
+    }
+
+    bool pinned = isPinnedToBottom();
+    int scrollPosition = verticalScrollBar()->value();
+
+    QTextCursor cursor(document());
+    cursor.beginEditBlock();
+    cursor.movePosition(QTextCursor::End);
+    bool firstLine = document()->isEmpty();
+    for(const PendingLine& line : _pendingLines) {
+        if(firstLine == false) {
+            cursor.insertBlock();
+        }
+        cursor.insertText(line.text, logFormat(line.flags, line.foregroundColor, line.backgroundColor));
+        firstLine = false;
+    }
+    cursor.endEditBlock();
+    _pendingLines.clear();
+
+    int trimmed = trimLogBlocks();
+    if(pinned) {
+        verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+    }
+    else if(trimmed > 0) {
+        // keep the lines the user is looking at in place; the scroll bar counts
+        // visual lines, so a wrapped block moves it by more than one
+        verticalScrollBar()->setValue(qMax(0, scrollPosition - trimmed));
+    }
+}
+
+int PlainTextEdit::trimLogBlocks()
+{
+    int result = 0;
+    if(_maximumLogBlocks <= 0) {
+        return result;
+    }
+
+    int excess = document()->blockCount() - _maximumLogBlocks;
+    if(excess <= 0 || excess < _maximumLogBlocks / 10) {
+        return result;
+    }
+
+    QTextBlock block = document()->firstBlock();
+    for(int i = 0;i < excess && block.isValid();i++) {
+        result += qMax(1, block.lineCount());
+        block = block.next();
+    }
+
+    QTextCursor cursor(document());
+    cursor.movePosition(QTextCursor::Start);
+    cursor.movePosition(QTextCursor::NextBlock, QTextCursor::KeepAnchor, excess);
+    cursor.removeSelectedText();
+    return result;
+}
+
+QTextCharFormat PlainTextEdit::logFormat(TextFlags flags, const QColor& foregroundColor, const QColor& backgroundColor)
+{
+    FormatKey key(flags, foregroundColor, backgroundColor);
+    auto it = _logFormats.constFind(key);
+    if(it != _logFormats.constEnd()) {
+        return it.value();
+    }
+
+    QTextCharFormat result;
+    if(foregroundColor.isValid()) {
+        result.setForeground(foregroundColor);
+    }
+    if(backgroundColor.isValid()) {
+        result.setBackground(backgroundColor);
+    }
+    if(flags & (BoldText | StrongText)) {
+        result.setFontWeight(QFont::Bold);
+    }
+
+    if(_logFormats.count() >= MaxCachedLogFormats) {
+        _logFormats.clear();
+    }
+    _logFormats.insert(key, result);
+    return result;
+}
+
 #include "Kanoop/gui/widgets/moc_plaintextedit.cpp"
@@ -1,6 +1,8 @@
 #include "widgets/pushbutton.h"
 
 #include <utility/stylesheet.h>
+#include <utility/theme.h>
+#include <utility/widgetcolors.h>
 
 
 PushButton::PushButton(QWidget* parent) :
@@ -23,10 +25,9 @@ PushButton::PushButton(const QIcon& icon, const QString& text, QWidget* parent)
 
 void PushButton::commonInit()
 {
+    // Colors are only applied once set, so new buttons follow the application palette and theme
     _backgroundColor = palette().color(QPalette::Window);
     _foregroundColor = palette().color(QPalette::Text);
-    setBackgroundColor(_backgroundColor);
-    setForegroundColor(_foregroundColor);
 }
 
 void PushButton::setFontPointSize(int size)
@@ -102,30 +103,59 @@ void PushButton::setDisabledBackgroundColor(const QColor& color)
 void PushButton::setForegroundColor(const QColor& color)
 {
     _foregroundColor = color;
+    _foregroundExplicitlySet = true;
     makeStyleSheet();
 }
 
 void PushButton::setBackgroundColor(const QColor& color)
 {
     _backgroundColor = color;
+    _backgroundExplicitlySet = true;
     makeStyleSheet();
 }
 
 void PushButton::setDefaultForegroundColor()
 {
-    setForegroundColor(palette().color(QPalette::Text));
+    _foregroundColor = palette().color(QPalette::Text);
+    _foregroundExplicitlySet = false;
+    makeStyleSheet();
 }
 
 void PushButton::setDefaultBackgroundColor()
 {
-    setBackgroundColor(palette().color(QPalette::Window));
+    _backgroundColor = palette().color(QPalette::Window);
+    _backgroundExplicitlySet = false;
+    makeStyleSheet();
 }
 
 void PushButton::makeStyleSheet()
 {
+    // Hover and pressed colors and the border radius have no palette equivalent
+    bool styleOnly = _borderRadius > 0 ||
+                     _hoverForegroundColor.isValid() || _hoverBackgroundColor.isValid() ||
+                     _pressedForegroundColor.isValid() || _pressedBackgroundColor.isValid();
+    if(WidgetColors::usePalette(this, styleOnly)) {
+        WidgetColors::clearStyleSheet(this);
+        WidgetColors::setColor(this, QPalette::ButtonText, _foregroundExplicitlySet ? _foregroundColor : QColor());
+        WidgetColors::setColor(this, QPalette::Button, _backgroundExplicitlySet ? _backgroundColor : QColor());
+        QPalette p = palette();
+        if(_disabledForegroundColor.isValid()) {
+            p.setColor(QPalette::Disabled, QPalette::ButtonText, _disabledForegroundColor);
+        }
+        if(_disabledBackgroundColor.isValid()) {
+            p.setColor(QPalette::Disabled, QPalette::Button, _disabledBackgroundColor);
+        }
+        if(p != palette()) {
+            setPalette(p);
+        }
+        return;
+    }
+
     StyleSheet<QPushButton> base;
-    base.setProperty(SP_Color, _foregroundColor);
-    base.setProperty(SP_BackgroundColor, _backgroundColor);
+    if(_foregroundExplicitlySet)
+        base.setProperty(SP_Color, _foregroundColor);
+    if(_backgroundExplicitlySet)
+        base.setProperty(SP_BackgroundColor, _backgroundColor);
     if(_borderRadius > 0)
         base.setPropertyPixels(SP_BorderRadius, _borderRadius);
     QString ss = base.toString();
@@ -154,7 +184,17 @@ void PushButton::makeStyleSheet()
         ss += " " + disabled.toString();
     }
 
-    setStyleSheet(ss);
+    WidgetColors::applyStyleSheet(this, ss);
+}
+
+void PushButton::setThemeState(const QString& state)
+{
+    Theme::setWidgetState(this, Theme::StateProperty, state.isEmpty() ? QVariant() : QVariant(state));
+}
+
+QString PushButton::themeState() const
+{
+    return property(Theme::StateProperty).toString();
 }
 
 #include "Kanoop/gui/widgets/moc_pushbutton.cpp"
@@ -33,7 +33,7 @@ void SidebarWidget::addItem(int entityMetadataType, const QString &text, int ima
     if(imageResourceId != 0) {
         icon = Resources::getIcon(imageResourceId);
     }
-    SidebarItem* item = new SidebarItem(entityMetadataType, text, icon);
+    SidebarItem* item = new SidebarItem(entityMetadataType, text, icon, imageResourceId);
     item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
     item->setData(entityMetadataType, KANOOP::EntityTypeRole);
     static_cast<QStandardItemModel*>(model())->appendRow(item);
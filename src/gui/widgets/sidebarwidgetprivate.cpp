@@ -1,6 +1,8 @@
 #include "sidebarwidgetprivate.h"
 
 #include <QPainter>
+#include <QStandardItemModel>
+#include <resources.h>
 
 #include <Kanoop/geometry/rectangle.h>
 #include <Kanoop/log.h>
@@ -38,12 +40,14 @@ void SidebarPaintDelegate::paint(QPainter *painter, const QStyleOptionViewItem &
 
     int centerX = Rectangle(rect).topEdge().midpoint().x();
 
-    // Draw icon
+    // Draw icon, straight from the resource atlas when one exists for this size
     if (hasIcon) {
         int iconX = centerX - _iconSize.width() / 2;
         QPoint iconPoint(iconX, contentRect.top());
-        painter->drawPixmap(iconPoint,
-                            opt.icon.pixmap(_iconSize));
+        if(Resources::drawAtlasImage(painter, QRect(iconPoint, _iconSize), imageId(index), _iconSize) == false) {
+            painter->drawPixmap(iconPoint,
+                                opt.icon.pixmap(_iconSize));
+        }
     }
 
     // Draw Text
@@ -82,6 +86,16 @@ QFont SidebarPaintDelegate::textFont(const QStyleOptionViewItem &option) const
     return font;
 }
 
+int SidebarPaintDelegate::imageId(const QModelIndex &index) const
+{
+    const QStandardItemModel* model = qobject_cast<const QStandardItemModel*>(index.model());
+    if(model == nullptr) {
+        return 0;
+    }
+    SidebarItem* item = dynamic_cast<SidebarItem*>(model->itemFromIndex(index));
+    return item != nullptr ? item->imageId() : 0;
+}
+
 QRect SidebarPaintDelegate::textRectangle(const QStyleOptionViewItem &option) const
 {
     QFontMetrics metrics(textFont(option));
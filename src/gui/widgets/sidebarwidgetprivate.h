@@ -34,6 +34,7 @@ public:
 
 private:
     inline QFont textFont(const QStyleOptionViewItem &option) const;
+    inline int imageId(const QModelIndex &index) const;
     inline QRect textRectangle(const QStyleOptionViewItem &option) const;
 
     QMargins _contentsMargins;
@@ -45,14 +46,16 @@ private:
 class SidebarItem : public QStandardItem
 {
 public:
-    SidebarItem(int entityType, const QString& text, const QIcon& icon) :
+    SidebarItem(int entityType, const QString& text, const QIcon& icon, int imageId = 0) :
         QStandardItem(icon, text),
-        _entityType(entityType) {}
+        _entityType(entityType), _imageId(imageId) {}
 
     int entityType() const { return _entityType; }
+    int imageId() const { return _imageId; }
 
 private:
     int _entityType;
+    int _imageId;
     QIcon _standardIcon;
     QIcon _darkModeIcon;
 };
@@ -1,6 +1,8 @@
 #include "widgets/statusbar.h"
 
 #include <utility/stylesheet.h>
+#include <utility/theme.h>
+#include <utility/widgetcolors.h>
 #include <Kanoop/log.h>
 
 
@@ -42,10 +44,16 @@ void StatusBar::stopAnimation()
 
 void StatusBar::setForegroundColor(const QColor& color)
 {
+    if(WidgetColors::usePalette(this)) {
+        WidgetColors::clearStyleSheet(this);
+        WidgetColors::setColor(this, QPalette::WindowText, color);
+        return;
+    }
+
     QColor c = color.isValid() ? color : palette().color(QPalette::Text);
     StyleSheet<QStatusBar> ss;
     ss.setProperty(SP_Color, c);
-    setStyleSheet(ss.toString());
+    WidgetColors::applyStyleSheet(this, ss.toString());
 }
 
 void StatusBar::reset()
@@ -65,4 +73,14 @@ void StatusBar::onDotTimerExpired()
     }
 }
 
+void StatusBar::setThemeState(const QString& state)
+{
+    Theme::setWidgetState(this, Theme::StateProperty, state.isEmpty() ? QVariant() : QVariant(state));
+}
+
+QString StatusBar::themeState() const
+{
+    return property(Theme::StateProperty).toString();
+}
+
 #include "Kanoop/gui/widgets/moc_statusbar.cpp"
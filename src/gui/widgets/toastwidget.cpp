@@ -8,6 +8,7 @@
 #include <stylesheets.h>
 
 #include <utility/stylesheet.h>
+#include <utility/stylesheetcache.h>
 #include <Kanoop/log.h>
 
 #include <widgets/label.h>
@@ -48,10 +49,10 @@ ToastWidget::ToastWidget(const QString& text, const QColor& backgroundColor, con
     ss.setProperty(SP_BackgroundColor, backgroundColor);
     ss.setProperty(SP_Color, foregroundColor);
     ss.setPropertyPixels(SP_BorderRadius, 10);
-    setStyleSheet(ss.toString());
+    StyleSheetCache::apply(this, ss.toString());
 
-    _label->setStyleSheet(styleSheet());
-    _closeButton->setStyleSheet(styleSheet());
+    StyleSheetCache::apply(_label, styleSheet());
+    StyleSheetCache::apply(_closeButton, styleSheet());
 
     // calculate fade sleep
     _fadeSleepTime = TimeSpan::fromMilliseconds(50);
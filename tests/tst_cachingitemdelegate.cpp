@@ -0,0 +1,174 @@
+#include <QTest>
+#include <QImage>
+#include <QPainter>
+#include <QSortFilterProxyModel>
+#include <QStandardItemModel>
+#include <QStringListModel>
+#include <Kanoop/gui/cachingitemdelegate.h>
+
+class CountingDelegate : public CachingItemDelegate
+{
+public:
+    int paintCount = 0;
+    quint64 revision = 0;
+
+protected:
+    virtual void paintCell(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override
+    {
+        Q_UNUSED(index)
+        const_cast<CountingDelegate*>(this)->paintCount++;
+        painter->fillRect(option.rect, Qt::red);
+    }
+
+    virtual quint64 dataRevision(const QModelIndex& index) const override { Q_UNUSED(index) return revision; }
+};
+
+class TstCachingItemDelegate : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int RowCount = 4;
+    static const int ColumnCount = 3;
+
+    QStandardItemModel* _model = nullptr;
+    QImage _image;
+
+    void paintCell(CountingDelegate& delegate, const QModelIndex& index, const QSize& size = QSize(60, 20), QStyle::State state = QStyle::State_Enabled)
+    {
+        QStyleOptionViewItem option;
+        option.rect = QRect(QPoint(0, 0), size);
+        option.state = state;
+        QPainter painter(&_image);
+        delegate.paint(&painter, option, index);
+    }
+
+    void paintAll(CountingDelegate& delegate)
+    {
+        for(int row = 0;row < _model->rowCount();row++) {
+            for(int column = 0;column < _model->columnCount();column++) {
+                paintCell(delegate, _model->index(row, column));
+            }
+        }
+    }
+
+private slots:
+    void init()
+    {
+        _image = QImage(100, 100, QImage::Format_ARGB32_Premultiplied);
+        _model = new QStandardItemModel(RowCount, ColumnCount, this);
+        for(int row = 0;row < RowCount;row++) {
+            for(int column = 0;column < ColumnCount;column++) {
+                _model->setItem(row, column, new QStandardItem(QString("%1,%2").arg(row).arg(column)));
+            }
+        }
+    }
+
+    void cleanup()
+    {
+        delete _model;
+        _model = nullptr;
+    }
+
+    void cacheKey_sizeStateAndRevision()
+    {
+        CountingDelegate delegate;
+        QModelIndex index = _model->index(1, 1);
+        paintCell(delegate, index);
+        paintCell(delegate, index);
+        QCOMPARE(delegate.misses(), quint64(1));
+        QCOMPARE(delegate.hits(), quint64(1));
+
+        paintCell(delegate, index, QSize(80, 20));
+        paintCell(delegate, index, QSize(60, 20), QStyle::State_Enabled | QStyle::State_Selected);
+        QCOMPARE(delegate.misses(), quint64(3));
+
+        // State bits outside the mask do not take part in the key
+        paintCell(delegate, index, QSize(60, 20), QStyle::State_Enabled | QStyle::State_Raised);
+        QCOMPARE(delegate.hits(), quint64(2));
+
+        delegate.revision = 1;
+        paintCell(delegate, index);
+        QCOMPARE(delegate.misses(), quint64(4));
+        QCOMPARE(delegate.paintCount, 4);
+        QCOMPARE(delegate.hitRate(), 2.0 / 6.0);
+    }
+
+    void cacheKey_proxyUsesSourceCell()
+    {
+        CountingDelegate delegate;
+        QSortFilterProxyModel proxy;
+        proxy.setSourceModel(_model);
+        proxy.sort(0, Qt::DescendingOrder);
+
+        paintCell(delegate, _model->index(0, 2));
+        paintCell(delegate, proxy.mapFromSource(_model->index(0, 2)));
+        QCOMPARE(delegate.misses(), quint64(1));
+        QCOMPARE(delegate.hits(), quint64(1));
+    }
+
+    void dataChanged_invalidatesOnlyChangedCells()
+    {
+        CountingDelegate delegate;
+        paintAll(delegate);
+        QCOMPARE(delegate.misses(), quint64(RowCount * ColumnCount));
+
+        delegate.resetStatistics();
+        _model->item(2, 1)->setText("changed");
+        paintAll(delegate);
+        QCOMPARE(delegate.misses(), quint64(1));
+        QCOMPARE(delegate.hits(), quint64(RowCount * ColumnCount - 1));
+
+        delegate.resetStatistics();
+        paintAll(delegate);
+        QCOMPARE(delegate.misses(), quint64(0));
+    }
+
+    void rowsInserted_invalidatesAll()
+    {
+        CountingDelegate delegate;
+        paintAll(delegate);
+
+        delegate.resetStatistics();
+        _model->insertRow(0);
+        paintAll(delegate);
+        QCOMPARE(delegate.hits(), quint64(0));
+        QCOMPARE(delegate.misses(), quint64((RowCount + 1) * ColumnCount));
+
+        delegate.resetStatistics();
+        paintAll(delegate);
+        QCOMPARE(delegate.misses(), quint64(0));
+    }
+
+    void modelReset_invalidatesAll()
+    {
+        CountingDelegate delegate;
+        QStringListModel model({ "a", "b", "c" });
+        for(int row = 0;row < model.rowCount();row++) {
+            paintCell(delegate, model.index(row));
+        }
+
+        // setStringList() resets the model without inserting or removing rows
+        delegate.resetStatistics();
+        model.setStringList({ "a", "b", "c" });
+        for(int row = 0;row < model.rowCount();row++) {
+            paintCell(delegate, model.index(row));
+        }
+        QCOMPARE(delegate.hits(), quint64(0));
+        QCOMPARE(delegate.misses(), quint64(3));
+    }
+
+    void invalidate_discardsCache()
+    {
+        CountingDelegate delegate;
+        paintAll(delegate);
+        delegate.invalidate();
+
+        delegate.resetStatistics();
+        paintAll(delegate);
+        QCOMPARE(delegate.hits(), quint64(0));
+    }
+};
+
+QTEST_MAIN(TstCachingItemDelegate)
+#include "tst_cachingitemdelegate.moc"
@@ -0,0 +1,171 @@
+#include <QTest>
+#include <Kanoop/gui/graphics/graphicsscene.h>
+#include <Kanoop/gui/graphics/ellipsegraphicsitem.h>
+#include <Kanoop/gui/graphics/linegraphicsitem.h>
+#include <Kanoop/gui/graphics/rectanglegraphicsitem.h>
+
+class TstGraphicsScene : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum ItemType
+    {
+        LineType = QGraphicsItem::UserType + 1,
+        EllipseType,
+        ProxyType,
+    };
+
+    static const int BenchmarkLines = 200000;
+    static const int BenchmarkEllipses = 100;
+
+    void populate(GraphicsScene& scene, int lines, int ellipses) const
+    {
+        for(int i = 0;i < lines;i++) {
+            LineGraphicsItem* item = new LineGraphicsItem(LineType);
+            item->setLine(i, 0, i, 10);
+            scene.addItem(item);
+        }
+        for(int i = 0;i < ellipses;i++) {
+            EllipseGraphicsItem* item = new EllipseGraphicsItem(EllipseType);
+            item->setRect(i, 20, 5, 5);
+            scene.addItem(item);
+        }
+    }
+
+private slots:
+    void registry_tracksAddRemoveDelete()
+    {
+        GraphicsScene scene;
+        populate(scene, 10, 3);
+        QCOMPARE(scene.itemCountOfType(LineType), 10);
+        QCOMPARE(scene.itemCountOfType(EllipseType), 3);
+        QCOMPARE(scene.findChildItems<EllipseGraphicsItem*>(EllipseType).count(), 3);
+        QVERIFY(scene.findFirstChildItem<LineGraphicsItem*>(LineType) != nullptr);
+        QVERIFY(scene.findFirstChildItem<EllipseGraphicsItem*>(LineType) == nullptr);
+
+        EllipseGraphicsItem* ellipse = scene.findFirstChildItem<EllipseGraphicsItem*>(EllipseType);
+        scene.removeItem(ellipse);
+        QCOMPARE(scene.itemCountOfType(EllipseType), 2);
+        delete ellipse;
+
+        delete scene.findFirstChildItem<LineGraphicsItem*>(LineType);
+        QCOMPARE(scene.itemCountOfType(LineType), 9);
+    }
+
+    void registry_includesChildItems()
+    {
+        GraphicsScene scene;
+        RectangleGraphicsItem* parent = new RectangleGraphicsItem(ProxyType);
+        new LineGraphicsItem(LineType, parent);
+        new LineGraphicsItem(LineType, parent);
+        scene.addItem(parent);
+        QCOMPARE(scene.itemCountOfType(LineType), 2);
+        delete parent;
+        QCOMPARE(scene.itemCountOfType(LineType), 0);
+    }
+
+    void registry_includesItemsCreatedUnderSceneParent()
+    {
+        GraphicsScene scene;
+        RectangleGraphicsItem* parent = new RectangleGraphicsItem(ProxyType);
+        scene.addItem(parent);
+
+        LineGraphicsItem* line = new LineGraphicsItem(LineType, parent);
+        new EllipseGraphicsItem(EllipseType, parent);
+        QCOMPARE(scene.itemCountOfType(LineType), 1);
+        QCOMPARE(scene.itemCountOfType(EllipseType), 1);
+        QCOMPARE(scene.findFirstChildItem<LineGraphicsItem*>(LineType), line);
+
+        // Culling applies to items created while their type is culled
+        scene.setLevelOfDetail(EllipseType, 0.5);
+        scene.setLevelOfDetailScale(0.25);
+        EllipseGraphicsItem* late = new EllipseGraphicsItem(EllipseType, parent);
+        QVERIFY(late->isVisible() == false);
+
+        delete parent;
+        QCOMPARE(scene.itemCountOfType(LineType), 0);
+        QCOMPARE(scene.itemCountOfType(EllipseType), 0);
+    }
+
+    void levelOfDetail_cullsBelowThreshold()
+    {
+        GraphicsScene scene;
+        populate(scene, 5, 2);
+        RectangleGraphicsItem* proxy = new RectangleGraphicsItem(ProxyType);
+        scene.setLevelOfDetail(LineType, 0.5, proxy);
+        QVERIFY(scene.isCulled(LineType) == false);
+        QVERIFY(proxy->isVisible() == false);
+
+        scene.setLevelOfDetailScale(0.25);
+        QVERIFY(scene.isCulled(LineType));
+        QVERIFY(proxy->isVisible());
+        for(LineGraphicsItem* item : scene.findChildItems<LineGraphicsItem*>(LineType)) {
+            QVERIFY(item->isVisible() == false);
+        }
+        for(EllipseGraphicsItem* item : scene.findChildItems<EllipseGraphicsItem*>(EllipseType)) {
+            QVERIFY(item->isVisible());
+        }
+
+        LineGraphicsItem* late = new LineGraphicsItem(LineType);
+        scene.addItem(late);
+        QVERIFY(late->isVisible() == false);
+
+        scene.setLevelOfDetailScale(1.0);
+        QVERIFY(late->isVisible());
+        QVERIFY(proxy->isVisible() == false);
+    }
+
+    void levelOfDetail_keepsApplicationHiddenItems()
+    {
+        GraphicsScene scene;
+        populate(scene, 3, 0);
+        LineGraphicsItem* hidden = scene.findFirstChildItem<LineGraphicsItem*>(LineType);
+        hidden->setVisible(false);
+
+        scene.setLevelOfDetail(LineType, 0.5);
+        scene.setLevelOfDetailScale(0.25);
+        scene.setLevelOfDetailScale(1.0);
+        QVERIFY(hidden->isVisible() == false);
+        int visible = 0;
+        for(LineGraphicsItem* item : scene.findChildItems<LineGraphicsItem*>(LineType)) {
+            visible += item->isVisible() ? 1 : 0;
+        }
+        QCOMPARE(visible, 2);
+    }
+
+    void levelOfDetail_sameProxyIsKept()
+    {
+        GraphicsScene scene;
+        populate(scene, 3, 0);
+        RectangleGraphicsItem* proxy = new RectangleGraphicsItem(ProxyType);
+        scene.setLevelOfDetail(LineType, 0.5, proxy);
+        scene.setLevelOfDetail(LineType, 0.75, proxy);
+        QCOMPARE(scene.itemCountOfType(ProxyType), 1);
+
+        scene.setLevelOfDetailScale(0.6);
+        QVERIFY(scene.isCulled(LineType));
+        QVERIFY(proxy->isVisible());
+    }
+
+    void benchmark_findChildItems_scan()
+    {
+        GraphicsScene scene;
+        populate(scene, BenchmarkLines, BenchmarkEllipses);
+        QBENCHMARK {
+            QCOMPARE(scene.findChildItems<EllipseGraphicsItem*>().count(), int(BenchmarkEllipses));
+        }
+    }
+
+    void benchmark_findChildItems_registry()
+    {
+        GraphicsScene scene;
+        populate(scene, BenchmarkLines, BenchmarkEllipses);
+        QBENCHMARK {
+            QCOMPARE(scene.findChildItems<EllipseGraphicsItem*>(EllipseType).count(), int(BenchmarkEllipses));
+        }
+    }
+};
+
+QTEST_MAIN(TstGraphicsScene)
+#include "tst_graphicsscene.moc"
@@ -0,0 +1,156 @@
+#include <QTest>
+#include <QSplitter>
+#include <QStandardPaths>
+#include <QWidget>
+#include <Kanoop/gui/guisettings.h>
+
+class TstGuiSettings : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int WindowCount = 200;
+
+    QList<QWidget*> _widgets;
+
+    int readAll(GuiSettings& settings) const
+    {
+        int result = 0;
+        for(QWidget* widget : _widgets) {
+            result += settings.fontSize();
+            result += settings.getLastWindowSize(widget).width();
+            result += settings.getLastWindowPosition(widget).x();
+        }
+        return result;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+        QCoreApplication::setOrganizationName("KanoopTest");
+        QCoreApplication::setApplicationName("tst_guisettings");
+
+        GuiSettings settings;
+        settings.setFontSize(11);
+        for(int i = 0;i < WindowCount;i++) {
+            QWidget* widget = new QWidget;
+            widget->setObjectName(QString("window%1").arg(i));
+            settings.setLastWindowSize(widget, QSize(400 + i, 300 + i));
+            settings.setLastWindowPosition(widget, QPoint(i, i));
+            _widgets.append(widget);
+        }
+        settings.flush();
+    }
+
+    void cleanupTestCase()
+    {
+        qDeleteAll(_widgets);
+        _widgets.clear();
+    }
+
+    void bufferedWrite_visibleBeforeFlush()
+    {
+        GuiSettings settings;
+        settings.setFontSize(14);
+        QCOMPARE(settings.fontSize(), 14);
+        QVERIFY(settings.pendingWriteCount() > 0);
+        settings.setFontSize(11);
+        settings.flush();
+        QCOMPARE(settings.pendingWriteCount(), 0);
+    }
+
+    void prefetch_servesStoredValues()
+    {
+        GuiSettings settings;
+        QVERIFY(settings.isPrefetched() == false);
+        settings.prefetch();
+        QVERIFY(settings.isPrefetched());
+        QCOMPARE(settings.fontSize(), 11);
+        QCOMPARE(settings.getLastWindowSize(_widgets.at(5)), QSize(405, 305));
+        QCOMPARE(settings.getLastWindowPosition(_widgets.at(7)), QPoint(7, 7));
+    }
+
+    void prefetch_flushedWritesUpdateSnapshot()
+    {
+        GuiSettings settings;
+        settings.prefetch();
+        settings.setLastWindowSize(_widgets.at(0), QSize(640, 480));
+        settings.flush();
+        QCOMPARE(settings.getLastWindowSize(_widgets.at(0)), QSize(640, 480));
+        settings.setLastWindowSize(_widgets.at(0), QSize(400, 300));
+        settings.flush();
+    }
+
+    void prefetch_typedValuesRoundTrip()
+    {
+        QSplitter splitter;
+        splitter.setObjectName("prefetchSplitter");
+        splitter.addWidget(new QWidget);
+        splitter.addWidget(new QWidget);
+        splitter.setSizes({ 120, 280 });
+        QByteArray splitterState = splitter.saveState();
+        {
+            GuiSettings settings;
+            settings.saveLastSplitterState(&splitter);
+            settings.flush();
+        }
+
+        GuiSettings settings;
+        settings.prefetch();
+        QCOMPARE(settings.getLastWindowMaximized(_widgets.at(9)), false);
+        QCOMPARE(settings.getLastWindowSize(_widgets.at(9)), QSize(409, 309));
+
+        // Restoring twice reads the same converted snapshot entry
+        splitter.setSizes({ 200, 200 });
+        settings.restoreLastSplitterState(&splitter);
+        QCOMPARE(splitter.saveState(), splitterState);
+        splitter.setSizes({ 200, 200 });
+        settings.restoreLastSplitterState(&splitter);
+        QCOMPARE(splitter.saveState(), splitterState);
+    }
+
+    void recordGeometry_countsOneRequestPerWindow()
+    {
+        GuiSettings settings;
+        settings.resetWriteStatistics();
+        QWidget* widget = _widgets.at(3);
+        for(int i = 0;i < 100;i++) {
+            settings.recordWindowPosition(widget, QPoint(i, i));
+            settings.recordWindowSize(widget, QSize(400 + i, 300 + i));
+        }
+        QCOMPARE(settings.writeRequestCount(), quint64(1));
+        QCOMPARE(settings.pendingWriteCount(), 1);
+        QCOMPARE(settings.getLastWindowSize(widget), QSize(499, 399));
+
+        settings.recordWindowPosition(widget, QPoint(3, 3));
+        settings.recordWindowSize(widget, QSize(403, 303));
+        settings.flush();
+        QCOMPARE(settings.pendingWriteCount(), 0);
+        QCOMPARE(settings.getLastWindowPosition(widget), QPoint(3, 3));
+    }
+
+    void benchmark_startupReads_settingsStore()
+    {
+        GuiSettings settings;
+        int total = 0;
+        QBENCHMARK {
+            total += readAll(settings);
+        }
+        QVERIFY(total != 0);
+    }
+
+    void benchmark_startupReads_prefetched()
+    {
+        GuiSettings settings;
+        int total = 0;
+        QBENCHMARK {
+            settings.prefetch();
+            total += readAll(settings);
+        }
+        QVERIFY(total != 0);
+    }
+};
+
+QTEST_MAIN(TstGuiSettings)
+#include "tst_guisettings.moc"
@@ -68,6 +68,93 @@ private slots:
         QVERIFY(s2.isVisible());
     }
 
+    void binary_roundTrip()
+    {
+        HeaderState original;
+        original.addSection(0, "Alpha", 100, true);
+        original.addSection(1, "Beta", 200, false);
+        original.addSection(2, QString::fromUtf8("Gr\u00f6\u00dfe"), 300, true);
+
+        QByteArray binary = original.serializeToBinary();
+        QVERIFY(HeaderState::isBinary(binary));
+        QVERIFY(binary.size() < original.serializeToJson().size());
+
+        HeaderState restored;
+        QVERIFY(restored.deserializeFromBinary(binary));
+        QCOMPARE(restored.sectionCount(), 3);
+
+        HeaderState::SectionState s1 = restored.getSection(1);
+        QVERIFY(s1.isValid());
+        QCOMPARE(s1.text(), QStringLiteral("Beta"));
+        QCOMPARE(s1.size(), 200);
+        QVERIFY(!s1.isVisible());
+
+        HeaderState::SectionState s2 = restored.getSection(2);
+        QCOMPARE(s2.text(), QString::fromUtf8("Gr\u00f6\u00dfe"));
+        QCOMPARE(s2.size(), 300);
+    }
+
+    void binary_truncated_isRejected()
+    {
+        HeaderState original;
+        original.addSection(0, "Alpha", 100, true);
+        original.addSection(1, "Beta", 200, false);
+        QByteArray binary = original.serializeToBinary();
+
+        HeaderState restored;
+        QVERIFY(!restored.deserializeFromBinary(binary.left(binary.size() - 3)));
+        QCOMPARE(restored.sectionCount(), 0);
+        QVERIFY(!restored.getSection(0).isValid());
+    }
+
+    void deserialize_acceptsLegacyJson()
+    {
+        HeaderState original;
+        original.addSection(0, "Alpha", 110, true);
+        original.addSection(1, "Beta", 220, false);
+
+        QByteArray json = original.serializeToJson();
+        QVERIFY(!HeaderState::isBinary(json));
+
+        HeaderState restored;
+        QVERIFY(restored.deserialize(json));
+        QCOMPARE(restored.getSection(1).size(), 220);
+
+        HeaderState fromBinary;
+        QVERIFY(fromBinary.deserialize(original.serializeToBinary()));
+        QCOMPARE(fromBinary.getSection(0).size(), 110);
+    }
+
+    void getSection_byText()
+    {
+        HeaderState state;
+        state.addSection(0, "Name", 150, true);
+        state.addSection(1, "Value", 200, false);
+
+        HeaderState::SectionState s = state.getSection(QStringLiteral("Value"));
+        QVERIFY(s.isValid());
+        QCOMPARE(s.section(), 1);
+        QCOMPARE(s.size(), 200);
+
+        QVERIFY(!state.getSection(QStringLiteral("Missing")).isValid());
+    }
+
+    void getSection_indexSameAfterRoundTrip()
+    {
+        HeaderState original;
+        original.addSection(0, QString(), 50, true);
+        original.addSection(1, "Name", 150, true);
+        original.addSection(2, "Name", 175, true);
+
+        HeaderState restored;
+        QVERIFY(restored.deserializeFromBinary(original.serializeToBinary()));
+        for(const HeaderState* state : { &original, &restored }) {
+            QCOMPARE(state->getSection(0).size(), 50);
+            QVERIFY(!state->getSection(QString()).isValid());
+            QCOMPARE(state->getSection(QStringLiteral("Name")).section(), 1);
+        }
+    }
+
     void sectionState_defaultConstructor_isInvalid()
     {
         HeaderState::SectionState s;
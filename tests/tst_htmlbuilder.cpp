@@ -0,0 +1,118 @@
+#include <QTest>
+#include <QStandardItemModel>
+#include <Kanoop/gui/utility/htmlbuilder.h>
+
+class TstHtmlBuilder : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int BenchmarkRows = 5000;
+    static const int BenchmarkColumns = 6;
+
+    QStringList makeRow(int row) const
+    {
+        QStringList result;
+        for(int col = 0;col < BenchmarkColumns;col++) {
+            result.append(QString("cell %1/%2 <a & b>").arg(row).arg(col));
+        }
+        return result;
+    }
+
+private slots:
+    void appendEscaped_matchesToHtmlEscaped()
+    {
+        QString text = QStringLiteral("if(a < b && c > \"d\") return 'e';");
+        QString result;
+        HtmlUtil::appendEscaped(result, text);
+        QCOMPARE(result, text.toHtmlEscaped());
+
+        result.clear();
+        HtmlUtil::appendEscaped(result, QStringLiteral("plain"));
+        QCOMPARE(result, QStringLiteral("plain"));
+    }
+
+    void appendCell_matchesHtmlUtil()
+    {
+        HtmlBuilder html;
+        html.appendCell("x < y", Qt::AlignRight);
+        QCOMPARE(html.toString(), HtmlUtil::startCell(Qt::AlignRight) + HtmlUtil::escape("x < y") + HtmlUtil::endCell());
+    }
+
+    void startParagraph_matchesHtmlUtil()
+    {
+        HtmlBuilder html;
+        html.startParagraph(QColor(Qt::red), QColor(Qt::black));
+        html.startTable(4, 1);
+        QCOMPARE(html.toString(), HtmlUtil::startParagraph(QColor(Qt::red), QColor(Qt::black)) + HtmlUtil::startTable(4, 1));
+    }
+
+    void appendRow_writesAllCells()
+    {
+        HtmlBuilder html;
+        html.appendRow({ "a", "b&c" });
+        QCOMPARE(html.toString(), QStringLiteral("<tr><td align=\"left\">a</td><td align=\"left\">b&amp;c</td></tr>"));
+    }
+
+    void appendTable_writesModelRange()
+    {
+        QStandardItemModel model(4, 2);
+        model.setHorizontalHeaderLabels({ "Name", "Value" });
+        for(int row = 0;row < 4;row++) {
+            model.setItem(row, 0, new QStandardItem(QString("n%1").arg(row)));
+            QStandardItem* value = new QStandardItem(QString::number(row));
+            value->setTextAlignment(Qt::AlignRight);
+            model.setItem(row, 1, value);
+        }
+
+        HtmlBuilder html;
+        QCOMPARE(html.appendTable(&model, 1, 2), 2);
+        QString result = html.toString();
+        QVERIFY(result.startsWith(QStringLiteral("<table cellpadding=\"2\" cellspacing=\"0\"><tr><th align=\"left\">Name</th>")));
+        QVERIFY(result.contains(QStringLiteral("<td align=\"left\">n1</td><td align=\"right\">1</td>")));
+        QVERIFY(result.contains(QStringLiteral("n0")) == false);
+        QVERIFY(result.contains(QStringLiteral("n3")) == false);
+        QVERIFY(result.endsWith(QStringLiteral("</table>")));
+    }
+
+    void benchmark_table_htmlUtil()
+    {
+        QList<QStringList> rows;
+        for(int row = 0;row < BenchmarkRows;row++) {
+            rows.append(makeRow(row));
+        }
+        QBENCHMARK {
+            QString result;
+            result += HtmlUtil::startTable();
+            for(const QStringList& row : rows) {
+                result += HtmlUtil::startRow();
+                for(const QString& cell : row) {
+                    result += HtmlUtil::startCell() + HtmlUtil::escape(cell) + HtmlUtil::endCell();
+                }
+                result += HtmlUtil::endRow();
+            }
+            result += HtmlUtil::endTable();
+            QVERIFY(result.isEmpty() == false);
+        }
+    }
+
+    void benchmark_table_htmlBuilder()
+    {
+        QList<QStringList> rows;
+        for(int row = 0;row < BenchmarkRows;row++) {
+            rows.append(makeRow(row));
+        }
+        QBENCHMARK {
+            HtmlBuilder html(BenchmarkRows * BenchmarkColumns * 48);
+            html.startTable();
+            for(const QStringList& row : rows) {
+                html.appendRow(row);
+            }
+            html.endTable();
+            QVERIFY(html.toString().isEmpty() == false);
+        }
+    }
+};
+
+QTEST_MAIN(TstHtmlBuilder)
+#include "tst_htmlbuilder.moc"
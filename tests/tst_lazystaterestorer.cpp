@@ -0,0 +1,145 @@
+#include <QTest>
+#include <QLabel>
+#include <QSplitter>
+#include <QStandardPaths>
+#include <Kanoop/gui/guisettings.h>
+#include "lazystaterestorer.h"
+
+class TstLazyStateRestorer : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const char* PendingProperty;
+
+    GuiSettings* _settings = nullptr;
+
+    /** Create a hidden top-level splitter with two panes. */
+    static QSplitter* createSplitter(const QString& name)
+    {
+        QSplitter* result = new QSplitter(Qt::Horizontal);
+        result->setObjectName(name);
+        result->addWidget(new QLabel("left"));
+        result->addWidget(new QLabel("right"));
+        result->resize(400, 200);
+        return result;
+    }
+
+    static void showSplitter(QSplitter* splitter)
+    {
+        splitter->show();
+        QVERIFY(QTest::qWaitForWindowExposed(splitter));
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+        QCoreApplication::setOrganizationName("KanoopTest");
+        QCoreApplication::setApplicationName("tst_lazystaterestorer");
+
+        _settings = new GuiSettings;
+        GuiSettings::setGlobalInstance(_settings);
+    }
+
+    void cleanupTestCase()
+    {
+        GuiSettings::setGlobalInstance(nullptr);
+        delete _settings;
+        _settings = nullptr;
+    }
+
+    void hiddenSplitter_restoresOnFirstShow()
+    {
+        QScopedPointer<QSplitter> splitter(createSplitter("hidden"));
+        LazyStateRestorer* restorer = LazyStateRestorer::instance();
+        int restored = restorer->restoredCount();
+
+        restorer->registerSplitter(splitter.data());
+        QCOMPARE(restorer->restoredCount(), restored);
+        QVERIFY(splitter->property(PendingProperty).isValid());
+
+        showSplitter(splitter.data());
+        QCOMPARE(restorer->restoredCount(), restored + 1);
+        QVERIFY(splitter->property(PendingProperty).isValid() == false);
+
+        // The filter is gone once restored, so showing again does nothing
+        splitter->hide();
+        showSplitter(splitter.data());
+        QCOMPARE(restorer->restoredCount(), restored + 1);
+    }
+
+    void visibleSplitter_restoresImmediately()
+    {
+        QScopedPointer<QSplitter> splitter(createSplitter("visible"));
+        showSplitter(splitter.data());
+        LazyStateRestorer* restorer = LazyStateRestorer::instance();
+        int restored = restorer->restoredCount();
+
+        restorer->registerSplitter(splitter.data());
+        QCOMPARE(restorer->restoredCount(), restored + 1);
+        QVERIFY(splitter->property(PendingProperty).isValid() == false);
+    }
+
+    void registerTwice_restoresOnce()
+    {
+        QScopedPointer<QSplitter> splitter(createSplitter("twice"));
+        LazyStateRestorer* restorer = LazyStateRestorer::instance();
+        int restored = restorer->restoredCount();
+
+        restorer->registerSplitter(splitter.data());
+        restorer->registerSplitter(splitter.data());
+        showSplitter(splitter.data());
+        QCOMPARE(restorer->restoredCount(), restored + 1);
+    }
+
+    void registerSplitters_findsNestedSplitters()
+    {
+        QScopedPointer<QSplitter> outer(createSplitter("outer"));
+        QSplitter* inner = createSplitter("inner");
+        outer->addWidget(inner);
+        LazyStateRestorer* restorer = LazyStateRestorer::instance();
+        int restored = restorer->restoredCount();
+
+        // The root itself is not a child, so only the inner splitter is registered
+        restorer->registerSplitters(outer.data());
+        QVERIFY(outer->property(PendingProperty).isValid() == false);
+        QVERIFY(inner->property(PendingProperty).isValid());
+
+        showSplitter(outer.data());
+        QCOMPARE(restorer->restoredCount(), restored + 1);
+    }
+
+    void recreatedInstance_registersAgain()
+    {
+        QScopedPointer<QSplitter> splitter(createSplitter("recreated"));
+        LazyStateRestorer* first = LazyStateRestorer::instance();
+        first->registerSplitter(splitter.data());
+        QVERIFY(splitter->property(PendingProperty).isValid());
+
+        // Destroying the instance drops its event filter but leaves the splitter's tag behind
+        delete first;
+        LazyStateRestorer* second = LazyStateRestorer::instance();
+        QVERIFY(second != nullptr);
+        QCOMPARE(second->restoredCount(), 0);
+
+        second->registerSplitter(splitter.data());
+        showSplitter(splitter.data());
+        QCOMPARE(second->restoredCount(), 1);
+        QVERIFY(splitter->property(PendingProperty).isValid() == false);
+    }
+
+    void noGlobalSettings_ignoresSplitter()
+    {
+        QScopedPointer<QSplitter> splitter(createSplitter("unsettled"));
+        GuiSettings::setGlobalInstance(nullptr);
+        LazyStateRestorer::instance()->registerSplitter(splitter.data());
+        GuiSettings::setGlobalInstance(_settings);
+        QVERIFY(splitter->property(PendingProperty).isValid() == false);
+    }
+};
+
+const char* TstLazyStateRestorer::PendingProperty = "_kanoopRestorePending";
+
+QTEST_MAIN(TstLazyStateRestorer)
+#include "tst_lazystaterestorer.moc"
@@ -0,0 +1,250 @@
+#include <QTest>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThread>
+#include <Kanoop/logconsumer.h>
+#include <Kanoop/gui/dialog.h>
+#include "logentryqueue.h"
+
+class HookDialog : public Dialog
+{
+public:
+    QList<Log::LogEntry> received;
+    int droppedCalls = 0;
+
+protected:
+    virtual void loggedItems(const QList<Log::LogEntry>& entries) override
+    {
+        for(const Log::LogEntry& entry : entries) {
+            if(entry.text().startsWith("hook ")) {
+                received.append(entry);
+            }
+        }
+    }
+
+    virtual void logEntriesDropped(int count) override { droppedCalls += count > 0 ? 1 : 0; }
+};
+
+class TstLogEntryQueue : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int ProducerCount = 4;
+    static const int EntriesPerProducer = 1000;
+    static const int ContendedCapacity = 64;
+
+    LogConsumer* _probe = nullptr;
+    QMutex _probeLock;
+    QList<Log::LogEntry> _captured;
+
+    Log::LogLevel _warningLevel = Log::LogLevel();
+    Log::LogLevel _errorLevel = Log::LogLevel();
+    QList<QList<Log::LogEntry>> _producerEntries;
+
+    /** Log the texts and return the entries the logger produced for them, in order. */
+    QList<Log::LogEntry> capture(const QStringList& texts, bool error = false)
+    {
+        for(const QString& text : texts) {
+            if(error) {
+                Log::logText(LVL_ERROR, text);
+            }
+            else {
+                Log::logText(LVL_WARNING, text);
+            }
+        }
+
+        // Consumers may be called from a logging thread
+        QDeadlineTimer deadline(10000);
+        while(capturedCount(texts) < texts.count() && deadline.hasExpired() == false) {
+            QTest::qWait(5);
+        }
+
+        QList<Log::LogEntry> result;
+        QMutexLocker locker(&_probeLock);
+        const QList<Log::LogEntry>& captured = _captured;
+        for(const QString& text : texts) {
+            for(const Log::LogEntry& entry : captured) {
+                if(entry.text() == text) {
+                    result.append(entry);
+                    break;
+                }
+            }
+        }
+        return result;
+    }
+
+    int capturedCount(const QStringList& texts)
+    {
+        QMutexLocker locker(&_probeLock);
+        int result = 0;
+        const QList<Log::LogEntry>& captured = _captured;
+        for(const Log::LogEntry& entry : captured) {
+            if(texts.contains(entry.text())) {
+                result++;
+            }
+        }
+        return result;
+    }
+
+    static QStringList texts(const QString& prefix, int count)
+    {
+        QStringList result;
+        for(int i = 0;i < count;i++) {
+            result.append(QString("%1 %2").arg(prefix).arg(i));
+        }
+        return result;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        _probe = new LogConsumer;
+        connect(_probe, &LogConsumer::logEntry, _probe, [this](const Log::LogEntry& entry) {
+            QMutexLocker locker(&_probeLock);
+            _captured.append(entry);
+        }, Qt::DirectConnection);
+        Log::addConsumer(_probe);
+
+        _warningLevel = capture({ "probe warning" }).value(0).level();
+        _errorLevel = capture({ "probe error" }, true).value(0).level();
+        QVERIFY(_warningLevel != _errorLevel);
+
+        for(int producer = 0;producer < ProducerCount;producer++) {
+            _producerEntries.append(capture(texts(QString("p%1").arg(producer), EntriesPerProducer)));
+            QCOMPARE(_producerEntries.last().count(), int(EntriesPerProducer));
+        }
+    }
+
+    void cleanupTestCase()
+    {
+        Log::removeConsumer(_probe);
+        delete _probe;
+        _probe = nullptr;
+    }
+
+    void capacity_roundsUpToPowerOfTwo()
+    {
+        QCOMPARE(LogEntryQueue(0).capacity(), 2);
+        QCOMPARE(LogEntryQueue(1).capacity(), 2);
+        QCOMPARE(LogEntryQueue(4).capacity(), 4);
+        QCOMPARE(LogEntryQueue(5).capacity(), 8);
+        QCOMPARE(LogEntryQueue(8192).capacity(), 8192);
+    }
+
+    void drain_keepsOrderAndCountsOverflow()
+    {
+        LogEntryQueue queue(4);
+        const QList<Log::LogEntry>& entries = _producerEntries.at(0);
+        for(int i = 0;i < 6;i++) {
+            QCOMPARE(queue.enqueue(entries.at(i)), i < 4);
+        }
+        QCOMPARE(queue.takeDroppedCount(), 2);
+        QCOMPARE(queue.takeDroppedCount(), 0);
+
+        QList<Log::LogEntry> drained = queue.drain(3);
+        QCOMPARE(drained.count(), 3);
+        QCOMPARE(drained.at(0).text(), entries.at(0).text());
+        QCOMPARE(drained.at(2).text(), entries.at(2).text());
+
+        // Drained slots are reused once the consumer has moved past them
+        QVERIFY(queue.enqueue(entries.at(6)));
+        drained = queue.drain(queue.capacity());
+        QCOMPARE(drained.count(), 2);
+        QCOMPARE(drained.at(0).text(), entries.at(3).text());
+        QCOMPARE(drained.at(1).text(), entries.at(6).text());
+        QVERIFY(queue.drain(queue.capacity()).isEmpty());
+    }
+
+    void setLevels_filtersBeforeQueuing()
+    {
+        LogEntryQueue queue(8);
+        Log::LogEntry warning = capture({ "filter warning" }).value(0);
+        Log::LogEntry error = capture({ "filter error" }, true).value(0);
+
+        queue.setLevels({ _errorLevel });
+        QVERIFY(queue.acceptsLevel(_warningLevel) == false);
+        QVERIFY(queue.enqueue(warning) == false);
+        QVERIFY(queue.enqueue(error));
+        QCOMPARE(queue.takeDroppedCount(), 0);
+
+        queue.setLevels({});
+        QVERIFY(queue.enqueue(warning));
+        QCOMPARE(queue.drain(8).count(), 2);
+    }
+
+    void enqueue_multipleProducersSingleConsumer()
+    {
+        LogEntryQueue queue(ContendedCapacity);
+        QList<QThread*> producers;
+        for(int producer = 0;producer < ProducerCount;producer++) {
+            const QList<Log::LogEntry>& entries = _producerEntries.at(producer);
+            producers.append(QThread::create([&queue, &entries]() {
+                for(const Log::LogEntry& entry : entries) {
+                    while(queue.enqueue(entry) == false) {
+                        QThread::yieldCurrentThread();
+                    }
+                }
+            }));
+        }
+        for(QThread* thread : producers) {
+            thread->start();
+        }
+
+        // Each producer's entries must arrive in its own order, none lost or duplicated
+        QList<int> next(ProducerCount, 0);
+        int total = 0;
+        int outOfOrder = 0;
+        QElapsedTimer timer;
+        timer.start();
+        while(total < ProducerCount * EntriesPerProducer && timer.elapsed() < 30000) {
+            const QList<Log::LogEntry> drained = queue.drain(queue.capacity());
+            for(const Log::LogEntry& entry : drained) {
+                QStringList parts = entry.text().split(' ');
+                int producer = parts.at(0).mid(1).toInt();
+                if(parts.at(1).toInt() != next.at(producer)) {
+                    outOfOrder++;
+                }
+                next[producer]++;
+                total++;
+            }
+        }
+
+        // Join before verifying; the producers reference the queue on this stack frame
+        bool joined = true;
+        for(QThread* thread : producers) {
+            joined = thread->wait(30000) && joined;
+            delete thread;
+        }
+        QVERIFY(joined);
+        QCOMPARE(outOfOrder, 0);
+        QCOMPARE(total, ProducerCount * EntriesPerProducer);
+        QVERIFY(queue.drain(queue.capacity()).isEmpty());
+    }
+
+    void dialogHook_deliversFilteredEntriesAndReportsDrops()
+    {
+        HookDialog dialog;
+        dialog.setLogHookCapacity(4);
+        dialog.setLogHookInterval(60000);
+        dialog.setLogHookLevels({ _warningLevel });
+        dialog.setLogHookEnabled(true);
+
+        // Nothing is drained while the interval is long, so the queue overflows
+        capture({ "hook error" }, true);
+        capture(texts("hook", 10));
+        QTest::qWait(50);
+
+        dialog.setLogHookInterval(1);
+        QTRY_VERIFY(dialog.droppedLogEntryCount() >= 6);
+        QTRY_COMPARE(dialog.received.count(), 4);
+        QCOMPARE(dialog.received.at(0).text(), QStringLiteral("hook 0"));
+        QCOMPARE(dialog.received.at(3).text(), QStringLiteral("hook 3"));
+        QCOMPARE(dialog.droppedCalls, 1);
+        dialog.setLogHookEnabled(false);
+    }
+};
+
+QTEST_MAIN(TstLogEntryQueue)
+#include "tst_logentryqueue.moc"
@@ -0,0 +1,110 @@
+#include <QTest>
+#include <QScrollBar>
+#include <Kanoop/gui/widgets/logviewer.h>
+
+class TstLogViewer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void append_splitsLines()
+    {
+        LogViewer viewer;
+        viewer.appendText("one\ntwo\r\nthree");
+        QCOMPARE(viewer.lineCount(), 3);
+        QCOMPARE(viewer.lineText(0), QStringLiteral("one"));
+        QCOMPARE(viewer.lineText(1), QStringLiteral("two"));
+        QCOMPARE(viewer.lineText(2), QStringLiteral("three"));
+    }
+
+    void ringBuffer_keepsNewestLines()
+    {
+        LogViewer viewer;
+        viewer.setMaximumLines(100);
+        for(int i = 0;i < 250;i++) {
+            viewer.appendText(QString("line %1").arg(i));
+        }
+        QCOMPARE(viewer.lineCount(), 100);
+        QCOMPARE(viewer.lineText(0), QStringLiteral("line 150"));
+        QCOMPARE(viewer.lineText(99), QStringLiteral("line 249"));
+
+        viewer.setMaximumLines(10);
+        QCOMPARE(viewer.lineCount(), 10);
+        QCOMPARE(viewer.lineText(0), QStringLiteral("line 240"));
+    }
+
+    void ringBuffer_reclaimsOverwrittenText()
+    {
+        // Enough churn of varying, multi-byte lines to compact the arena several times
+        LogViewer viewer;
+        viewer.setMaximumLines(1000);
+        for(int i = 0;i < 100000;i++) {
+            viewer.appendText(QString::fromUtf8("\xc3\xa9%1 ").arg(i) + QString(i % 97, QLatin1Char('x')));
+        }
+        QCOMPARE(viewer.lineCount(), 1000);
+        for(int i = 0;i < viewer.lineCount();i++) {
+            int n = 99000 + i;
+            QCOMPARE(viewer.lineText(i), QString::fromUtf8("\xc3\xa9%1 ").arg(n) + QString(n % 97, QLatin1Char('x')));
+        }
+        QCOMPARE(viewer.find(QString::fromUtf8("\xc3\xa9%1 ").arg(99500), false, Qt::CaseSensitive), 500);
+    }
+
+    void ringBuffer_overwriteKeepsScrolledLinesInPlace()
+    {
+        LogViewer viewer;
+        viewer.resize(300, 200);
+        viewer.setMaximumLines(200);
+        for(int i = 0;i < 200;i++) {
+            viewer.appendText(QString("line %1").arg(i));
+        }
+        QTRY_VERIFY(viewer.verticalScrollBar()->maximum() > 100);
+
+        // Scrolling up stops following the tail
+        viewer.verticalScrollBar()->setValue(100);
+        QVERIFY(viewer.isFollowingTail() == false);
+
+        // The position moves with the overwritten lines straight away, not on the next update
+        for(int i = 200;i < 210;i++) {
+            viewer.appendText(QString("line %1").arg(i));
+        }
+        QCOMPARE(viewer.verticalScrollBar()->value(), 90);
+        QCOMPARE(viewer.lineText(90), QStringLiteral("line 100"));
+
+        QTest::qWait(50);
+        QCOMPARE(viewer.verticalScrollBar()->value(), 90);
+        QVERIFY(viewer.isFollowingTail() == false);
+
+        // Shrinking the buffer drops lines above the view the same way
+        viewer.setMaximumLines(150);
+        QCOMPARE(viewer.verticalScrollBar()->value(), 40);
+        QCOMPARE(viewer.lineText(40), QStringLiteral("line 100"));
+    }
+
+    void find_wrapsAndTracksMatch()
+    {
+        LogViewer viewer;
+        viewer.appendText(QString::fromUtf8("alpha\nBeta \xc3\xa9t\xc3\xa9\ngamma\nbeta"));
+        QCOMPARE(viewer.find("beta"), 1);
+        QCOMPARE(viewer.find("beta"), 3);
+        QCOMPARE(viewer.find("beta"), 1);
+        QCOMPARE(viewer.find("beta", true), 3);
+        QCOMPARE(viewer.find("Beta", false, Qt::CaseSensitive), 1);
+        QCOMPARE(viewer.find(QString::fromUtf8("\xc3\xa9t\xc3\xa9"), false, Qt::CaseSensitive), 1);
+        QCOMPARE(viewer.currentMatch(), 1);
+        QCOMPARE(viewer.find("delta"), -1);
+    }
+
+    void benchmark_appendMillionLines()
+    {
+        QBENCHMARK_ONCE {
+            LogViewer viewer;
+            for(int i = 0;i < LogViewer::DefaultMaximumLines;i++) {
+                viewer.appendFormattedText(QStringLiteral("2026-01-01 12:00:00.000 worker: processed request"), LogViewer::NoTextFlags, Qt::darkGray);
+            }
+            QCOMPARE(viewer.lineCount(), int(LogViewer::DefaultMaximumLines));
+        }
+    }
+};
+
+QTEST_MAIN(TstLogViewer)
+#include "tst_logviewer.moc"
@@ -0,0 +1,147 @@
+#include <QTest>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <Kanoop/gui/widgets/plaintextedit.h>
+
+class TstPlainTextEdit : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int MaximumBlocks = 100;
+
+    /** Append lines "line <n>", padded with 'x' to the given length if one is set. */
+    static void appendLines(PlainTextEdit& edit, int first, int count, int length = 0)
+    {
+        for(int i = first;i < first + count;i++) {
+            QString text = QString("line %1").arg(i);
+            edit.appendText(length > 0 ? (text + ' ').leftJustified(length, 'x') : text);
+        }
+    }
+
+    /** Return the text of the block shown at the top of the viewport. */
+    static QString topBlockText(PlainTextEdit& edit)
+    {
+        return edit.cursorForPosition(QPoint(0, 0)).block().text();
+    }
+
+    static void showLogEdit(PlainTextEdit& edit)
+    {
+        edit.setLogModeEnabled(true);
+        edit.setMaximumLogBlocks(MaximumBlocks);
+        edit.setLineWrapMode(QPlainTextEdit::WidgetWidth);
+        edit.resize(300, 200);
+        edit.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&edit));
+    }
+
+private slots:
+    void logMode_queuesAndFlushesInOrder()
+    {
+        PlainTextEdit edit;
+        edit.setLogModeEnabled(true);
+        edit.appendText("a");
+        edit.appendFormattedText("b", PlainTextEdit::BoldText, Qt::red);
+        QCOMPARE(edit.pendingLineCount(), 2);
+        QVERIFY(edit.document()->isEmpty());
+
+        // Direct appends flush the queue first so lines stay in order
+        edit.appendPlainText("c");
+        QCOMPARE(edit.pendingLineCount(), 0);
+        QCOMPARE(edit.toPlainText(), QStringLiteral("a\nb\nc"));
+        QCOMPARE(edit.document()->findBlockByNumber(1).charFormat().foreground().color(), QColor(Qt::red));
+
+        edit.appendText("d");
+        QTRY_COMPARE(edit.pendingLineCount(), 0);
+        QCOMPARE(edit.toPlainText(), QStringLiteral("a\nb\nc\nd"));
+    }
+
+    void logMode_trimsInBatches()
+    {
+        PlainTextEdit edit;
+        edit.setLogModeEnabled(true);
+        edit.setMaximumLogBlocks(MaximumBlocks);
+
+        // Less than a tenth over the limit is left alone
+        appendLines(edit, 0, MaximumBlocks + 5);
+        edit.flushPendingLines();
+        QCOMPARE(edit.document()->blockCount(), MaximumBlocks + 5);
+
+        appendLines(edit, MaximumBlocks + 5, 5);
+        edit.flushPendingLines();
+        QCOMPARE(edit.document()->blockCount(), int(MaximumBlocks));
+        QCOMPARE(edit.document()->firstBlock().text(), QStringLiteral("line 10"));
+        QCOMPARE(edit.document()->lastBlock().text(), QString("line %1").arg(MaximumBlocks + 9));
+
+        // A burst larger than the limit only inserts the lines that survive
+        appendLines(edit, 1000, MaximumBlocks * 3);
+        edit.flushPendingLines();
+        QCOMPARE(edit.document()->blockCount(), int(MaximumBlocks));
+        QCOMPARE(edit.document()->firstBlock().text(), QString("line %1").arg(1000 + MaximumBlocks * 2));
+    }
+
+    void logMode_pinnedViewFollowsOutput()
+    {
+        PlainTextEdit edit;
+        showLogEdit(edit);
+        appendLines(edit, 0, MaximumBlocks);
+        edit.flushPendingLines();
+        edit.verticalScrollBar()->setValue(edit.verticalScrollBar()->maximum());
+        QVERIFY(edit.isPinnedToBottom());
+
+        appendLines(edit, MaximumBlocks, 20);
+        edit.flushPendingLines();
+        QVERIFY(edit.isPinnedToBottom());
+        QCOMPARE(edit.document()->lastBlock().text(), QString("line %1").arg(MaximumBlocks + 19));
+    }
+
+    void logMode_unpinnedViewKeepsWrappedLinesInPlace()
+    {
+        PlainTextEdit edit;
+        showLogEdit(edit);
+
+        // Every block wraps to several lines, so trimming moves the scroll bar by more than the block count
+        appendLines(edit, 0, MaximumBlocks, 200);
+        edit.flushPendingLines();
+        QVERIFY(edit.document()->firstBlock().lineCount() > 1);
+
+        edit.verticalScrollBar()->setValue(edit.verticalScrollBar()->maximum() / 2);
+        QVERIFY(edit.isPinnedToBottom() == false);
+        QString topText = topBlockText(edit);
+
+        appendLines(edit, MaximumBlocks, 20, 200);
+        edit.flushPendingLines();
+        QCOMPARE(edit.document()->blockCount(), int(MaximumBlocks));
+        QVERIFY(edit.isPinnedToBottom() == false);
+        QCOMPARE(topBlockText(edit), topText);
+    }
+
+    void logMode_restoresUndoRedo()
+    {
+        PlainTextEdit edit;
+        QVERIFY(edit.document()->isUndoRedoEnabled());
+        edit.setLogModeEnabled(true);
+        QVERIFY(edit.document()->isUndoRedoEnabled() == false);
+        edit.setLogModeEnabled(false);
+        QVERIFY(edit.document()->isUndoRedoEnabled());
+
+        // A document that had undo turned off keeps it off
+        edit.setUndoRedoEnabled(false);
+        edit.setLogModeEnabled(true);
+        edit.setLogModeEnabled(false);
+        QVERIFY(edit.document()->isUndoRedoEnabled() == false);
+    }
+
+    void logMode_disableFlushesQueue()
+    {
+        PlainTextEdit edit;
+        edit.setLogModeEnabled(true);
+        edit.appendText("queued");
+        edit.setLogModeEnabled(false);
+        QCOMPARE(edit.pendingLineCount(), 0);
+        QCOMPARE(edit.toPlainText(), QStringLiteral("queued"));
+    }
+};
+
+QTEST_MAIN(TstPlainTextEdit)
+#include "tst_plaintextedit.moc"
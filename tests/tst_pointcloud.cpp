@@ -0,0 +1,309 @@
+#include <QTest>
+#include <QGraphicsView>
+#include <QImage>
+#include <QPainter>
+#include <algorithm>
+#include <Kanoop/gui/graphics/graphicsscene.h>
+#include <Kanoop/gui/graphics/ellipsegraphicsitem.h>
+#include <Kanoop/gui/graphics/pointcloudgraphicsitem.h>
+
+class TstPointCloud : public QObject
+{
+    Q_OBJECT
+
+private:
+    enum ItemType
+    {
+        CloudType = QGraphicsItem::UserType + 1,
+        EllipseType,
+    };
+
+    static const int BenchmarkPoints = 1000000;
+    static const int BenchmarkImageSize = 1024;
+
+    /** A 1000x1000 unit grid of points, one per unit */
+    QList<float> gridPoints(int count) const
+    {
+        QList<float> result;
+        result.reserve(qsizetype(count) * 2);
+        for(int i = 0;i < count;i++) {
+            result.append(float(i % 1000));
+            result.append(float(i / 1000));
+        }
+        return result;
+    }
+
+    void renderScene(GraphicsScene& scene) const
+    {
+        QImage image(BenchmarkImageSize, BenchmarkImageSize, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        scene.render(&painter, QRectF(image.rect()), QRectF(0, 0, 1000, 1000));
+    }
+
+    void benchmarkCloud(PointCloudGraphicsItem::RenderMode mode)
+    {
+        GraphicsScene scene;
+        PointCloudGraphicsItem* cloud = new PointCloudGraphicsItem(CloudType);
+        QList<float> xy = gridPoints(BenchmarkPoints);
+        cloud->setPoints(xy.constData(), BenchmarkPoints);
+        cloud->setRenderMode(mode);
+        cloud->setPointSize(1);
+        scene.addItem(cloud);
+
+        QBENCHMARK {
+            renderScene(scene);
+        }
+    }
+
+private slots:
+    void setPoints_storesPointsAndBounds()
+    {
+        PointCloudGraphicsItem cloud(CloudType);
+        QCOMPARE(cloud.pointCount(), 0);
+        QVERIFY(cloud.boundingRect().isEmpty());
+
+        cloud.setPoints({ QPointF(1, 2), QPointF(-3, 4), QPointF(5, -6) });
+        QCOMPARE(cloud.pointCount(), 3);
+        QCOMPARE(cloud.point(1), QPointF(-3, 4));
+        QCOMPARE(cloud.pointColor(2), QColor(Qt::black).rgba());
+        QVERIFY(cloud.boundingRect().contains(QRectF(QPointF(-3, -6), QPointF(5, 4))));
+
+        cloud.clear();
+        QCOMPARE(cloud.pointCount(), 0);
+    }
+
+    void setPoints_perPointColors()
+    {
+        PointCloudGraphicsItem cloud(CloudType);
+        cloud.setPoints({ QPointF(0, 0), QPointF(1, 1) }, { qRgb(255, 0, 0), qRgb(0, 255, 0) });
+        QCOMPARE(cloud.pointColor(0), qRgb(255, 0, 0));
+        QCOMPARE(cloud.pointColor(1), qRgb(0, 255, 0));
+
+        // Mismatched color count falls back to the default color
+        cloud.setColor(Qt::blue);
+        cloud.setPoints({ QPointF(0, 0), QPointF(1, 1) }, { qRgb(255, 0, 0) });
+        QCOMPARE(cloud.pointColor(1), QColor(Qt::blue).rgba());
+    }
+
+    void updatePoints_replacesRange()
+    {
+        PointCloudGraphicsItem cloud(CloudType);
+        QList<float> xy = gridPoints(100);
+        cloud.setPoints(xy.constData(), 100);
+
+        float moved[] = { 500, 500, 501, 501 };
+        QRgb colors[] = { qRgb(1, 2, 3), qRgb(4, 5, 6) };
+        cloud.updatePoints(10, moved, 2, colors);
+        QCOMPARE(cloud.point(10), QPointF(500, 500));
+        QCOMPARE(cloud.point(11), QPointF(501, 501));
+        QCOMPARE(cloud.point(12), QPointF(12, 0));
+        QCOMPARE(cloud.pointColor(11), qRgb(4, 5, 6));
+        QCOMPARE(cloud.pointColor(12), QColor(Qt::black).rgba());
+        QVERIFY(cloud.boundingRect().contains(QPointF(501, 501)));
+
+        // The range is clipped to the existing points
+        cloud.updatePoints(99, moved, 2);
+        QCOMPARE(cloud.pointCount(), 100);
+        QCOMPARE(cloud.point(99), QPointF(500, 500));
+
+        // The grid index follows the update
+        QCOMPARE(cloud.pointAt(QPointF(500.2, 500.2), 1), 10);
+        QCOMPARE(cloud.pointAt(QPointF(10, 0), 0.5), -1);
+    }
+
+    void updatePoints_movesGridCells()
+    {
+        PointCloudGraphicsItem cloud(CloudType);
+        QList<float> xy = gridPoints(10000);
+        cloud.setPoints(xy.constData(), 10000);
+        QCOMPARE(cloud.pointAt(QPointF(5, 5), 0.1), 5005);
+
+        // Move one point across the cloud, then back home
+        float moved[] = { 90.2f, 8.2f };
+        cloud.updatePoints(5005, moved, 1);
+        QCOMPARE(cloud.pointAt(QPointF(5, 5), 0.1), -1);
+        QCOMPARE(cloud.pointAt(QPointF(90.2, 8.2), 0.1), 5005);
+        QCOMPARE(cloud.pointsIn(QRectF(90, 8, 0.5, 0.5)).count(), 2);
+
+        float home[] = { 5, 5 };
+        cloud.updatePoints(5005, home, 1);
+        QCOMPARE(cloud.pointAt(QPointF(5, 5), 0.1), 5005);
+        QCOMPARE(cloud.pointsIn(QRectF(4.5, 4.5, 1, 1)), QList<int>({ 5005 }));
+        QCOMPARE(cloud.pointsIn(QRectF(90, 8, 0.5, 0.5)), QList<int>({ 8090 }));
+    }
+
+    void updatePoints_cachedImageRedrawsDirtyArea()
+    {
+        GraphicsScene scene;
+        PointCloudGraphicsItem* cloud = new PointCloudGraphicsItem(CloudType);
+        cloud->setPoints({ QPointF(5, 5), QPointF(10, 10), QPointF(45, 45) }, { qRgb(0, 0, 255), qRgb(255, 0, 0), qRgb(0, 0, 255) });
+        cloud->setPointSize(2);
+        cloud->setRenderMode(PointCloudGraphicsItem::CachedImage);
+        scene.addItem(cloud);
+
+        auto render = [&scene]() {
+            QImage image(50, 50, QImage::Format_ARGB32_Premultiplied);
+            image.fill(Qt::white);
+            QPainter painter(&image);
+            scene.render(&painter, QRectF(image.rect()), QRectF(0, 0, 50, 50));
+            painter.end();
+            return image;
+        };
+        QCOMPARE(render().pixel(10, 10), qRgb(255, 0, 0));
+
+        float moved[] = { 30, 30 };
+        cloud->updatePoints(1, moved, 1);
+        QImage image = render();
+        QCOMPARE(image.pixel(10, 10), qRgb(255, 255, 255));
+        QCOMPARE(image.pixel(30, 30), qRgb(255, 0, 0));
+        QCOMPARE(image.pixel(5, 5), qRgb(0, 0, 255));
+        QCOMPARE(image.pixel(45, 45), qRgb(0, 0, 255));
+    }
+
+    void boundingRect_padsByPointSize()
+    {
+        PointCloudGraphicsItem cloud(CloudType);
+        cloud.setPoints({ QPointF(0, 0), QPointF(10, 10) });
+        cloud.setPickRadius(0.5);
+        cloud.setPointSize(6);
+
+        // Without a view one device pixel is one item unit
+        QCOMPARE(cloud.boundingRect(), QRectF(-6, -6, 22, 22));
+        cloud.setPickRadius(8);
+        QCOMPARE(cloud.boundingRect(), QRectF(-8, -8, 26, 26));
+    }
+
+    void boundingRect_independentOfViewScale()
+    {
+        GraphicsScene scene;
+        PointCloudGraphicsItem* cloud = new PointCloudGraphicsItem(CloudType);
+        cloud->setPoints({ QPointF(0, 0), QPointF(10, 10) });
+        cloud->setPointSize(6);
+        scene.addItem(cloud);
+        QRectF bounds = cloud->boundingRect();
+
+        // Zooming never changes the rect the scene index holds for the item
+        QGraphicsView view(&scene);
+        view.scale(0.25, 0.25);
+        QCOMPARE(cloud->boundingRect(), bounds);
+        view.scale(16, 16);
+        QCOMPARE(cloud->boundingRect(), bounds);
+        QCOMPARE(bounds, QRectF(-6, -6, 22, 22));
+    }
+
+    void pointAt_zeroRadiusHitsExactPoint()
+    {
+        PointCloudGraphicsItem cloud(CloudType);
+        QList<float> xy = gridPoints(10000);
+        cloud.setPoints(xy.constData(), 10000);
+        QCOMPARE(cloud.pointAt(QPointF(42, 7), 0), 7042);
+        QCOMPARE(cloud.pointAt(QPointF(42.1, 7), 0), -1);
+
+        cloud.setPickRadius(0);
+        QVERIFY(cloud.contains(QPointF(3, 2)));
+        QVERIFY(cloud.contains(QPointF(3, 2.1)) == false);
+
+        // A single point has zero-size bounds
+        cloud.setPoints({ QPointF(5, 5) });
+        QCOMPARE(cloud.pointAt(QPointF(5, 5), 0), 0);
+        QCOMPARE(cloud.pointAt(QPointF(5.5, 5), 1), 0);
+        QCOMPARE(cloud.pointAt(QPointF(7, 5), 1), -1);
+    }
+
+    void pointAt_returnsNearest()
+    {
+        PointCloudGraphicsItem cloud(CloudType);
+        QList<float> xy = gridPoints(10000);
+        cloud.setPoints(xy.constData(), 10000);
+
+        QCOMPARE(cloud.pointAt(QPointF(42.2, 7.1), 0.5), 7042);
+        QCOMPARE(cloud.pointAt(QPointF(42.6, 7.0), 0.5), 7043);
+        QCOMPARE(cloud.pointAt(QPointF(42.5, 7.5), 0.1), -1);
+        QCOMPARE(cloud.pointAt(QPointF(-50, -50), 1), -1);
+
+        cloud.setPickRadius(0.25);
+        QVERIFY(cloud.contains(QPointF(3.1, 2.1)));
+        QVERIFY(cloud.contains(QPointF(3.5, 2.5)) == false);
+    }
+
+    void pointsIn_matchesLinearScan()
+    {
+        PointCloudGraphicsItem cloud(CloudType);
+        QList<float> xy = gridPoints(10000);
+        cloud.setPoints(xy.constData(), 10000);
+
+        QRectF rect(10.5, 2.5, 5, 3);
+        QList<int> expected;
+        for(int i = 0;i < cloud.pointCount();i++) {
+            if(rect.contains(cloud.point(i))) {
+                expected.append(i);
+            }
+        }
+        QList<int> found = cloud.pointsIn(rect);
+        std::sort(found.begin(), found.end());
+        QCOMPARE(found.count(), 15);
+        QCOMPARE(found, expected);
+        QVERIFY(cloud.pointsIn(QRectF(-20, -20, 5, 5)).isEmpty());
+    }
+
+    void registry_tracksCloud()
+    {
+        GraphicsScene scene;
+        PointCloudGraphicsItem* cloud = new PointCloudGraphicsItem(CloudType);
+        scene.addItem(cloud);
+        QCOMPARE(scene.itemCountOfType(CloudType), 1);
+        delete cloud;
+        QCOMPARE(scene.itemCountOfType(CloudType), 0);
+    }
+
+    void render_bothModesDrawPoint()
+    {
+        for(PointCloudGraphicsItem::RenderMode mode : { PointCloudGraphicsItem::DrawPoints, PointCloudGraphicsItem::CachedImage }) {
+            GraphicsScene scene;
+            PointCloudGraphicsItem* cloud = new PointCloudGraphicsItem(CloudType);
+            cloud->setPoints({ QPointF(25, 25) }, { qRgb(255, 0, 0) });
+            cloud->setPointSize(4);
+            cloud->setRenderMode(mode);
+            scene.addItem(cloud);
+
+            QImage image(50, 50, QImage::Format_ARGB32_Premultiplied);
+            image.fill(Qt::white);
+            QPainter painter(&image);
+            scene.render(&painter, QRectF(image.rect()), QRectF(0, 0, 50, 50));
+            painter.end();
+
+            QCOMPARE(image.pixel(25, 25), qRgb(255, 0, 0));
+            QCOMPARE(image.pixel(5, 5), qRgb(255, 255, 255));
+        }
+    }
+
+    void benchmark_cloudDrawPoints()
+    {
+        benchmarkCloud(PointCloudGraphicsItem::DrawPoints);
+    }
+
+    void benchmark_cloudCachedImage()
+    {
+        benchmarkCloud(PointCloudGraphicsItem::CachedImage);
+    }
+
+    void benchmark_ellipseItems()
+    {
+        GraphicsScene scene;
+        for(int i = 0;i < BenchmarkPoints;i++) {
+            EllipseGraphicsItem* item = new EllipseGraphicsItem(EllipseType);
+            item->setRect(i % 1000, i / 1000, 1, 1);
+            item->setPen(Qt::NoPen);
+            item->setBrush(Qt::black);
+            scene.addItem(item);
+        }
+
+        QBENCHMARK_ONCE {
+            renderScene(scene);
+        }
+    }
+};
+
+QTEST_MAIN(TstPointCloud)
+#include "tst_pointcloud.moc"
@@ -1,5 +1,9 @@
 #include <QTest>
+#include <QImage>
+#include <QSignalSpy>
+#include <QTemporaryDir>
 #include <Kanoop/gui/resources.h>
+#include <Kanoop/gui/resourceloader.h>
 
 class TstResources : public QObject
 {
@@ -55,6 +59,123 @@ private slots:
         Resources::registerImage(testId, ":/path/b.png");
         // Should not crash; second call replaces first
     }
+
+    void getPixmap_repeated_servedFromCache()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QString path = dir.filePath("cached.png");
+        QImage image(16, 16, QImage::Format_ARGB32);
+        image.fill(Qt::red);
+        QVERIFY(image.save(path));
+
+        int testId = Resources::FirstUserResource + 9980;
+        Resources::registerImage(testId, path);
+        Resources::resetCacheStatistics();
+
+        QPixmap first = Resources::getPixmap(testId);
+        QVERIFY(first.isNull() == false);
+        QCOMPARE(Resources::cacheMisses(), quint64(1));
+
+        QPixmap second = Resources::getPixmap(testId);
+        QCOMPARE(second.cacheKey(), first.cacheKey());
+        QCOMPARE(Resources::cacheHits(), quint64(1));
+    }
+
+    void getPixmap_scaled_honoursDevicePixelRatio()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QString path = dir.filePath("scaled.png");
+        QImage image(64, 64, QImage::Format_ARGB32);
+        image.fill(Qt::blue);
+        QVERIFY(image.save(path));
+
+        int testId = Resources::FirstUserResource + 9981;
+        Resources::registerImage(testId, path);
+
+        QPixmap pm = Resources::getPixmap(testId, QSize(16, 16), 2.0);
+        QCOMPARE(pm.size(), QSize(32, 32));
+        QCOMPARE(pm.devicePixelRatio(), 2.0);
+    }
+
+    void preloadAsync_emitsReadyAndCaches()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QString path = dir.filePath("async.png");
+        QImage image(24, 24, QImage::Format_ARGB32);
+        image.fill(Qt::green);
+        QVERIFY(image.save(path));
+
+        int testId = Resources::FirstUserResource + 9982;
+        Resources::registerImage(testId, path);
+
+        QSignalSpy readySpy(Resources::loader(), &ResourceLoader::imageReady);
+        QSignalSpy finishedSpy(Resources::loader(), &ResourceLoader::preloadFinished);
+        Resources::preloadAsync({ testId });
+        QVERIFY(finishedSpy.wait(5000));
+        QCOMPARE(readySpy.count(), 1);
+        QCOMPARE(readySpy.first().at(0).toInt(), testId);
+        QVERIFY(Resources::isLoading(testId) == false);
+
+        Resources::resetCacheStatistics();
+        QVERIFY(Resources::getPixmap(testId).isNull() == false);
+        QCOMPARE(Resources::cacheHits(), quint64(1));
+    }
+
+    void preloadAsync_survivesLoaderDestruction()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QString path = dir.filePath("orphan.png");
+        QImage image(24, 24, QImage::Format_ARGB32);
+        image.fill(Qt::cyan);
+        QVERIFY(image.save(path));
+
+        int testId = Resources::FirstUserResource + 9985;
+        Resources::registerImage(testId, path);
+
+        // Results are queued to the GUI thread, so the loader is gone before any arrive
+        ResourceLoader* first = Resources::loader();
+        Resources::preloadAsync({ testId });
+        delete first;
+
+        QTRY_VERIFY_WITH_TIMEOUT(Resources::isLoading(testId) == false, 5000);
+        QVERIFY(Resources::loader() != nullptr);
+        Resources::resetCacheStatistics();
+        QVERIFY(Resources::getPixmap(testId).isNull() == false);
+        QCOMPARE(Resources::cacheHits(), quint64(1));
+    }
+
+    void createAtlas_packsRegisteredImages()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QString path = dir.filePath("atlas.png");
+        QImage image(40, 40, QImage::Format_ARGB32);
+        image.fill(Qt::yellow);
+        QVERIFY(image.save(path));
+
+        int testId = Resources::FirstUserResource + 9983;
+        Resources::registerImage(testId, path);
+
+        QSize cellSize(20, 20);
+        Resources::createAtlas(cellSize);
+        QVERIFY(Resources::hasAtlas(cellSize));
+        QCOMPARE(Resources::atlasRect(testId, cellSize).size(), cellSize);
+
+        QPixmap atlas = Resources::atlasPixmap(cellSize);
+        QVERIFY(atlas.isNull() == false);
+        QCOMPARE(atlas.width() & (atlas.width() - 1), 0);
+        QCOMPARE(atlas.height() & (atlas.height() - 1), 0);
+
+        // registered after the atlas exists
+        int lateId = Resources::FirstUserResource + 9984;
+        Resources::registerImage(lateId, path);
+        QVERIFY(Resources::atlasRect(lateId, cellSize).isNull() == false);
+        QVERIFY(Resources::atlasRect(lateId, cellSize) != Resources::atlasRect(testId, cellSize));
+    }
 };
 
 QTEST_MAIN(TstResources)
@@ -1,10 +1,21 @@
 #include <QTest>
+#include <QApplication>
+#include <QFrame>
+#include <QPushButton>
+#include <QWidget>
 #include <Kanoop/gui/stylesheets.h>
+#include <Kanoop/gui/utility/stylesheetcache.h>
+#include <Kanoop/gui/utility/theme.h>
+#include <Kanoop/gui/widgets/label.h>
+#include <Kanoop/gui/widgets/pushbutton.h>
 
 class TstStyleSheets : public QObject
 {
     Q_OBJECT
 
+private:
+    static const int ThemeLabelCount = 5000;
+
 private slots:
     void backgroundColor_formatsRgb()
     {
@@ -42,6 +53,167 @@ private slots:
         QString result = StyleSheets::borderRadius(0);
         QVERIFY(result.contains("0"));
     }
+
+    void styleSheetCache_internSharesData()
+    {
+        StyleSheetCache::clear();
+        QString a = StyleSheetCache::intern(QString("QLabel { color: #ff000000 }"));
+        QString b = StyleSheetCache::intern(QString("QLabel { color: #ff000000 }"));
+        QCOMPARE(a.constData(), b.constData());
+        QCOMPARE(StyleSheetCache::count(), 1);
+    }
+
+    void styleSheetCache_applySkipsUnchanged()
+    {
+        StyleSheetCache::clear();
+        QWidget widget;
+        QVERIFY(StyleSheetCache::apply(&widget, "QWidget { color: #ff112233 }"));
+        QVERIFY(StyleSheetCache::apply(&widget, "QWidget { color: #ff112233 }") == false);
+        QVERIFY(StyleSheetCache::apply(&widget, "QWidget { color: #ff445566 }"));
+        QCOMPARE(StyleSheetCache::appliedCount(), quint64(2));
+        QCOMPARE(StyleSheetCache::skippedCount(), quint64(1));
+    }
+
+    void styleSheet_propertySelector_followsTypeName()
+    {
+        StyleSheet<QWidget> ss;
+        ss.addPropertySelector("state", "error");
+        ss.setPseudoState(PS_Hover);
+        ss.setProperty(SP_Color, QColor(Qt::red));
+        QVERIFY(ss.toString().startsWith(QStringLiteral("QWidget[state=\"error\"]:hover {")));
+    }
+
+    void styleSheet_toString_exactFormat()
+    {
+        StyleSheet<QPushButton> ss;
+        ss.setPseudoState(PS_Hover);
+        ss.setProperty(SP_Color, QColor(Qt::blue));
+        ss.setProperty(SP_BackgroundColor, QColor(Qt::red));
+        ss.setProperty(SP_Color, QColor(Qt::green));
+        QCOMPARE(ss.toString(), QStringLiteral("QPushButton:hover { background-color: #ffff0000; color: #ff00ff00 }"));
+    }
+
+    void styleSheet_border_formatsRgba()
+    {
+        StyleSheet<QFrame> ss;
+        ss.setSubControl(SC_Handle);
+        ss.setBorder(2, QColor(1, 2, 3, 4), QColor(5, 6, 7));
+        QCOMPARE(ss.toString(), QStringLiteral("QFrame::handle { border-top: 2px solid rgba(1,2,3,4); "
+                                               "border-right: 2px solid rgba(5,6,7,255); "
+                                               "border-bottom: 2px solid rgba(5,6,7,255); "
+                                               "border-left: 2px solid rgba(1,2,3,4) }"));
+    }
+
+    void styleSheet_radialGradient_formats()
+    {
+        StyleSheet<QWidget> ss;
+        ss.setRadialGradient(0.5, 0.5, 0.75, 0.5, 0.25, { { 0, QColor(255, 255, 255) }, { 1, QColor(0, 0, 0, 128) } });
+        QCOMPARE(ss.toString(), QStringLiteral("QWidget { background: qradialgradient(cx:0.5, cy:0.5, radius:0.75, fx:0.5, fy:0.25, "
+                                               "stop:0 rgba(255,255,255,255), stop:1 rgba(0,0,0,128)) }"));
+    }
+
+    void benchmark_pushButtonFourBlocks()
+    {
+        QColor fg(Qt::black), bg(Qt::lightGray), hoverBg(Qt::white), pressedBg(Qt::darkGray), disabledFg(Qt::gray);
+        qsizetype total = 0;
+        QBENCHMARK {
+            StyleSheet<QPushButton> base;
+            base.setProperty(SP_Color, fg);
+            base.setProperty(SP_BackgroundColor, bg);
+            base.setPropertyPixels(SP_BorderRadius, 6);
+            QString ss = base.toString();
+
+            StyleSheet<QPushButton> hover;
+            hover.setPseudoState(PS_Hover);
+            hover.setProperty(SP_BackgroundColor, hoverBg);
+            ss += " " + hover.toString();
+
+            StyleSheet<QPushButton> pressed;
+            pressed.setPseudoState(PS_Pressed);
+            pressed.setProperty(SP_BackgroundColor, pressedBg);
+            ss += " " + pressed.toString();
+
+            StyleSheet<QPushButton> disabled;
+            disabled.setPseudoState(PS_Disabled);
+            disabled.setProperty(SP_Color, disabledFg);
+            ss += " " + disabled.toString();
+            total += ss.size();
+        }
+        QVERIFY(total > 0);
+    }
+
+    void theme_compilesRulesOnce()
+    {
+        Theme theme("Test", Palette::fusionDark());
+        StyleSheet<QWidget> error;
+        error.addPropertySelector("state", "error");
+        error.setProperty(SP_Color, QColor(Qt::red));
+        theme.addRule(error);
+        theme.addRule(QStringLiteral("QWidget { font-weight: bold }"));
+
+        QString compiled = theme.styleSheet();
+        QCOMPARE(compiled.count(QLatin1Char('\n')), 2);
+        QVERIFY(compiled.contains(error.toString()));
+        QCOMPARE(theme.styleSheet().constData(), compiled.constData());
+    }
+
+    void theme_setWidgetState_onlyOnChange()
+    {
+        QWidget widget;
+        QVERIFY(Theme::setWidgetState(&widget, "state", "error"));
+        QVERIFY(Theme::setWidgetState(&widget, "state", "error") == false);
+        QCOMPARE(widget.property("state").toString(), QStringLiteral("error"));
+    }
+
+    void theme_fusionThemes_compileStateRules()
+    {
+        for(const Theme& theme : { Theme::fusionLight(), Theme::fusionDark() }) {
+            QString compiled = theme.styleSheet();
+            QVERIFY(theme.states().contains(Theme::ErrorState));
+            QVERIFY(compiled.contains(QStringLiteral("QLabel[themeState=\"error\"]")));
+            QVERIFY(compiled.contains(QStringLiteral("QLineEdit[themeState=\"warning\"]")));
+            QVERIFY(compiled.contains(QStringLiteral("QPushButton[themeState=\"highlight\"]")));
+            QVERIFY(compiled.contains(QStringLiteral("QStatusBar[themeState=\"success\"]")));
+        }
+    }
+
+    void theme_widgetStates_needNoInstanceStyleSheet()
+    {
+        Theme theme = Theme::fusionLight();
+        theme.apply();
+
+        Label label;
+        PushButton button;
+        label.setThemeState(Theme::ErrorState);
+        button.setThemeState(Theme::ErrorState);
+        QCOMPARE(label.themeState(), Theme::ErrorState);
+        QVERIFY(label.styleSheet().isEmpty());
+        QVERIFY(button.styleSheet().isEmpty());
+        label.ensurePolished();
+        QCOMPARE(label.palette().color(QPalette::WindowText), theme.stateForeground(Theme::ErrorState));
+
+        label.setThemeState(QString());
+        QVERIFY(label.property(Theme::StateProperty).isValid() == false);
+        qApp->setStyleSheet(QString());
+        QApplication::setPalette(QPalette());
+    }
+
+    void benchmark_themeSwitch5000Labels()
+    {
+        QWidget parent;
+        for(int i = 0;i < ThemeLabelCount;i++) {
+            Label* label = new Label(QString::number(i), &parent);
+            label->setThemeState(i % 2 ? Theme::ErrorState : Theme::SuccessState);
+        }
+        Theme light = Theme::fusionLight();
+        Theme dark = Theme::fusionDark();
+        int iteration = 0;
+        QBENCHMARK {
+            (iteration++ % 2 ? light : dark).apply();
+        }
+        qApp->setStyleSheet(QString());
+        QApplication::setPalette(QPalette());
+    }
 };
 
 QTEST_MAIN(TstStyleSheets)
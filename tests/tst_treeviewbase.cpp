@@ -0,0 +1,435 @@
+#include <QTest>
+#include <QSignalSpy>
+#include <QSortFilterProxyModel>
+#include <QTimer>
+#include <Kanoop/stringutil.h>
+#include <Kanoop/gui/abstractitemmodel.h>
+#include <Kanoop/gui/treeselectionmodel.h>
+#include <Kanoop/gui/treeviewbase.h>
+
+class TreeItem : public AbstractModelItem
+{
+public:
+    TreeItem(const QUuid& uuid, const QString& text, AbstractItemModel* model) :
+        AbstractModelItem(metadata(uuid), model, uuid),
+        _text(text) {}
+
+    virtual QVariant data(const QModelIndex& index, int role) const override
+    {
+        if(role == Qt::DisplayRole) {
+            return _text;
+        }
+        return AbstractModelItem::data(index, role);
+    }
+
+    QList<QUuid> lazyChildren;
+    bool fetching = false;
+
+private:
+    static EntityMetadata metadata(const QUuid& uuid)
+    {
+        EntityMetadata result(1);
+        result.setData(uuid, KANOOP::UUidRole);
+        return result;
+    }
+
+    QString _text;
+};
+
+class LeafItem : public TreeItem
+{
+public:
+    LeafItem(const QUuid& uuid, const QString& text, AbstractItemModel* model) :
+        TreeItem(uuid, text, model) {}
+};
+
+class TreeModel : public AbstractItemModel
+{
+public:
+    static const int FetchDelay = 50;
+
+    /** Append a root item and its children; lazy children are only delivered by fetchMore(). */
+    TreeItem* appendTree(const QUuid& uuid, const QList<QUuid>& children, bool lazy = false)
+    {
+        int row = rootItemCount();
+        TreeItem* root = new TreeItem(uuid, QString("r%1").arg(row, 3, 10, QChar('0')), this);
+        if(lazy) {
+            root->lazyChildren = children;
+        }
+        else {
+            for(int i = 0;i < children.count();i++) {
+                root->appendChild(new LeafItem(children.at(i), QString("r%1c%2").arg(row, 3, 10, QChar('0')).arg(i), this));
+            }
+        }
+        appendRootItem(root);
+        return root;
+    }
+
+    virtual bool hasChildren(const QModelIndex& parent) const override
+    {
+        TreeItem* item = itemAt(parent);
+        if(item != nullptr && item->lazyChildren.isEmpty() == false) {
+            return true;
+        }
+        return AbstractItemModel::hasChildren(parent);
+    }
+
+    virtual bool canFetchMore(const QModelIndex& parent) const override
+    {
+        TreeItem* item = itemAt(parent);
+        return item != nullptr && item->lazyChildren.isEmpty() == false && item->fetching == false;
+    }
+
+    virtual void fetchMore(const QModelIndex& parent) override
+    {
+        TreeItem* item = itemAt(parent);
+        if(canFetchMore(parent) == false) {
+            return;
+        }
+
+        // Deliver the children later, the way a model backed by a remote source would
+        item->fetching = true;
+        QPersistentModelIndex persistent(parent);
+        QTimer::singleShot(FetchDelay, this, [this, item, persistent]() {
+            beginInsertRows(persistent, 0, item->lazyChildren.count() - 1);
+            for(int i = 0;i < item->lazyChildren.count();i++) {
+                item->appendChild(new LeafItem(item->lazyChildren.at(i), QString("lazy%1").arg(i), this));
+            }
+            item->lazyChildren.clear();
+            endInsertRows();
+        });
+    }
+
+private:
+    static TreeItem* itemAt(const QModelIndex& index) { return static_cast<TreeItem*>(index.internalPointer()); }
+};
+
+class TstTreeViewBase : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int RootCount = 80;
+    static const int ChildCount = 3;
+
+    QList<QUuid> _rootUuids;
+    QList<QList<QUuid>> _childUuids;
+
+    /** Populate the model with RootCount roots of ChildCount children each; one root's children may be lazy. */
+    void populate(TreeModel& model, int lazyRoot = -1, int rootCount = RootCount)
+    {
+        for(int row = 0;row < rootCount;row++) {
+            model.appendTree(_rootUuids.at(row), _childUuids.at(row), row == lazyRoot);
+        }
+    }
+
+    static void setUpView(TreeViewBase& view, QAbstractItemModel* model)
+    {
+        view.setModel(model);
+        view.setSelectionMode(QAbstractItemView::ExtendedSelection);
+        view.resize(400, 300);
+    }
+
+    static QModelIndex childIndex(const TreeViewBase& view, int root, int child)
+    {
+        return view.model()->index(child, 0, view.model()->index(root, 0));
+    }
+
+    static QSet<QUuid> toSet(const QList<QUuid>& uuids) { return QSet<QUuid>(uuids.begin(), uuids.end()); }
+
+    /** Save a state with the given roots expanded and one child of the first selected and current. */
+    QByteArray savedState(const QList<int>& expandedRoots, int child)
+    {
+        TreeModel model;
+        populate(model);
+        TreeViewBase view;
+        setUpView(view, &model);
+        for(int root : expandedRoots) {
+            view.expand(view.model()->index(root, 0));
+        }
+        QModelIndex index = childIndex(view, expandedRoots.first(), child);
+        view.selectionModel()->select(index, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+        view.selectionModel()->setCurrentIndex(index, QItemSelectionModel::NoUpdate);
+        return view.saveState();
+    }
+
+private slots:
+    void initTestCase()
+    {
+        for(int row = 0;row < RootCount;row++) {
+            _rootUuids.append(QUuid::createUuid());
+            QList<QUuid> children;
+            for(int i = 0;i < ChildCount;i++) {
+                children.append(QUuid::createUuid());
+            }
+            _childUuids.append(children);
+        }
+    }
+
+    void saveState_roundTripsExpansionSelectionAndCurrent()
+    {
+        TreeModel model;
+        populate(model);
+        TreeViewBase view;
+        setUpView(view, &model);
+
+        view.expand(view.model()->index(1, 0));
+        view.expand(view.model()->index(3, 0));
+        QItemSelection selection(childIndex(view, 1, 1), childIndex(view, 1, 2));
+        view.selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+        view.selectionModel()->setCurrentIndex(childIndex(view, 1, 2), QItemSelectionModel::NoUpdate);
+
+        QByteArray state = view.saveState();
+        QVERIFY(state.startsWith("KTVS"));
+        QCOMPARE(int(state.at(5)), 0);
+
+        TreeViewBase restored;
+        setUpView(restored, &model);
+        restored.restoreState(state);
+        QCOMPARE(restored.expandedUuids(), QSet<QUuid>({ _rootUuids.at(1), _rootUuids.at(3) }));
+        QCOMPARE(toSet(restored.selectedUuids()), QSet<QUuid>({ _childUuids.at(1).at(1), _childUuids.at(1).at(2) }));
+        QCOMPARE(restored.currentIndex().data(KANOOP::UUidRole).toUuid(), _childUuids.at(1).at(2));
+    }
+
+    void saveState_compressesLargeStates()
+    {
+        TreeModel model;
+        populate(model);
+        TreeViewBase view;
+        setUpView(view, &model);
+        view.expandAll();
+
+        QByteArray compressed = view.saveState();
+        QByteArray uncompressed = view.saveState(false);
+        QCOMPARE(int(compressed.at(5)), 1);
+        QCOMPARE(int(uncompressed.at(5)), 0);
+
+        // Expanded UUIDs are stored as raw 16-byte values
+        QVERIFY(uncompressed.size() >= RootCount * 16);
+        QVERIFY(uncompressed.size() < RootCount * 16 + 64);
+
+        for(const QByteArray& state : { compressed, uncompressed }) {
+            TreeViewBase restored;
+            setUpView(restored, &model);
+            restored.restoreState(state);
+            QCOMPARE(restored.expandedUuids(), toSet(_rootUuids));
+        }
+    }
+
+    void restoreState_readsLegacyUuidList()
+    {
+        TreeModel model;
+        populate(model);
+        TreeViewBase view;
+        setUpView(view, &model);
+
+        // Before the binary format the state was the list of expanded UUIDs as a string
+        QByteArray legacy = StringUtil::toString(QList<QUuid>({ _rootUuids.at(0), _rootUuids.at(5) })).toUtf8();
+        view.restoreState(legacy);
+        QCOMPARE(view.expandedUuids(), QSet<QUuid>({ _rootUuids.at(0), _rootUuids.at(5) }));
+    }
+
+    void restoreState_ignoresCorruptState()
+    {
+        TreeModel model;
+        populate(model);
+        TreeViewBase view;
+        setUpView(view, &model);
+        view.expand(view.model()->index(2, 0));
+
+        QByteArray state = view.saveState(false);
+        view.restoreState(state.left(state.size() - 8));
+        QByteArray huge = state.left(6);
+        huge.append(QByteArray::fromHex("7fffffff"));
+        view.restoreState(huge);
+        QCOMPARE(view.expandedUuids(), QSet<QUuid>({ _rootUuids.at(2) }));
+    }
+
+    void selectionModel_keepsSelectionUnderOneParent()
+    {
+        TreeModel model;
+        populate(model, -1, 4);
+        TreeSelectionModel selectionModel(&model);
+        QModelIndex first = model.index(0, 0);
+        QModelIndex second = model.index(1, 0);
+
+        selectionModel.select(model.index(0, 0, first), QItemSelectionModel::Select);
+        selectionModel.select(model.index(1, 0, first), QItemSelectionModel::Select);
+        QCOMPARE(selectionModel.selectedIndexes().count(), 2);
+        QCOMPARE(selectionModel.selectionParent(), first);
+
+        // An item under another parent replaces the selection
+        selectionModel.select(model.index(2, 0, second), QItemSelectionModel::Select);
+        QCOMPARE(selectionModel.selectedIndexes(), QModelIndexList({ model.index(2, 0, second) }));
+        QCOMPARE(selectionModel.selectionParent(), second);
+
+        // Ranges sharing a parent are selected together
+        QItemSelection sameParent(model.index(0, 0, first), model.index(0, 0, first));
+        sameParent.select(model.index(2, 0, first), model.index(2, 0, first));
+        selectionModel.select(sameParent, QItemSelectionModel::ClearAndSelect);
+        QCOMPARE(selectionModel.selectedIndexes().count(), 2);
+        QCOMPARE(selectionModel.selectionParent(), first);
+
+        // Ranges under different parents are rejected and clear the selection
+        QItemSelection mixed(model.index(0, 0, first), model.index(1, 0, first));
+        mixed.select(model.index(0, 0, second), model.index(0, 0, second));
+        selectionModel.select(mixed, QItemSelectionModel::Select);
+        QVERIFY(selectionModel.hasSelection() == false);
+        QVERIFY(selectionModel.selectionParent().isValid() == false);
+    }
+
+    void selectionModel_selectionParentFollowsDeselect()
+    {
+        TreeModel model;
+        populate(model, -1, 4);
+        TreeSelectionModel selectionModel(&model);
+        QModelIndex parent = model.index(3, 0);
+
+        selectionModel.select(QItemSelection(model.index(0, 0, parent), model.index(2, 0, parent)), QItemSelectionModel::ClearAndSelect);
+        QCOMPARE(selectionModel.selectionParent(), parent);
+
+        selectionModel.select(QItemSelection(model.index(0, 0, parent), model.index(2, 0, parent)), QItemSelectionModel::Deselect);
+        QVERIFY(selectionModel.selectionParent().isValid() == false);
+
+        // Root items have the invisible root as their parent
+        selectionModel.select(model.index(1, 0), QItemSelectionModel::Select);
+        QCOMPARE(selectionModel.selectionParent(), QModelIndex());
+        QVERIFY(selectionModel.hasSelection());
+    }
+
+    void selectedItems_resolvedThroughProxyAndCached()
+    {
+        TreeModel model;
+        populate(model, -1, 4);
+        QSortFilterProxyModel proxy;
+        proxy.setSourceModel(&model);
+        proxy.sort(0, Qt::DescendingOrder);
+        TreeViewBase view;
+        setUpView(view, &proxy);
+
+        // Proxy rows resolve to the items behind the source rows
+        QModelIndex root = proxy.mapFromSource(model.index(1, 0));
+        QModelIndex leaf = proxy.mapFromSource(model.index(2, 0, model.index(0, 0)));
+        view.selectionModel()->select(root, QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+        view.selectionModel()->select(leaf, QItemSelectionModel::Select | QItemSelectionModel::Rows);
+        QCOMPARE(toSet(view.selectedUuids()), QSet<QUuid>({ _rootUuids.at(1), _childUuids.at(0).at(2) }));
+        QCOMPARE(view.selectedItems<TreeItem>().count(), 2);
+        QList<LeafItem*> leaves = view.selectedItems<LeafItem>();
+        QCOMPARE(leaves.count(), 1);
+        QCOMPARE(leaves.first()->uuid(), _childUuids.at(0).at(2));
+
+        // Repeated calls share the cached list until the selection changes
+        AbstractModelItem::List first = view.selectedModelItems();
+        AbstractModelItem::List second = view.selectedModelItems();
+        QVERIFY(first.constData() == second.constData());
+
+        view.selectionModel()->select(leaf, QItemSelectionModel::Deselect | QItemSelectionModel::Rows);
+        AbstractModelItem::List third = view.selectedModelItems();
+        QVERIFY(third.constData() != first.constData());
+        QCOMPARE(third.count(), 1);
+        QCOMPARE(view.selectedUuids(), QList<QUuid>({ _rootUuids.at(1) }));
+
+        // A model reset drops the cached items
+        model.clear();
+        QVERIFY(view.selectedModelItems().isEmpty());
+        QVERIFY(view.selectedUuids().isEmpty());
+    }
+
+    void restoreStateIncrementally_appliesRowsAsTheyArrive()
+    {
+        QByteArray state = savedState({ 60, 2 }, 1);
+        TreeModel model;
+        TreeViewBase view;
+        setUpView(view, &model);
+        QSignalSpy finished(&view, &TreeViewBase::stateRestoreFinished);
+
+        // The model is still empty when the restore starts
+        view.restoreStateIncrementally(state);
+        QVERIFY(view.isRestorePending());
+        populate(model);
+
+        QTRY_COMPARE(finished.count(), 1);
+        QCOMPARE(finished.first().at(0).toBool(), true);
+        QVERIFY(view.isRestorePending() == false);
+        QCOMPARE(view.expandedUuids(), QSet<QUuid>({ _rootUuids.at(60), _rootUuids.at(2) }));
+        QCOMPARE(view.selectedUuids(), QList<QUuid>({ _childUuids.at(60).at(1) }));
+        QCOMPARE(view.currentIndex().data(KANOOP::UUidRole).toUuid(), _childUuids.at(60).at(1));
+    }
+
+    void restoreStateIncrementally_waitsForLazilyFetchedChildren()
+    {
+        QByteArray state = savedState({ 5 }, 2);
+        TreeModel model;
+        populate(model, 5);
+        TreeViewBase view;
+        setUpView(view, &model);
+        view.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&view));
+        QSignalSpy finished(&view, &TreeViewBase::stateRestoreFinished);
+
+        // Expanding the saved item starts a fetch; its children arrive FetchDelay later
+        view.restoreStateIncrementally(state);
+        QTRY_COMPARE(finished.count(), 1);
+        QCOMPARE(finished.first().at(0).toBool(), true);
+        QCOMPARE(model.rowCount(model.index(5, 0)), int(ChildCount));
+        QCOMPARE(view.selectedUuids(), QList<QUuid>({ _childUuids.at(5).at(2) }));
+        QCOMPARE(view.currentIndex().data(KANOOP::UUidRole).toUuid(), _childUuids.at(5).at(2));
+    }
+
+    void restoreStateIncrementally_restartsAfterModelReset()
+    {
+        QByteArray state = savedState({ 7 }, 0);
+        TreeModel model;
+        populate(model, -1, 3);
+        TreeViewBase view;
+        setUpView(view, &model);
+        QSignalSpy finished(&view, &TreeViewBase::stateRestoreFinished);
+
+        view.restoreStateIncrementally(state);
+        model.clear();
+        populate(model);
+
+        QTRY_COMPARE(finished.count(), 1);
+        QCOMPARE(finished.first().at(0).toBool(), true);
+        QCOMPARE(view.expandedUuids(), QSet<QUuid>({ _rootUuids.at(7) }));
+        QCOMPARE(view.selectedUuids(), QList<QUuid>({ _childUuids.at(7).at(0) }));
+    }
+
+    void restoreStateIncrementally_finishesWhenItemsAreGone()
+    {
+        QByteArray state = savedState({ 1, 50 }, 0);
+        TreeModel model;
+        populate(model, -1, 10);
+        TreeViewBase view;
+        setUpView(view, &model);
+        QSignalSpy finished(&view, &TreeViewBase::stateRestoreFinished);
+
+        // Root 50 no longer exists; what is present is still restored
+        view.restoreStateIncrementally(state);
+        QTRY_COMPARE(finished.count(), 1);
+        QCOMPARE(finished.first().at(0).toBool(), false);
+        QCOMPARE(view.expandedUuids(), QSet<QUuid>({ _rootUuids.at(1) }));
+        QCOMPARE(view.selectedUuids(), QList<QUuid>({ _childUuids.at(1).at(0) }));
+    }
+
+    void cancelPendingRestore_reportsIncomplete()
+    {
+        TreeModel model;
+        TreeViewBase view;
+        setUpView(view, &model);
+        QSignalSpy finished(&view, &TreeViewBase::stateRestoreFinished);
+
+        view.restoreStateIncrementally(savedState({ 3 }, 0));
+        view.cancelPendingRestore();
+        QCOMPARE(finished.count(), 1);
+        QCOMPARE(finished.first().at(0).toBool(), false);
+
+        // Rows arriving afterwards are left alone
+        populate(model);
+        QTest::qWait(20);
+        QVERIFY(view.expandedUuids().isEmpty());
+    }
+};
+
+QTEST_MAIN(TstTreeViewBase)
+#include "tst_treeviewbase.moc"
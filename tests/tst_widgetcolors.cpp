@@ -0,0 +1,159 @@
+#include <QTest>
+#include <QApplication>
+#include <QImage>
+#include <Kanoop/gui/widgets/label.h>
+#include <Kanoop/gui/utility/widgetcolors.h>
+
+class TstWidgetColors : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int LabelCount = 5000;
+
+    void toggleColors(QList<Label*>& labels, int& iteration)
+    {
+        QColor color = (iteration++ % 2) == 0 ? QColor(Qt::red) : QColor(Qt::darkGreen);
+        for(Label* label : labels) {
+            label->setForegroundColor(color);
+        }
+    }
+
+    /** Render the widget and return whether any pixel has exactly the given color. */
+    static bool rendersColor(QWidget* widget, const QColor& color)
+    {
+        QImage image = widget->grab().toImage().convertToFormat(QImage::Format_RGB32);
+        for(int y = 0;y < image.height();y++) {
+            for(int x = 0;x < image.width();x++) {
+                if(image.pixelColor(x, y) == color) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /** Return the color rendered in the widget's top left corner, outside the text. */
+    static QColor renderedBackground(QWidget* widget)
+    {
+        return widget->grab().toImage().pixelColor(1, 1);
+    }
+
+    static Label* makeLabel(QWidget* parent = nullptr)
+    {
+        Label* label = new Label(QStringLiteral("MMMM"), parent);
+        QFont font = label->font();
+        font.setPixelSize(40);
+        font.setBold(true);
+        label->setFont(font);
+        label->setAlignment(Qt::AlignCenter);
+        label->resize(240, 80);
+        return label;
+    }
+
+private slots:
+    void label_paletteMode_setsPaletteNotStyleSheet()
+    {
+        QScopedPointer<Label> label(makeLabel());
+        label->setForegroundColor(Qt::red);
+        label->setBackgroundColor(Qt::blue);
+        QVERIFY(label->styleSheet().isEmpty());
+        QCOMPARE(renderedBackground(label.data()), QColor(Qt::blue));
+        QVERIFY(rendersColor(label.data(), Qt::red));
+    }
+
+    void label_defaultColor_restoresApplicationPalette()
+    {
+        Label label;
+        label.setForegroundColor(Qt::red);
+        label.setDefaultForegroundColor();
+        QCOMPARE(label.palette().color(QPalette::WindowText), QApplication::palette(&label).color(QPalette::WindowText));
+    }
+
+    void label_unrelatedStyleSheets_keepPalette()
+    {
+        QWidget parent;
+        parent.setStyleSheet("QWidget { font-weight: bold }");
+        Label* label = makeLabel(&parent);
+        label->setForegroundColor(Qt::red);
+        label->setBackgroundColor(Qt::blue);
+        QVERIFY(label->styleSheet().isEmpty());
+        QCOMPARE(renderedBackground(label), QColor(Qt::blue));
+        QVERIFY(rendersColor(label, Qt::red));
+    }
+
+    void label_ancestorColorStyleSheet_fallsBackToStyleSheet()
+    {
+        // A palette would be overridden by these rules, so the label must use a sheet
+        QWidget parent;
+        parent.setStyleSheet("QLabel { color: green; background-color: yellow }");
+        Label* label = makeLabel(&parent);
+        label->setForegroundColor(Qt::red);
+        label->setBackgroundColor(Qt::blue);
+        QVERIFY(label->styleSheet().contains("color"));
+        QCOMPARE(renderedBackground(label), QColor(Qt::blue));
+        QVERIFY(rendersColor(label, Qt::red));
+    }
+
+    void label_applicationColorStyleSheet_fallsBackToStyleSheet()
+    {
+        qApp->setStyleSheet("QLabel { background-color: yellow }");
+        QScopedPointer<Label> label(makeLabel());
+        label->setBackgroundColor(Qt::blue);
+        QColor rendered = renderedBackground(label.data());
+        bool fellBack = label->styleSheet().isEmpty() == false;
+        qApp->setStyleSheet(QString());
+        QVERIFY(fellBack);
+        QCOMPARE(rendered, QColor(Qt::blue));
+    }
+
+    void label_fallbackStyleSheet_droppedOnReturnToPalette()
+    {
+        Label label;
+        WidgetColors::setPaletteModeEnabled(false);
+        label.setForegroundColor(Qt::red);
+        QVERIFY(label.styleSheet().contains("color"));
+
+        WidgetColors::setPaletteModeEnabled(true);
+        label.setForegroundColor(Qt::blue);
+        QVERIFY(label.styleSheet().isEmpty());
+        QCOMPARE(label.palette().color(QPalette::WindowText), QColor(Qt::blue));
+
+        // A sheet set by the application is not ours to remove
+        label.setStyleSheet("QLabel { border: 1px solid black }");
+        label.setForegroundColor(Qt::green);
+        QCOMPARE(label.styleSheet(), QStringLiteral("QLabel { border: 1px solid black }"));
+    }
+
+    void benchmark_toggle5000Labels_palette()
+    {
+        WidgetColors::setPaletteModeEnabled(true);
+        QWidget parent;
+        QList<Label*> labels;
+        for(int i = 0;i < LabelCount;i++) {
+            labels.append(new Label(QString::number(i), &parent));
+        }
+        int iteration = 0;
+        QBENCHMARK {
+            toggleColors(labels, iteration);
+        }
+    }
+
+    void benchmark_toggle5000Labels_styleSheet()
+    {
+        WidgetColors::setPaletteModeEnabled(false);
+        QWidget parent;
+        QList<Label*> labels;
+        for(int i = 0;i < LabelCount;i++) {
+            labels.append(new Label(QString::number(i), &parent));
+        }
+        int iteration = 0;
+        QBENCHMARK {
+            toggleColors(labels, iteration);
+        }
+        WidgetColors::setPaletteModeEnabled(true);
+    }
+};
+
+QTEST_MAIN(TstWidgetColors)
+#include "tst_widgetcolors.moc"